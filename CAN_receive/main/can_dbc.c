@@ -0,0 +1,295 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include "can_dbc.h"
+
+#define LINE_MAX_LEN 512
+
+bool can_dbc_init(can_dbc_t *db, int max_messages, int max_signals) {
+    memset(db, 0, sizeof(*db));
+    if (max_messages <= 0 || max_messages >= UINT16_MAX || max_signals < 0 || max_signals > UINT16_MAX) return false;
+
+    db->messages = calloc(max_messages, sizeof(can_dbc_message_t));
+    db->signals = calloc(max_signals > 0 ? max_signals : 1, sizeof(can_dbc_signal_t));
+    if (db->messages == NULL || db->signals == NULL) {
+        can_dbc_free(db);
+        return false;
+    }
+    db->max_messages = max_messages;
+    db->max_signals = max_signals;
+    return true;
+}
+
+void can_dbc_free(can_dbc_t *db) {
+    free(db->messages);
+    free(db->signals);
+    free(db->index);
+    memset(db, 0, sizeof(*db));
+}
+
+static void copy_name(char *dst, size_t size, const char *src) {
+    size_t n = strlen(src);
+    if (n >= size) n = size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+int can_dbc_add_message(can_dbc_t *db, uint32_t id, bool extd, const char *name, uint8_t dlc) {
+    if (db->num_messages >= db->max_messages || id > (extd ? 0x1FFFFFFFu : 0x7FFu)) {
+        db->skipped++;
+        return -1;
+    }
+    can_dbc_message_t *m = &db->messages[db->num_messages];
+    copy_name(m->name, sizeof(m->name), name);
+    m->id = id;
+    m->extd = extd;
+    m->dlc = dlc > 8 ? 8 : dlc;
+    m->first_signal = (uint16_t)db->num_signals;
+    m->num_signals = 0;
+    return db->num_messages++;
+}
+
+// 화면 출력용 소수점 자리: 배율이 1 보다 작아지는 자리 수 (0.1 -> 1, 0.01 -> 2, 1/16384 -> 3)
+static uint8_t scale_decimals(float scale) {
+    float s = scale < 0 ? -scale : scale;
+    uint8_t d = 0;
+    while (d < 3 && s > 0 && s < 0.999f) {
+        s *= 10;
+        d++;
+    }
+    return d;
+}
+
+bool can_dbc_add_signal(can_dbc_t *db, const char *name, int start, int length, bool big_endian,
+                        bool is_signed, float scale, float offset, const char *unit) {
+    if (db->num_messages == 0 || db->num_signals >= db->max_signals || length < 1 || length > 64 ||
+        start < 0 || start > 63) {
+        db->skipped++;
+        return false;
+    }
+    can_dbc_message_t *m = &db->messages[db->num_messages - 1];
+    if (m->num_signals >= CAN_DBC_MAX_MSG_SIGNALS) {
+        db->skipped++;
+        return false;
+    }
+
+    // 시프트 미리 계산. 리틀 엔디언 값: 비트 번호 그대로. 빅 엔디언 값(byte0 이 최상위):
+    // 모토로라 시작 비트(바이트 start/8 의 비트 start%8 = 가장 높은 비트)를 위에서부터 센 위치로 바꿈
+    int shift, last_byte;
+    if (big_endian) {
+        int msb_from_top = start / 8 * 8 + (7 - start % 8);
+        int lsb_from_top = msb_from_top + length - 1;
+        if (lsb_from_top > 63) {
+            db->skipped++;
+            return false;
+        }
+        shift = 63 - lsb_from_top;
+        last_byte = lsb_from_top / 8;
+    } else {
+        if (start + length > 64) {
+            db->skipped++;
+            return false;
+        }
+        shift = start;
+        last_byte = (start + length - 1) / 8;
+    }
+
+    can_dbc_signal_t *s = &db->signals[db->num_signals++];
+    copy_name(s->name, sizeof(s->name), name);
+    copy_name(s->unit, sizeof(s->unit), unit != NULL ? unit : "");
+    s->scale = scale;
+    s->offset = offset;
+    s->mask = length == 64 ? UINT64_MAX : ((uint64_t)1 << length) - 1;
+    s->shift = (uint8_t)shift;
+    s->sign_shift = (uint8_t)(64 - length);
+    s->min_dlc = (uint8_t)(last_byte + 1);
+    s->flags = (big_endian ? CAN_DBC_BIG_ENDIAN : 0) | (is_signed ? CAN_DBC_SIGNED : 0);
+    s->decimals = scale_decimals(scale);
+    m->num_signals++;
+    return true;
+}
+
+int can_dbc_load_table(can_dbc_t *db, const can_dbc_def_t *defs, int n) {
+    int added = 0;
+    for (int i = 0; i < n; i++) {
+        const can_dbc_def_t *d = &defs[i];
+        // 앞 줄과 ID 가 다르면 새 메시지
+        if (i == 0 || d->id != defs[i - 1].id || d->extd != defs[i - 1].extd) {
+            if (can_dbc_add_message(db, d->id, d->extd, d->message, d->dlc) < 0) {
+                while (i + 1 < n && defs[i + 1].id == d->id && defs[i + 1].extd == d->extd) i++; // 신호도 버림
+                continue;
+            }
+        }
+        if (d->signal != NULL &&
+            can_dbc_add_signal(db, d->signal, d->start, d->length, d->big_endian, d->is_signed, d->scale,
+                               d->offset, d->unit)) {
+            added++;
+        }
+    }
+    return added;
+}
+
+// --- [.dbc 파일 읽기] ---
+static const char *skip_ws(const char *p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+// 공백/':' 까지 한 단어. 단어 뒤 위치
+static const char *read_token(const char *p, char *out, size_t size) {
+    size_t n = 0;
+    p = skip_ws(p);
+    while (*p != '\0' && !isspace((unsigned char)*p) && *p != ':') {
+        if (n + 1 < size) out[n++] = *p;
+        p++;
+    }
+    out[n] = '\0';
+    return p;
+}
+
+// BO_ 1234 NAME: 8 NODE. 추가했으면 1, 가짜 메시지라 무시했으면 0, 잘못된 줄이면 -1
+static int parse_message(can_dbc_t *db, const char *p) {
+    char *end;
+    unsigned long raw = strtoul(p, &end, 10);
+    if (end == p) return -1;
+    char name[CAN_DBC_NAME_LEN];
+    p = read_token(end, name, sizeof(name));
+    if (*p != ':') return -1;
+    unsigned long dlc = strtoul(p + 1, &end, 10);
+    // DBC 는 확장 ID 에 0x80000000 을 더해서 적음. 0xC0000000 은 어느 메시지에도 없는 신호를 모아 두는
+    // 가짜 메시지 (VECTOR__INDEPENDENT_SIG_MSG)
+    if ((raw & 0xC0000000UL) == 0xC0000000UL) return 0;
+    if (raw & 0x60000000UL) return -1;
+    bool extd = (raw & 0x80000000UL) != 0;
+    return can_dbc_add_message(db, (uint32_t)(raw & 0x1FFFFFFFUL), extd, name, (uint8_t)(dlc > 8 ? 8 : dlc)) >= 0 ? 1 : -1;
+}
+
+// SG_ NAME [M|mN] : START|LEN@ORDER SIGN (SCALE,OFFSET) [MIN|MAX] "UNIT" NODES
+// 멀티플렉스 신호(mN)는 어떤 값일 때 들어 있는지 따로 따져야 하므로 건너뜀 (false)
+static bool parse_signal(can_dbc_t *db, const char *p) {
+    char name[CAN_DBC_NAME_LEN], mux[16];
+    p = read_token(p, name, sizeof(name));
+    p = skip_ws(p);
+    if (*p != ':') {
+        p = read_token(p, mux, sizeof(mux));
+        if (mux[0] == 'm' && isdigit((unsigned char)mux[1])) return false;
+        p = skip_ws(p);
+        if (*p != ':') return false;
+    }
+
+    int start, length;
+    char order, sign;
+    float scale, offset;
+    if (sscanf(p + 1, " %d|%d@%c%c (%f,%f)", &start, &length, &order, &sign, &scale, &offset) != 6) return false;
+    if ((order != '0' && order != '1') || (sign != '+' && sign != '-')) return false;
+
+    // 단위: ')' 뒤 첫 번째 "..."
+    char unit[CAN_DBC_UNIT_LEN] = "";
+    const char *q = strchr(p, ')');
+    if (q != NULL) q = strchr(q, '"');
+    if (q != NULL) {
+        const char *e = strchr(q + 1, '"');
+        size_t n = e != NULL ? (size_t)(e - q - 1) : 0;
+        if (n >= sizeof(unit)) n = sizeof(unit) - 1;
+        memcpy(unit, q + 1, n);
+        unit[n] = '\0';
+    }
+    return can_dbc_add_signal(db, name, start, length, order == '0', sign == '-', scale, offset, unit);
+}
+
+int can_dbc_load_file(can_dbc_t *db, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return -1;
+
+    char line[LINE_MAX_LEN];
+    int added = 0;
+    bool in_message = false; // 마지막 BO_ 를 추가했음 (실패했으면 그 신호도 버림)
+    while (fgets(line, sizeof(line), f)) {
+        const char *p = skip_ws(line);
+        if (strncmp(p, "BO_ ", 4) == 0) {
+            uint32_t skipped = db->skipped;
+            int r = parse_message(db, p + 4);
+            in_message = r > 0;
+            if (r < 0 && db->skipped == skipped) db->skipped++;
+        } else if (strncmp(p, "SG_ ", 4) == 0) {
+            if (!in_message) continue;
+            uint32_t skipped = db->skipped;
+            if (parse_signal(db, p + 4)) added++;
+            else if (db->skipped == skipped) db->skipped++; // 문법 오류/멀티플렉스 (공간 부족은 add 에서 셈)
+        }
+    }
+    fclose(f);
+    return added;
+}
+
+// --- [ID 색인] ---
+static uint32_t hash_id(uint32_t id, bool extd) {
+    uint32_t h = (id | (extd ? 0x80000000u : 0)) * 0x9E3779B1u;
+    return h ^ (h >> 16);
+}
+
+bool can_dbc_build(can_dbc_t *db) {
+    uint32_t size = 16;
+    while (size < (uint32_t)db->num_messages * 2) size <<= 1;
+    free(db->index);
+    db->index = calloc(size, sizeof(uint16_t));
+    if (db->index == NULL) return false;
+    db->index_mask = size - 1;
+
+    for (int i = 0; i < db->num_messages; i++) {
+        const can_dbc_message_t *m = &db->messages[i];
+        uint32_t pos = hash_id(m->id, m->extd) & db->index_mask;
+        bool dup = false;
+        while (db->index[pos] != 0) {
+            const can_dbc_message_t *o = &db->messages[db->index[pos] - 1];
+            if (o->id == m->id && o->extd == m->extd) {
+                dup = true; // 같은 ID 가 두 번: 먼저 것을 씀
+                break;
+            }
+            pos = (pos + 1) & db->index_mask;
+        }
+        if (dup) db->skipped++;
+        else db->index[pos] = (uint16_t)(i + 1);
+    }
+    return true;
+}
+
+const can_dbc_message_t *can_dbc_find(const can_dbc_t *db, uint32_t id, bool extd) {
+    if (db->index == NULL) return NULL;
+    uint32_t pos = hash_id(id, extd) & db->index_mask;
+    // 표가 절반 이상 비어 있으므로 몇 칸 안에 끝남
+    while (db->index[pos] != 0) {
+        const can_dbc_message_t *m = &db->messages[db->index[pos] - 1];
+        if (m->id == id && m->extd == extd) return m;
+        pos = (pos + 1) & db->index_mask;
+    }
+    return NULL;
+}
+
+// --- [해석] ---
+int can_dbc_decode(const can_dbc_t *db, const can_dbc_message_t *m, const uint8_t *data, uint8_t dlc,
+                   float *values) {
+    if (dlc > 8) dlc = 8;
+    // 8 바이트를 두 가지 순서로 한 번씩만 읽음 (ESP32/PC 모두 리틀 엔디언)
+    uint8_t bytes[8] = { 0 };
+    memcpy(bytes, data, dlc);
+    uint64_t le, be;
+    memcpy(&le, bytes, sizeof(le));
+    be = __builtin_bswap64(le);
+
+    const can_dbc_signal_t *s = &db->signals[m->first_signal];
+    int decoded = 0;
+    for (int i = 0; i < m->num_signals; i++, s++) {
+        if (dlc < s->min_dlc) {
+            values[i] = NAN;
+            continue;
+        }
+        uint64_t v = ((s->flags & CAN_DBC_BIG_ENDIAN) ? be : le) >> s->shift & s->mask;
+        int64_t raw = (s->flags & CAN_DBC_SIGNED) ? (int64_t)(v << s->sign_shift) >> s->sign_shift : (int64_t)v;
+        values[i] = (float)raw * s->scale + s->offset;
+        decoded++;
+    }
+    return decoded;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- [CAN 신호 해석 (DBC 방식 표)] ---
+// ID 별 switch 문에 비트 꺼내기/배율을 직접 쓰는 대신, 신호 목록(ID, 시작 비트, 길이, 바이트 순서,
+// 배율, 오프셋, 이름, 단위)을 표로 두고 같은 코드로 해석합니다. ID 가 수백 개여도 코드는 그대로.
+//  - 표는 코드에 상수 배열로 넣거나 (can_dbc_load_table), SD 카드의 .dbc 파일에서 읽음 (can_dbc_load_file)
+//  - ID 찾기: 해시 표 (열린 주소법, 메시지 수의 2배 이상 크기) 한 번 -> O(1)
+//  - 신호 꺼내기: 추가할 때 바이트 순서에 맞는 시프트/마스크/부호 비트를 미리 계산해 둠.
+//    프레임마다 8바이트를 리틀/빅 엔디언 64비트 값으로 한 번씩 읽고, 신호마다 시프트 + AND + 곱셈만
+// 시작 비트는 DBC 규칙 그대로: 인텔(@1)은 가장 낮은 비트, 모토로라(@0)는 가장 높은 비트 (바이트 안 7..0 번호).
+// .dbc 파일은 BO_ / SG_ 줄만 읽음 (멀티플렉스 신호 m0.. 는 건너뜀, 나머지 줄은 무시).
+// ESP-IDF 의존성 없음 (PC 의 tools/can_dbc_bench 가 같은 코드로 측정)
+
+#define CAN_DBC_NAME_LEN        24
+#define CAN_DBC_UNIT_LEN        8
+#define CAN_DBC_MAX_MSG_SIGNALS 64  // 메시지 하나의 신호 수 상한 (8 바이트 = 1비트 신호 64개)
+
+// 신호 flags
+#define CAN_DBC_BIG_ENDIAN      0x01    // 모토로라 (@0)
+#define CAN_DBC_SIGNED          0x02    // 2의 보수 (-)
+
+typedef struct {
+    char name[CAN_DBC_NAME_LEN];
+    char unit[CAN_DBC_UNIT_LEN];
+    float scale;
+    float offset;
+    uint64_t mask;          // (1 << length) - 1
+    uint8_t shift;          // 바이트 순서에 맞춘 64비트 값에서 오른쪽으로 밀 양
+    uint8_t sign_shift;     // 부호 확장용 (64 - length)
+    uint8_t min_dlc;        // 이 신호를 담으려면 필요한 바이트 수
+    uint8_t flags;
+    uint8_t decimals;       // 화면 출력용 소수점 자리 (배율에서 정함, 최대 3)
+} can_dbc_signal_t;
+
+typedef struct {
+    char name[CAN_DBC_NAME_LEN];
+    uint32_t id;
+    bool extd;
+    uint8_t dlc;
+    uint16_t first_signal;  // signals[] 안의 시작 위치
+    uint16_t num_signals;   // 0 이면 신호 없는 이벤트 메시지 (예: 버튼)
+} can_dbc_message_t;
+
+typedef struct {
+    can_dbc_message_t *messages;
+    int num_messages, max_messages;
+    can_dbc_signal_t *signals;
+    int num_signals, max_signals;
+
+    // ID 색인 (can_dbc_build 가 만듦): 메시지 번호 + 1 (0 = 빈 칸)
+    uint16_t *index;
+    uint32_t index_mask;    // 표 크기 - 1 (2의 거듭제곱)
+
+    uint32_t skipped;       // 읽지 못했거나 공간이 없어 버린 신호/메시지 수
+} can_dbc_t;
+
+// 코드에 넣는 표의 한 줄. 같은 ID 의 신호는 연달아 적음 (signal == NULL 이면 신호 없는 메시지)
+typedef struct {
+    uint32_t id;
+    bool extd;
+    const char *message;
+    uint8_t dlc;
+    const char *signal;
+    uint8_t start;          // DBC 시작 비트
+    uint8_t length;
+    bool big_endian;
+    bool is_signed;
+    float scale;
+    float offset;
+    const char *unit;
+} can_dbc_def_t;
+
+// 최대 메시지 수 / 신호 총수를 정해서 메모리를 한 번에 할당. 실패하면 false
+bool can_dbc_init(can_dbc_t *db, int max_messages, int max_signals);
+void can_dbc_free(can_dbc_t *db);
+
+// 메시지 추가 (이후 추가하는 신호는 이 메시지에 붙음). 성공하면 메시지 번호, 실패하면 -1
+int can_dbc_add_message(can_dbc_t *db, uint32_t id, bool extd, const char *name, uint8_t dlc);
+
+// 마지막 메시지에 신호 추가. 8 바이트를 벗어나거나 공간이 없으면 false
+bool can_dbc_add_signal(can_dbc_t *db, const char *name, int start, int length, bool big_endian,
+                        bool is_signed, float scale, float offset, const char *unit);
+
+// 상수 표 / .dbc 파일에서 추가. 추가한 신호 수 (파일을 못 열면 -1)
+int can_dbc_load_table(can_dbc_t *db, const can_dbc_def_t *defs, int n);
+int can_dbc_load_file(can_dbc_t *db, const char *path);
+
+// ID 색인 만들기 (다 추가한 뒤 한 번). 메모리 부족이면 false
+bool can_dbc_build(can_dbc_t *db);
+
+// ID -> 메시지 (없으면 NULL)
+const can_dbc_message_t *can_dbc_find(const can_dbc_t *db, uint32_t id, bool extd);
+
+// 메시지의 신호를 모두 해석해서 values[i] = signals[m->first_signal + i] 의 물리값.
+// dlc 가 짧아 담기지 않은 신호는 NAN. 해석한 신호 수
+int can_dbc_decode(const can_dbc_t *db, const can_dbc_message_t *m, const uint8_t *data, uint8_t dlc,
+                   float *values);
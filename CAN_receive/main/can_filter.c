@@ -0,0 +1,254 @@
+#include "can_filter.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define STD_ID_MASK     0x7FFu
+#define EXT_ID_MASK     0x1FFFFFFFu
+#define EXT_DUAL_LOW    0x1FFFu     // 확장 ID dual: ID 아래 13비트는 비교하지 않음
+
+// ID 블록: mask 비트가 1 인 자리는 아무 값이나 (code 의 그 자리는 0)
+typedef struct {
+    uint32_t code, mask;
+} block_t;
+
+static uint64_t block_size(block_t b) {
+    return (uint64_t)1 << __builtin_popcount(b.mask);
+}
+
+// 두 블록을 모두 덮는 가장 작은 블록 (다른 비트는 상관없음으로)
+static block_t block_span(block_t a, block_t b) {
+    block_t s;
+    s.mask = a.mask | b.mask | (a.code ^ b.code);
+    s.code = a.code & ~s.mask;
+    return s;
+}
+
+static bool block_inside(block_t in, block_t out) {
+    return (in.mask & ~out.mask) == 0 && ((in.code ^ out.code) & ~out.mask) == 0;
+}
+
+// |A ∪ B| (두 블록이 겹치면 겹친 부분도 블록)
+static uint64_t union_size(block_t a, block_t b) {
+    uint64_t both = 0;
+    if (((a.code ^ b.code) & ~(a.mask | b.mask)) == 0) both = (uint64_t)1 << __builtin_popcount(a.mask & b.mask);
+    return block_size(a) + block_size(b) - both;
+}
+
+// --- [목록 읽기] ---
+int can_filter_parse(const char *list, bool extd, can_filter_range_t *out, int max) {
+    uint32_t id_max = extd ? EXT_ID_MASK : STD_ID_MASK;
+    int n = 0;
+    const char *p = list;
+    while (*p != '\0') {
+        while (isspace((unsigned char)*p) || *p == ',') p++;
+        if (*p == '\0') break;
+
+        char *end;
+        unsigned long lo = strtoul(p, &end, 0), hi = lo;
+        if (end == p) return -1;
+        p = end;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '-') {
+            p++;
+            hi = strtoul(p, &end, 0);
+            if (end == p) return -1;
+            p = end;
+            while (isspace((unsigned char)*p)) p++;
+        }
+        if (*p != ',' && *p != '\0') return -1;
+        if (lo > hi || hi > id_max || n >= max) return -1;
+        out[n].lo = (uint32_t)lo;
+        out[n].hi = (uint32_t)hi;
+        n++;
+    }
+    return n;
+}
+
+// --- [필터 계산] ---
+static int cmp_range(const void *a, const void *b) {
+    uint32_t x = ((const can_filter_range_t *)a)->lo, y = ((const can_filter_range_t *)b)->lo;
+    return x < y ? -1 : x > y;
+}
+
+// [lo, hi] 를 정렬된 2^k 블록으로 쪼갬. 넣은 개수 (max 를 넘으면 -1)
+static int split_range(uint32_t lo, uint32_t hi, block_t *out, int max) {
+    int n = 0;
+    uint64_t at = lo;
+    while (at <= hi) {
+        uint64_t size = at == 0 ? (uint64_t)1 << 32 : at & (~at + 1); // at 이 정렬된 가장 큰 크기
+        while (at + size - 1 > hi) size >>= 1;
+        if (n >= max) return -1;
+        out[n].code = (uint32_t)at;
+        out[n].mask = (uint32_t)(size - 1);
+        n++;
+        at += size;
+    }
+    return n;
+}
+
+// side[i] 대로 나눈 두 무리를 각각 덮는 블록의 합집합 크기 (한쪽이 비면 UINT64_MAX)
+static uint64_t split_size(const block_t *items, int n, const uint8_t *side, block_t *a, block_t *b) {
+    bool has[2] = { false, false };
+    block_t g[2];
+    for (int i = 0; i < n; i++) {
+        int k = side[i];
+        g[k] = has[k] ? block_span(g[k], items[i]) : items[i];
+        has[k] = true;
+    }
+    if (!has[0] || !has[1]) return UINT64_MAX;
+    *a = g[0];
+    *b = g[1];
+    return union_size(g[0], g[1]);
+}
+
+// 블록 cut 안에 드는 것은 0, 나머지는 1
+static void split_by(const block_t *items, int n, block_t cut, uint8_t *side) {
+    for (int i = 0; i < n; i++) side[i] = !block_inside(items[i], cut);
+}
+
+// 블록 두 개로 나눔: 합집합이 가장 작은 것. 나눌 수 없으면 false
+static bool plan_dual(const block_t *items, int n, uint32_t id_mask, block_t *best_a, block_t *best_b) {
+    uint8_t side[CAN_FILTER_MAX_BLOCKS], best_side[CAN_FILTER_MAX_BLOCKS];
+    uint64_t best = UINT64_MAX;
+    block_t a, b;
+    // 1. ID 두 무리가 만드는 블록마다: 그 안에 드는 것 / 나머지
+    for (int i = 0; i < n; i++) {
+        for (int j = i; j < n; j++) {
+            split_by(items, n, block_span(items[i], items[j]), side);
+            uint64_t size = split_size(items, n, side, &a, &b);
+            if (size < best) { best = size; memcpy(best_side, side, n); }
+        }
+    }
+    // 2. ID 비트 하나가 0 인 것 / 나머지
+    for (int bit = 0; bit < 32; bit++) {
+        uint32_t m = 1u << bit;
+        if ((id_mask & m) == 0) continue;
+        block_t cut = { 0, id_mask & ~m };
+        split_by(items, n, cut, side);
+        uint64_t size = split_size(items, n, side, &a, &b);
+        if (size < best) { best = size; memcpy(best_side, side, n); }
+    }
+    if (best == UINT64_MAX) return false;
+
+    // 3. 하나씩 반대쪽으로 옮겨 보며 줄어들면 그대로 (더 줄지 않을 때까지)
+    for (bool improved = true; improved;) {
+        improved = false;
+        for (int i = 0; i < n; i++) {
+            best_side[i] ^= 1;
+            uint64_t size = split_size(items, n, best_side, &a, &b);
+            if (size < best) {
+                best = size;
+                improved = true;
+            } else {
+                best_side[i] ^= 1;
+            }
+        }
+    }
+    split_size(items, n, best_side, best_a, best_b);
+    return true;
+}
+
+// 레지스터 값으로. RTR / 데이터 바이트 / 안 쓰는 비트는 모두 상관없음
+static void encode_single(can_filter_plan_t *p, block_t f) {
+    if (p->extd) {  // ID[28:0] -> 31..3, RTR 2
+        p->acceptance_code = f.code << 3;
+        p->acceptance_mask = f.mask << 3 | 0x7;
+    } else {        // ID[10:0] -> 31..21, RTR 20, 데이터 1/2 바이트 15..0
+        p->acceptance_code = f.code << 21;
+        p->acceptance_mask = f.mask << 21 | 0x1FFFFF;
+    }
+}
+
+static void encode_dual(can_filter_plan_t *p, block_t f1, block_t f2) {
+    if (p->extd) {  // 필터1: ID[28:13] -> 31..16, 필터2: ID[28:13] -> 15..0
+        p->acceptance_code = (f1.code >> 13) << 16 | f2.code >> 13;
+        p->acceptance_mask = (f1.mask >> 13) << 16 | f2.mask >> 13;
+    } else {        // 필터1: ID 31..21, RTR 20, 데이터1 19..16 + 3..0. 필터2: ID 15..5, RTR 4
+        p->acceptance_code = f1.code << 21 | f2.code << 5;
+        p->acceptance_mask = f1.mask << 21 | 0x1F0000 | f2.mask << 5 | 0x1F;
+    }
+}
+
+bool can_filter_plan(const can_filter_range_t *ranges, int n, bool extd, can_filter_plan_t *plan) {
+    memset(plan, 0, sizeof(*plan));
+    plan->extd = extd;
+    plan->single_filter = true;
+    uint32_t id_mask = extd ? EXT_ID_MASK : STD_ID_MASK;
+    if (n < 0 || n > CAN_FILTER_MAX_RANGES) return false;
+    if (n == 0) {   // 모두 통과
+        plan->accept_all = true;
+        plan->acceptance_code = 0;
+        plan->acceptance_mask = 0xFFFFFFFF;
+        plan->block_mask[0] = id_mask;
+        plan->wanted = plan->accepted = (uint64_t)id_mask + 1;
+        return true;
+    }
+
+    // 정렬해서 겹치거나 붙은 범위를 합침
+    can_filter_range_t merged[CAN_FILTER_MAX_RANGES];
+    memcpy(merged, ranges, sizeof(*ranges) * n);
+    for (int i = 0; i < n; i++) {
+        if (merged[i].lo > merged[i].hi || merged[i].hi > id_mask) return false;
+    }
+    qsort(merged, n, sizeof(*merged), cmp_range);
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        if (m > 0 && (uint64_t)merged[i].lo <= (uint64_t)merged[m - 1].hi + 1) {
+            if (merged[i].hi > merged[m - 1].hi) merged[m - 1].hi = merged[i].hi;
+        } else {
+            merged[m++] = merged[i];
+        }
+    }
+    for (int i = 0; i < m; i++) plan->wanted += (uint64_t)merged[i].hi - merged[i].lo + 1;
+
+    // 원하는 ID 를 블록으로 (정확히 쪼개거나, 너무 많으면 범위마다 덮는 블록 하나)
+    block_t items[CAN_FILTER_MAX_BLOCKS];
+    int num_items = 0;
+    for (int i = 0; i < m; i++) {
+        int k = split_range(merged[i].lo, merged[i].hi, items + num_items, CAN_FILTER_MAX_BLOCKS - num_items);
+        if (k < 0) {
+            num_items = -1;
+            break;
+        }
+        num_items += k;
+    }
+    if (num_items < 0) {
+        num_items = m;
+        for (int i = 0; i < m; i++) {
+            block_t lo = { merged[i].lo, 0 }, hi = { merged[i].hi, 0 };
+            items[i] = block_span(lo, hi);
+        }
+    }
+
+    // 1. 필터 하나: 전부 덮는 블록
+    block_t single = items[0];
+    for (int i = 1; i < num_items; i++) single = block_span(single, items[i]);
+    plan->block_code[0] = single.code;
+    plan->block_mask[0] = single.mask;
+    plan->accepted = block_size(single);
+    encode_single(plan, single);
+
+    // 2. 필터 두 개 (확장 ID 는 아래 13비트를 상관없음으로 넓힌 뒤)
+    if (num_items >= 2) {
+        if (extd) {
+            for (int i = 0; i < num_items; i++) {
+                items[i].mask |= EXT_DUAL_LOW;
+                items[i].code &= ~items[i].mask;
+            }
+        }
+        block_t a, b;
+        if (plan_dual(items, num_items, id_mask, &a, &b) && union_size(a, b) < plan->accepted) {
+            plan->single_filter = false;
+            plan->block_code[0] = a.code;
+            plan->block_mask[0] = a.mask;
+            plan->block_code[1] = b.code;
+            plan->block_mask[1] = b.mask;
+            plan->accepted = union_size(a, b);
+            encode_dual(plan, a, b);
+        }
+    }
+    plan->false_accept = (float)(plan->accepted - plan->wanted) / (float)plan->accepted;
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- [TWAI 하드웨어 수신 필터 계산] ---
+// TWAI_FILTER_CONFIG_ACCEPT_ALL() 이면 버스의 모든 프레임이 ISR -> 드라이버 큐 -> twai_receive 를 거침.
+// 원하는 ID(또는 범위) 목록에서 acceptance_code / acceptance_mask 를 계산해서 나머지는 하드웨어가 버리게 함.
+//  - 필터 하나(single)는 비트별로 "맞아야 함 / 상관없음" 이므로 ID 공간의 블록 하나(2^k 개)만 통과시킴.
+//    원하는 ID 를 모두 덮는 가장 작은 블록은 하나뿐 (ID 들 사이에 다른 비트 = 상관없음)
+//  - 필터 두 개(dual)는 블록 두 개. 원하는 ID 를 두 무리로 나눠 합집합이 가장 작은 것을 찾음
+//    (ID 두 개가 만드는 블록마다 그 안에 드는 것 / 나머지, 비트 하나로 나누는 경우를 보고,
+//     가장 나은 것에서 하나씩 반대쪽으로 옮겨 보며 더 줄임)
+//  - 확장 ID 의 dual 은 하드웨어가 ID 윗부분 16비트(28..13)만 비교하므로 아래 13비트는 상관없음
+// 결과가 더 적게 통과시키는 쪽을 고름. 표준/확장은 한 종류만 (섞으면 모두 통과).
+// 통과하는데 원하지 않는 ID 의 비율 (false accept) = (통과 ID 수 - 원하는 ID 수) / 통과 ID 수.
+// 버스 트래픽이 ID 별로 고르다고 볼 때 ISR 에서 버려야 할 프레임의 비율.
+// ESP-IDF 의존성 없음 (PC 의 tools/can_filter_plan 이 하드웨어 비교 규칙으로 전부 확인)
+
+#define CAN_FILTER_MAX_RANGES   64
+#define CAN_FILTER_MAX_BLOCKS   128     // 범위를 2^k 블록으로 쪼갠 개수가 이보다 많으면 범위 단위로 계산
+
+typedef struct {
+    uint32_t lo, hi;        // 양 끝 포함
+} can_filter_range_t;
+
+typedef struct {
+    bool accept_all;        // 원하는 ID 가 없음 (모두 통과)
+    bool extd;
+    bool single_filter;
+    uint32_t acceptance_code;   // twai_filter_config_t 에 그대로
+    uint32_t acceptance_mask;   // 1 = 상관없음
+    // 필터마다 통과시키는 ID 블록 (ID 비트 기준, mask 1 = 상관없음). single 이면 [0] 만
+    uint32_t block_code[2];
+    uint32_t block_mask[2];
+    uint64_t wanted;        // 원하는 ID 수
+    uint64_t accepted;      // 필터를 통과하는 ID 수
+    float false_accept;     // (accepted - wanted) / accepted
+} can_filter_plan_t;
+
+// "0x100,0x200-0x2FF" -> 범위 목록. 범위를 넘는 ID(표준 0x7FF, 확장 0x1FFFFFFF)나 잘못된 항목이 있으면 -1
+int can_filter_parse(const char *list, bool extd, can_filter_range_t *out, int max);
+
+// 원하는 범위 목록 -> 필터. n == 0 이면 accept_all. 범위가 잘못됐으면 false
+bool can_filter_plan(const can_filter_range_t *ranges, int n, bool extd, can_filter_plan_t *plan);
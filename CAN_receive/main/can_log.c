@@ -0,0 +1,458 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include "can_log.h"
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#include "esp_timer.h"
+#include "esp_idf_version.h"
+#include "esp_vfs_fat.h"
+static int64_t now_us(void) {
+    return esp_timer_get_time();
+}
+#else
+#include <time.h>
+static int64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#endif
+
+#ifndef CONFIG_CAN_LOG_BUF_SIZE
+#define CONFIG_CAN_LOG_BUF_SIZE 8192
+#endif
+#define BUF_SIZE CONFIG_CAN_LOG_BUF_SIZE
+_Static_assert(BUF_SIZE % CAN_LOG_SECTOR == 0, "CAN_LOG_BUF_SIZE must be a multiple of 512");
+
+#define SPARE_NAME  "NEXT.CAN"  // 준비된 다음 파일 (8.3 이름: 긴 이름을 끈 FatFs 에서도)
+#define ALLOC_NAME  "NEXT.TMP"  // 준비 중 (전원이 꺼지면 다음에 처음부터)
+
+// 핑퐁 버퍼 하나
+typedef struct {
+    uint8_t data[BUF_SIZE] __attribute__((aligned(4))); // 내부 RAM (SPI/SDMMC DMA 가능)
+    size_t len;             // 채운 바이트 수
+    size_t written;         // 앞쪽 중 이미 파일에 있는 바이트 (앞 버퍼에서 넘어온 마지막 섹터)
+    off_t pos;              // data[0] 의 파일 위치 (항상 섹터 경계)
+    bool sync;              // 쓴 다음 fsync
+    bool end_segment;       // 쓴 다음 파일을 닫음
+    bool new_segment;       // 쓰기 전에 path 를 새로 엶
+    char path[CAN_LOG_PATH_LEN];
+    uint32_t seq;           // 넘긴 순서 (쓰는 쪽은 먼저 넘긴 것부터)
+    atomic_bool queued;     // true = 쓰는 쪽 소유 (다 쓰면 false 로 돌려줌)
+} log_buf_t;
+
+enum { SPARE_NONE, SPARE_FILLING, SPARE_READY };
+
+static can_log_policy_t policy;
+static can_log_kick_t kick;
+static log_buf_t bufs[2];
+static can_log_stats_t stats;
+
+// 채우는 쪽 상태
+static bool opened;
+static int active;              // 채우는 중인 버퍼
+static uint32_t next_seq;
+static bool unsynced;           // 마지막 fsync 요청 뒤로 들어온 데이터가 있음
+static bool sync_pending;       // fsync 요청을 못 넘겨서 다시 시도해야 함
+static int64_t last_request_us; // 마지막 fsync 요청 시각
+
+// 쓰는 쪽 상태
+static int fd = -1;
+static bool preallocated;       // 지금 파일이 미리 잡은 파일 (닫을 때 쓴 데까지 잘라냄)
+static off_t data_end;          // 지금 파일에 쓴 끝
+static int64_t last_sync_us;
+
+// 미리 잡기 상태 (spare_state 만 쓰는 쪽과 주고받음: 쓰는 쪽은 READY -> NONE, 미리 잡기는 나머지)
+static atomic_int spare_state;
+static int alloc_fd = -1;
+static uint64_t alloc_pos;
+static char spare_path[CAN_LOG_PATH_LEN], alloc_path[CAN_LOG_PATH_LEN];
+static uint8_t zeros[BUF_SIZE] __attribute__((aligned(4)));
+
+static void record_latency(uint32_t us) {
+    int b = 31 - __builtin_clz(us | 1);         // 2^b <= us
+    int i = b < 2 ? (int)us : (b - 1) * 4 + (int)((us >> (b - 2)) & 3);
+    if (i >= CAN_LOG_HIST_BUCKETS) i = CAN_LOG_HIST_BUCKETS - 1;
+    stats.latency_hist[i]++;
+}
+
+uint32_t can_log_percentile_us(const can_log_stats_t *st, int permille) {
+    uint64_t total = 0, seen = 0;
+    for (int i = 0; i < CAN_LOG_HIST_BUCKETS; i++) total += st->latency_hist[i];
+    if (total == 0) return 0;
+    uint64_t want = (total * (uint64_t)permille + 999) / 1000;
+    if (want == 0) want = 1;
+    for (int i = 0; i < CAN_LOG_HIST_BUCKETS; i++) {
+        seen += st->latency_hist[i];
+        if (seen < want) continue;
+        if (i < 4) return (uint32_t)i;
+        int b = i / 4 + 1, sub = i % 4;
+        return ((uint32_t)(5 + sub) << (b - 2)) - 1; // 칸의 위쪽 끝
+    }
+    return UINT32_MAX;
+}
+
+// --- [세그먼트 파일 열기/닫기 (쓰는 쪽)] ---
+// 새 파일: 준비된 NEXT.CAN 이 있으면 이름만 바꿔서 (FAT 할당 없음), 없으면 빈 파일
+static bool open_segment(const char *path) {
+    preallocated = false;
+    if (atomic_load(&spare_state) == SPARE_READY) {
+        atomic_store(&spare_state, SPARE_NONE); // 실패해도 다시 준비하도록
+        if (rename(spare_path, path) == 0) {
+            fd = open(path, O_RDWR);
+            preallocated = fd >= 0;
+        }
+    }
+    if (!preallocated) {
+        stats.spare_misses++;
+        fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    }
+    data_end = 0;
+    if (fd < 0) return false;
+    stats.segments++;
+    return true;
+}
+
+static void close_segment(void) {
+    if (fd < 0) return;
+    // 미리 잡은 파일은 쓴 데까지만 남김 (나머지 0 은 버림)
+    if (preallocated && ftruncate(fd, data_end) != 0) stats.errors++;
+    close(fd);
+    fd = -1;
+}
+
+bool can_log_open(const char *path, const can_log_policy_t *p, can_log_kick_t k) {
+    can_log_close();
+    memset(&stats, 0, sizeof(stats));
+    policy = *p;
+    kick = k;
+    log_buf_t *b = &bufs[0];
+
+    if (policy.segment_size > 0) {
+        // 전에 준비해 둔 NEXT.CAN 이 크기가 맞으면 그대로 씀. 준비 중이던 것은 지우고 다시
+        snprintf(spare_path, sizeof(spare_path), "%s/" SPARE_NAME, policy.segment_dir);
+        snprintf(alloc_path, sizeof(alloc_path), "%s/" ALLOC_NAME, policy.segment_dir);
+        struct stat st;
+        bool ready = stat(spare_path, &st) == 0 && (uint64_t)st.st_size == policy.segment_size;
+        if (!ready) unlink(spare_path);
+        unlink(alloc_path);
+        atomic_store(&spare_state, ready ? SPARE_READY : SPARE_NONE);
+
+        if (!open_segment(path)) return false;
+        b->pos = 0;
+        b->len = 0;
+    } else {
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) return false;
+        stats.segments = 1;
+
+        // 이미 있는 파일이면 끝에 이어서: 마지막 섹터의 앞부분을 버퍼로 읽어 와서 섹터 경계부터 쓰도록
+        off_t size = lseek(fd, 0, SEEK_END);
+        if (size < 0) size = 0;
+        b->pos = size - size % CAN_LOG_SECTOR;
+        b->len = (size_t)(size - b->pos);
+        if (b->len > 0 && (lseek(fd, b->pos, SEEK_SET) != b->pos || read(fd, b->data, b->len) != (ssize_t)b->len)) {
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        data_end = size;
+    }
+    b->written = b->len;
+    b->new_segment = b->end_segment = false;
+    atomic_store(&bufs[0].queued, false);
+    atomic_store(&bufs[1].queued, false);
+    active = 0;
+    opened = true;
+    unsynced = false;
+    sync_pending = false;
+    last_request_us = last_sync_us = now_us();
+    if (policy.preamble != NULL && policy.preamble_len <= BUF_SIZE - b->len) {
+        memcpy(b->data + b->len, policy.preamble, policy.preamble_len);
+        b->len += policy.preamble_len;
+        unsynced = true;
+    }
+    return true;
+}
+
+// --- [채우는 쪽] ---
+// 채우던 버퍼를 쓰는 쪽으로 넘기고 다른 버퍼로 바꿈. 다른 버퍼가 아직 쓰는 중이면 false
+static bool hand_off(bool sync) {
+    log_buf_t *cur = &bufs[active], *next = &bufs[active ^ 1];
+    if (atomic_load_explicit(&next->queued, memory_order_acquire)) return false;
+
+    // 다음 버퍼는 지금 버퍼의 덜 찬 마지막 섹터부터 시작 (다음에 그 섹터를 통째로 다시 씀)
+    size_t tail = cur->len % CAN_LOG_SECTOR;
+    memcpy(next->data, cur->data + cur->len - tail, tail);
+    next->len = next->written = tail;
+    next->pos = cur->pos + (off_t)(cur->len - tail);
+    next->new_segment = next->end_segment = false;
+
+    cur->sync = sync;
+    cur->seq = next_seq++;
+    atomic_store_explicit(&cur->queued, true, memory_order_release);
+    active ^= 1;
+    if (kick != NULL) kick();
+    return true;
+}
+
+// 지금 버퍼로 파일을 마치고, 다른 버퍼는 새 파일의 처음(preamble)부터. 다른 버퍼가 아직 쓰는 중이면 false
+static bool start_segment(void) {
+    log_buf_t *cur = &bufs[active], *next = &bufs[active ^ 1];
+    if (atomic_load_explicit(&next->queued, memory_order_acquire)) return false;
+
+    next->pos = 0;
+    next->len = next->written = 0;
+    next->new_segment = true;
+    next->end_segment = false;
+    policy.name(next->path, sizeof(next->path));
+    if (policy.preamble != NULL && policy.preamble_len <= BUF_SIZE) {
+        memcpy(next->data, policy.preamble, policy.preamble_len);
+        next->len = policy.preamble_len;
+    }
+
+    cur->sync = true;
+    cur->end_segment = true;
+    cur->seq = next_seq++;
+    atomic_store_explicit(&cur->queued, true, memory_order_release);
+    active ^= 1;
+    unsynced = next->len > 0;
+    sync_pending = false;
+    last_request_us = now_us();
+    if (kick != NULL) kick();
+    return true;
+}
+
+bool can_log_rotate(void) {
+    if (!opened || policy.segment_size == 0 || policy.name == NULL) return false;
+    return start_segment();
+}
+
+bool can_log_write(const void *data, size_t len) {
+    if (!opened || len > BUF_SIZE) return false;
+    log_buf_t *cur = &bufs[active];
+    // 이 파일에 다 들어가지 않으면 다음 파일로 (레코드가 두 파일에 걸치지 않도록)
+    if (policy.segment_size > 0 && policy.name != NULL &&
+        (uint64_t)cur->pos + cur->len + len > policy.segment_size) {
+        if (!start_segment()) {
+            stats.stalls++;
+            return false;
+        }
+        cur = &bufs[active];
+    }
+    // 넘치는데 다른 버퍼가 아직 쓰는 중이면 하나도 넣지 않음 (레코드가 잘리지 않도록)
+    if (BUF_SIZE - cur->len < len && atomic_load_explicit(&bufs[active ^ 1].queued, memory_order_acquire)) {
+        stats.stalls++;
+        return false;
+    }
+
+    const uint8_t *src = data;
+    while (len > 0) {
+        size_t n = BUF_SIZE - cur->len < len ? BUF_SIZE - cur->len : len;
+        memcpy(cur->data + cur->len, src, n);
+        cur->len += n;
+        src += n;
+        len -= n;
+        if (cur->len == BUF_SIZE) {
+            // 레코드가 버퍼를 딱 채웠는데 다른 버퍼가 아직 쓰는 중이면 넘기지 못함 (위의 확인은 넘칠 때만).
+            // 레코드는 다 들어갔으므로 꽉 찬 채로 두고, 다음 can_log_write (또는 시간 flush) 가 넘김
+            if (!hand_off(false)) {
+                stats.stalls++;
+                break; // 여기까지 오면 len == 0 (한 번 넘긴 뒤 남은 것은 버퍼 하나를 넘지 않음)
+            }
+            stats.flush_size++;
+            cur = &bufs[active];
+        }
+    }
+    unsynced = true;
+    return true;
+}
+
+// 쌓인 것을 넘기면서 fsync 요청. 못 넘기면 다음 can_log_poll 에서 다시
+static bool request_sync(void) {
+    log_buf_t *cur = &bufs[active];
+    if (!unsynced && cur->len == cur->written) {
+        sync_pending = false;
+        return true;
+    }
+    if (!hand_off(true)) {
+        sync_pending = true;
+        return false;
+    }
+    unsynced = false;
+    sync_pending = false;
+    last_request_us = now_us();
+    return true;
+}
+
+void can_log_on_id(uint32_t id) {
+    if (!opened) return;
+    for (int i = 0; i < policy.flush_id_count; i++) {
+        if (policy.flush_ids[i] != id) continue;
+        stats.flush_event++;
+        request_sync();
+        return;
+    }
+}
+
+void can_log_poll(void) {
+    if (!opened) return;
+    if (sync_pending) {
+        request_sync();
+        return;
+    }
+    if (policy.flush_ms == 0 || now_us() - last_request_us < (int64_t)policy.flush_ms * 1000) return;
+    // 지난 fsync 뒤로 아무것도 안 들어왔으면 생략 (간격만 새로 시작)
+    if (!unsynced) {
+        last_request_us = now_us();
+        return;
+    }
+    stats.flush_time++;
+    request_sync();
+}
+
+bool can_log_sync(void) {
+    if (!opened) return false;
+    return request_sync();
+}
+
+// --- [쓰는 쪽] ---
+bool can_log_service(void) {
+    // 둘 다 넘어와 있으면 먼저 넘긴 것부터 (뒤 버퍼가 앞 버퍼의 마지막 섹터를 다시 쓰므로 순서가 중요)
+    log_buf_t *b = NULL;
+    for (int i = 0; i < 2; i++) {
+        if (!atomic_load_explicit(&bufs[i].queued, memory_order_acquire)) continue;
+        if (b == NULL || (int32_t)(bufs[i].seq - b->seq) < 0) b = &bufs[i];
+    }
+    if (b == NULL) return false;
+
+    int64_t start = now_us();
+    if (b->new_segment && !open_segment(b->path)) stats.errors++;
+    if (b->len > b->written) {
+        int64_t t0 = now_us();
+        bool ok = fd >= 0 && lseek(fd, b->pos, SEEK_SET) == b->pos && write(fd, b->data, b->len) == (ssize_t)b->len;
+        uint32_t dt = (uint32_t)(now_us() - t0);
+        stats.writes++;
+        stats.write_total_us += dt;
+        if (dt > stats.write_max_us) stats.write_max_us = dt;
+        if (ok) {
+            stats.bytes += b->len - b->written;
+            if (b->pos + (off_t)b->len > data_end) data_end = b->pos + (off_t)b->len;
+        } else {
+            stats.errors++; // 카드가 빠졌거나 가득 참: 이 버퍼는 버림
+        }
+    }
+    if (b->sync && fd >= 0) {
+        int64_t t0 = now_us();
+        if (fsync(fd) != 0) stats.errors++;
+        int64_t now = now_us();
+        uint32_t dt = (uint32_t)(now - t0);
+        uint32_t gap_ms = (uint32_t)((now - last_sync_us) / 1000);
+        stats.fsyncs++;
+        stats.fsync_total_us += dt;
+        if (dt > stats.fsync_max_us) stats.fsync_max_us = dt;
+        if (gap_ms > stats.fsync_gap_max_ms) stats.fsync_gap_max_ms = gap_ms;
+        last_sync_us = now;
+    }
+    if (b->end_segment) close_segment();
+    record_latency((uint32_t)(now_us() - start));
+    atomic_store_explicit(&b->queued, false, memory_order_release);
+    return true;
+}
+
+// --- [다음 파일 미리 잡기] ---
+static void alloc_fail(void) {
+    stats.alloc_errors++;
+    if (alloc_fd >= 0) close(alloc_fd);
+    alloc_fd = -1;
+    unlink(alloc_path);
+    atomic_store(&spare_state, SPARE_NONE);
+}
+
+bool can_log_prepare(void) {
+    if (!opened || policy.segment_size == 0) return false;
+    int state = atomic_load(&spare_state);
+    if (state == SPARE_READY) return false;
+
+    if (state == SPARE_NONE) {
+#ifdef ESP_PLATFORM
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+        // 연속된 클러스터로 한 번에 할당 (빈 공간이 조각나 있으면 실패 -> 채우면서 늘림)
+        esp_vfs_fat_create_contiguous_file(policy.segment_dir, alloc_path, policy.segment_size, true);
+#endif
+#endif
+        alloc_fd = open(alloc_path, O_RDWR | O_CREAT, 0644);
+        if (alloc_fd < 0) {
+            alloc_fail();
+            return false;
+        }
+        alloc_pos = 0;
+        atomic_store(&spare_state, SPARE_FILLING);
+        return true;
+    }
+
+    // 0 으로 채움: 이미 할당됐으면 데이터만 덮어쓰고, 아니면 여기서 늘어남 (기록 중이 아니라)
+    size_t n = policy.segment_size - alloc_pos < BUF_SIZE ? (size_t)(policy.segment_size - alloc_pos) : BUF_SIZE;
+    if (lseek(alloc_fd, (off_t)alloc_pos, SEEK_SET) != (off_t)alloc_pos || write(alloc_fd, zeros, n) != (ssize_t)n) {
+        alloc_fail();
+        return false;
+    }
+    alloc_pos += n;
+    if (alloc_pos < policy.segment_size) return true;
+
+    bool ok = fsync(alloc_fd) == 0;
+    close(alloc_fd);
+    alloc_fd = -1;
+    unlink(spare_path); // 이름을 바꾸지 못하고 남은 것 (FAT 의 rename 은 덮어쓰지 않음)
+    if (!ok || rename(alloc_path, spare_path) != 0) {
+        alloc_fail();
+        return false;
+    }
+    atomic_store(&spare_state, SPARE_READY);
+    return false;
+}
+
+void can_log_close(void) {
+    if (!opened) return;
+    while (can_log_service()) {
+    }
+    if (request_sync()) {
+        while (can_log_service()) {
+        }
+    }
+    close_segment();
+    if (alloc_fd >= 0) { // 준비 중이던 것은 다음에 처음부터
+        close(alloc_fd);
+        alloc_fd = -1;
+        unlink(alloc_path);
+        atomic_store(&spare_state, SPARE_NONE);
+    }
+    opened = false;
+}
+
+void can_log_get_stats(can_log_stats_t *out) {
+    *out = stats;
+    out->spare_ready = atomic_load(&spare_state) == SPARE_READY;
+}
+
+int can_log_parse_ids(can_log_policy_t *p, const char *list) {
+    p->flush_id_count = 0;
+    const char *s = list;
+    while (*s != '\0' && p->flush_id_count < CAN_LOG_MAX_IDS) {
+        char *end;
+        unsigned long id = strtoul(s, &end, 0);
+        if (end == s) { // 숫자가 아닌 글자(쉼표 등)는 건너뜀
+            s++;
+            continue;
+        }
+        if (id <= 0x1FFFFFFF) p->flush_ids[p->flush_id_count++] = (uint32_t)id;
+        s = end;
+    }
+    return p->flush_id_count;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// --- [SD 카드 로그 파일 쓰기] ---
+// 프레임마다 fopen/fprintf/fclose 를 하면 매번 FAT 와 디렉터리 항목을 고쳐 써서 초당 수십 프레임이 한계.
+// 파일은 한 번만 열어 두고, 기록할 내용은 RAM 버퍼에 모았다가 섹터(512 바이트) 경계에서부터 한 번에 씀.
+//  - 크기: 버퍼(CAN_LOG_BUF_SIZE)가 가득 차면 통째로 씀. 섹터 단위라 FatFs 가 중간 복사 없이 카드로 바로 보냄
+//  - 시간: 마지막 fsync 후 flush_ms 가 지나면 쌓인 만큼 쓰고 fsync (전원이 꺼져도 잃는 양의 상한)
+//  - 이벤트: flush_ids 에 있는 ID(예: 0x100 버튼) 프레임을 기록하면 바로 쓰고 fsync
+// 크기로 쓸 때는 fsync 하지 않음 (데이터는 카드에 가지만 파일 크기/FAT 갱신은 다음 fsync 때 한 번에).
+// 중간에 쓴 마지막 섹터의 남은 부분은 다음 버퍼 앞에 복사해 두었다가 다음에 그 섹터부터 다시 씀
+// (모든 쓰기가 섹터 경계에서 시작함).
+//
+// 버퍼는 두 개 (핑퐁): 하나를 채우는 동안 다른 하나는 쓰기 태스크가 카드에 씀.
+//  - 채우는 쪽(기록 태스크): can_log_write / can_log_on_id / can_log_poll. 카드를 기다리지 않음
+//  - 쓰는 쪽(SD 쓰기 태스크): kick 콜백으로 깨어나서 can_log_service() 호출
+// 두 버퍼가 모두 카드로 가는 중이면 can_log_write 는 false (데이터는 호출한 쪽 링에 그대로 두고 나중에 다시).
+// 두 쪽은 버퍼 상태(원자 변수)로만 주고받으므로 잠금 없음.
+// POSIX open/write/fsync 만 쓰므로 PC 에서도 같은 코드가 동작 (tools/can_pipeline_bench).
+//
+// 세그먼트 (segment_size > 0): 파일 하나를 계속 늘리면 쓸 때마다 FAT 에서 빈 클러스터를 찾아 잇고
+// fsync 때 FAT 를 고쳐 쓰므로 (카드의 다른 자리에 작은 쓰기) 오래 돌릴수록 쓰기 시간이 들쭉날쭉해지고,
+// 큰 파일 하나는 깨지면 전부 잃음. 그래서 정해진 크기의 파일을 미리 잡아 두고 채운 뒤 다음 파일로 넘어감.
+//  - 미리 잡기: can_log_prepare() 를 낮은 우선순위 태스크에서 반복 호출. 폴더에 NEXT.TMP 를 연속된
+//    클러스터로 만들고 (ESP-IDF 5.3+) 0 으로 채운 뒤 NEXT.CAN 으로 이름을 바꿔 둠 (끊겨도 다음에 다시)
+//  - 넘어가기: 크기가 차면 (또는 can_log_rotate, 예: 시각이 정시를 넘으면) 쓰는 쪽이 지금 파일을
+//    fsync + 쓴 데까지 잘라 닫고, NEXT.CAN 을 새 이름으로 바꿔 열어서 이어 씀. FAT 할당은 기록 중에 없음.
+//    NEXT.CAN 이 아직 없으면 새 파일을 만들어 늘려 가며 씀 (spare_misses)
+//  - 파일마다 맨 앞에 preamble (머리말 레코드). 전원이 꺼져 잘라내지 못한 파일은 끝이 0 으로 채워져 있음
+
+#define CAN_LOG_SECTOR      512
+#define CAN_LOG_MAX_IDS     8
+#define CAN_LOG_PATH_LEN    64
+#define CAN_LOG_HIST_BUCKETS 96     // 쓰기 시간 분포: 2배마다 4칸 (1 us ~ 16 s)
+
+// 다음 파일 이름 (넘어갈 때 채우는 쪽에서 부름)
+typedef void (*can_log_name_t)(char *path, size_t size);
+
+typedef struct {
+    uint32_t flush_ms;                  // 0 = 시간으로는 쓰지 않음
+    uint32_t flush_ids[CAN_LOG_MAX_IDS];
+    int flush_id_count;
+
+    uint64_t segment_size;              // 0 = 파일 하나를 계속 늘림 (끝에 이어서). 아니면 이 크기로 나눔
+    const char *segment_dir;            // 미리 잡아 둔 파일(NEXT.CAN)을 둘 곳 = 로그 폴더 (마운트 지점)
+    can_log_name_t name;                // 다음 파일 이름
+    const void *preamble;               // 파일마다 맨 앞에 쓸 내용 (NULL = 없음)
+    size_t preamble_len;
+} can_log_policy_t;
+
+typedef struct {
+    // 채우는 쪽
+    uint32_t flush_size;        // 버퍼가 차서 넘긴 횟수
+    uint32_t flush_time;        // 시간이 돼서 넘긴 횟수
+    uint32_t flush_event;       // 이벤트 ID 로 넘긴 횟수
+    uint32_t stalls;            // 두 버퍼가 모두 쓰는 중이라 받지 못한 횟수
+    // 쓰는 쪽
+    uint64_t bytes;             // 파일에 쓴 바이트 (같은 섹터를 다시 쓴 양은 제외)
+    uint32_t writes;            // write() 호출 수
+    uint32_t write_max_us;
+    uint64_t write_total_us;
+    uint32_t fsyncs;
+    uint32_t fsync_max_us;
+    uint64_t fsync_total_us;
+    uint32_t fsync_gap_max_ms;  // fsync 사이 간격의 최대값 (전원이 꺼지면 잃을 수 있는 시간)
+    uint32_t errors;            // write/fsync 실패
+    // 버퍼 하나를 카드로 보내는 시간 (write + fsync + 파일 넘기기) 분포. can_log_percentile_us 로 읽음
+    uint32_t latency_hist[CAN_LOG_HIST_BUCKETS];
+    // 세그먼트
+    uint32_t segments;          // 연 파일 수 (처음 파일 포함)
+    uint32_t spare_misses;      // 넘어갈 때 미리 잡은 파일이 없어서 새로 만든 횟수
+    uint32_t alloc_errors;      // 미리 잡기 실패 (카드 가득 참 등)
+    bool spare_ready;           // 다음 파일이 준비돼 있음
+} can_log_stats_t;
+
+// 쓸 버퍼가 생겼을 때 채우는 쪽에서 부름 (SD 쓰기 태스크를 깨우는 용도, 여기서 기다리면 안 됨)
+typedef void (*can_log_kick_t)(void);
+
+// 파일을 열고(없으면 만듦) 기록하도록 준비 (preamble 을 먼저 넣음).
+// segment_size == 0: 있던 파일이면 끝에 이어서. 아니면 새 파일 (NEXT.CAN 이 있으면 그것을 이 이름으로)
+bool can_log_open(const char *path, const can_log_policy_t *policy, can_log_kick_t kick);
+
+// 버퍼에 추가. 전부 넣었으면 true, 두 버퍼가 모두 쓰는 중이라 하나도 못 넣었으면 false
+// (파일이 열려 있지 않아도 false)
+bool can_log_write(const void *data, size_t len);
+
+// 프레임 하나를 기록한 뒤 그 ID 로 호출: 이벤트 ID 면 바로 씀 + fsync
+void can_log_on_id(uint32_t id);
+
+// 주기적으로 호출: flush_ms 가 지났으면 씀 + fsync (못 넘긴 요청도 여기서 다시 시도)
+void can_log_poll(void);
+
+// 쌓인 것을 모두 넘기고 fsync 요청. 버퍼가 모두 쓰는 중이면 false (나중에 다시)
+bool can_log_sync(void);
+
+// 지금 파일을 마치고 policy.name 이 주는 새 파일로 넘어감 (크기로 넘어가는 것은 can_log_write 가 알아서).
+// 세그먼트 모드(segment_size > 0)에서만. 아니면 또는 버퍼가 모두 쓰는 중이면 false (나중에 다시)
+bool can_log_rotate(void);
+
+// SD 쓰기 태스크: 넘겨받은 버퍼를 순서대로 카드에 씀. 한 일이 있으면 true
+bool can_log_service(void);
+
+// 미리 잡기 태스크: 다음 파일을 조금(버퍼 하나 크기)씩 준비. 할 일이 남았으면 true (다 됐거나 실패하면 false)
+bool can_log_prepare(void);
+
+// 남은 것을 모두 쓰고 닫음 (SD 쓰기 태스크가 멈춘 뒤에 호출, 이 안에서 직접 씀)
+void can_log_close(void);
+
+void can_log_get_stats(can_log_stats_t *out);
+
+// 쓰기 시간 분포에서 permille(예: 990 = 99%) 번째 값 (그 칸의 위쪽 끝, 오차 25% 이내). 기록이 없으면 0
+uint32_t can_log_percentile_us(const can_log_stats_t *st, int permille);
+
+// 정책 문자열 "0x100,0x7DF" -> flush_ids (잘못된 항목은 건너뜀). 읽은 ID 수
+int can_log_parse_ids(can_log_policy_t *policy, const char *list);
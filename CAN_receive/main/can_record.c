@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <string.h>
+#include "can_record.h"
+
+void can_record_header_init(can_record_header_t *h) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, CAN_RECORD_MAGIC, sizeof(h->magic));
+    h->version = CAN_RECORD_VERSION;
+    h->record_size = sizeof(can_record_t);
+}
+
+bool can_record_is_header(const void *block) {
+    return memcmp(block, CAN_RECORD_MAGIC, 8) == 0;
+}
+
+// 1970-01-01 부터의 날 수 (그레고리력, 3월을 한 해의 시작으로 놓고 계산)
+static int64_t days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - (int)(era * 400);
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static void civil_from_days(int64_t z, int *y, int *m, int *d) {
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = (int)(z - era * 146097);
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = (int)(yoe + era * 400) + (*m <= 2);
+}
+
+int64_t can_record_epoch(int year, int month, int day, int hour, int min, int sec) {
+    return days_from_civil(year, month, day) * 86400 + hour * 3600 + min * 60 + sec;
+}
+
+// --- [기본 신호 표] ---
+// 같은 ID 의 신호는 연달아 (신호 없는 메시지는 이벤트로 눈에 띄게 출력)
+const can_dbc_def_t can_record_signals[] = {
+    // ID    확장   메시지    DLC 신호    시작 길이 빅엔디언 부호   배율            오프셋 단위
+    { 0x100, false, "BUTTON", 0, NULL,   0,  0,  false, false, 0,              0,     NULL },
+    { 0x200, false, "DHT11",  2, "Temp", 0,  8,  false, false, 1,              0,     "°C" },
+    { 0x200, false, "DHT11",  2, "Hum",  8,  8,  false, false, 1,              0,     "%" },
+    // MPU6500 가속도: 빅 엔디언 16비트 x3, 1g = 16384
+    { 0x300, false, "ACCEL",  6, "X",    7,  16, true,  true,  1 / 16384.0f,   0,     "g" },
+    { 0x300, false, "ACCEL",  6, "Y",    23, 16, true,  true,  1 / 16384.0f,   0,     "g" },
+    { 0x300, false, "ACCEL",  6, "Z",    39, 16, true,  true,  1 / 16384.0f,   0,     "g" },
+};
+const int can_record_num_signals = sizeof(can_record_signals) / sizeof(can_record_signals[0]);
+
+int can_record_format_csv(const can_dbc_t *db, const can_record_t *r, bool all, char *out, size_t size) {
+    int64_t t = (int64_t)(r->time_us / 1000000);
+    int year, month, day;
+    civil_from_days(t / 86400, &year, &month, &day);
+    int hour = (int)(t % 86400 / 3600), min = (int)(t % 3600 / 60), sec = (int)(t % 60);
+
+    if (r->flags & CAN_REC_EVENT) {
+        if (r->id == CAN_EVENT_BOOT) return snprintf(out, size, "SYSTEM_START, Power On Reset\n");
+        return all ? snprintf(out, size, "%04d-%02d-%02d %02d:%02d:%02d, EVENT, %lu\n",
+                              year, month, day, hour, min, sec, (unsigned long)r->id) : 0;
+    }
+
+    const can_dbc_message_t *m = can_dbc_find(db, r->id, (r->flags & CAN_REC_EXTD) != 0);
+    float values[CAN_DBC_MAX_MSG_SIGNALS];
+    if (m != NULL && can_dbc_decode(db, m, r->data, r->dlc, values) == m->num_signals) {
+        int n = snprintf(out, size, "%04d-%02d-%02d %02d:%02d:%02d, %s",
+                         year, month, day, hour, min, sec, m->name);
+        // 예전 CSV 모양: 버튼 "Clicked", 온습도 "Temp:25", 가속도는 숫자만 (float 그대로 소수 2자리)
+        if (m->num_signals == 0 && n > 0 && (size_t)n < size) n += snprintf(out + n, size - n, ", Clicked");
+        const can_dbc_signal_t *sig = &db->signals[m->first_signal];
+        for (int i = 0; i < m->num_signals && n > 0 && (size_t)n < size; i++) {
+            if (sig[i].decimals == 0) n += snprintf(out + n, size - n, ", %s:%.0f", sig[i].name, values[i]);
+            else n += snprintf(out + n, size - n, ", %.2f", values[i]);
+        }
+        if (n > 0 && (size_t)n < size) n += snprintf(out + n, size - n, "\n");
+        return n;
+    }
+    if (!all) return 0;
+
+    // 해석하지 않는 ID: 원본 바이트
+    int n = snprintf(out, size, "%04d-%02d-%02d %02d:%02d:%02d, RAW, 0x%lX, %u,",
+                     year, month, day, hour, min, sec, (unsigned long)r->id, r->dlc);
+    for (int i = 0; i < r->dlc && i < 8 && n > 0 && (size_t)n < size; i++) {
+        n += snprintf(out + n, size - n, " %02X", r->data[i]);
+    }
+    if (n > 0 && (size_t)n < size) n += snprintf(out + n, size - n, "\n");
+    return n;
+}
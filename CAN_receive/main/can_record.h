@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "can_dbc.h"
+
+// --- [CAN 로그 바이너리 레코드] ---
+// 프레임마다 sprintf 로 CSV 한 줄(~60 바이트, 가속도는 float 변환까지)을 만드는 대신
+// 받은 그대로 고정 크기(24 바이트) 레코드로 저장합니다. 사람이 볼 CSV 는 PC 에서
+// tools/can_log2csv 로 만듦 (해석은 로거 화면 출력과 같은 신호 표 + can_record_format_csv() 를 같이 씀).
+//  - 파일 맨 앞(그리고 이어서 쓸 때마다)에 같은 크기의 머리말 레코드가 들어감 (magic 으로 구별)
+//  - 리틀 엔디언 그대로 저장 (ESP32, PC 모두 리틀 엔디언)
+//  - 시각은 RTC 시각을 그대로 1970-01-01 기준 마이크로초로 (시간대 변환 없음, RTC 가 KST 면 KST)
+// ESP-IDF 의존성 없음
+
+#define CAN_RECORD_MAGIC    "CANLOG\x01\n" // 8 바이트 (마지막 '\0' 제외)
+#define CAN_RECORD_VERSION  1
+
+// flags
+#define CAN_REC_EXTD        0x01    // 29비트 ID
+#define CAN_REC_RTR         0x02    // 원격 요청 프레임
+#define CAN_REC_EVENT       0x80    // CAN 프레임이 아닌 로거 이벤트 (id = CAN_EVENT_*)
+
+// 로거 이벤트 번호
+#define CAN_EVENT_BOOT      1       // 전원 켜짐
+
+typedef struct {
+    uint64_t time_us;       // 받은 시각 (1970-01-01 00:00:00 기준)
+    uint32_t id;
+    uint8_t flags;
+    uint8_t dlc;
+    uint16_t reserved;      // 0
+    uint8_t data[8];
+} can_record_t;
+
+typedef struct {
+    char magic[8];          // CAN_RECORD_MAGIC
+    uint16_t version;
+    uint16_t record_size;   // sizeof(can_record_t)
+    uint8_t reserved[12];
+} can_record_header_t;
+
+_Static_assert(sizeof(can_record_t) == 24, "record layout changed");
+_Static_assert(sizeof(can_record_header_t) == sizeof(can_record_t), "header must be one record long");
+
+void can_record_header_init(can_record_header_t *h);
+bool can_record_is_header(const void *block);
+
+// 달력 시각(연/월/일 시:분:초) -> 1970-01-01 기준 초 (윤년 포함, 시간대 없음)
+int64_t can_record_epoch(int year, int month, int day, int hour, int min, int sec);
+
+// 기본 신호 표 (버튼 0x100, DHT11 0x200, MPU6500 0x300). SD 카드에 .dbc 가 없을 때 로거 화면 출력과
+// can_log2csv 가 같이 쓰는 하나뿐인 표: ID 를 늘리거나 배율을 바꿀 때는 여기만 고침
+extern const can_dbc_def_t can_record_signals[];
+extern const int can_record_num_signals;
+
+// 기록 한 개 -> 로거가 예전에 쓰던 CSV 한 줄 ("\n" 포함). 쓸 줄이 없으면 0.
+// 해석은 db (can_dbc_build 까지 끝난 표) 로: 신호 없는 메시지는 "이름, Clicked",
+// 신호가 있으면 "이름" 뒤에 신호마다 정수(배율 1)는 ", 이름:값", 나머지는 ", 값" (소수 2자리).
+// 신호를 하나라도 담지 못하는 짧은 프레임은 해석하지 않음.
+// all 이 false 면 예전과 같이 표에 있는 ID 와 이벤트만, true 면 나머지 ID 도 원본 바이트로
+int can_record_format_csv(const can_dbc_t *db, const can_record_t *r, bool all, char *out, size_t size);
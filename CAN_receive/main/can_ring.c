@@ -0,0 +1,35 @@
+#include <string.h>
+#include "can_ring.h"
+
+bool can_ring_init(can_ring_t *r, can_record_t *slots, uint32_t size) {
+    memset(r, 0, sizeof(*r));
+    if (size < 2 || (size & (size - 1)) != 0) return false;
+    r->slots = slots;
+    r->size = size;
+    return true;
+}
+
+bool can_ring_push(can_ring_t *r, const can_record_t *rec) {
+    uint32_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    uint32_t used = head - atomic_load_explicit(&r->tail, memory_order_acquire);
+    if (used >= r->size) {
+        atomic_fetch_add_explicit(&r->dropped, 1, memory_order_relaxed);
+        return false;
+    }
+    r->slots[head & (r->size - 1)] = *rec;
+    // 레코드를 다 쓴 다음에 head 가 보이도록
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+    if (used + 1 > r->high_water) r->high_water = used + 1;
+    return true;
+}
+
+const can_record_t *can_ring_peek(can_ring_t *r) {
+    uint32_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (atomic_load_explicit(&r->head, memory_order_acquire) == tail) return NULL;
+    return &r->slots[tail & (r->size - 1)];
+}
+
+void can_ring_pop(can_ring_t *r) {
+    // 읽기를 다 끝낸 다음에 자리를 돌려줌
+    atomic_fetch_add_explicit(&r->tail, 1, memory_order_release);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "can_record.h"
+
+// --- [수신 태스크 -> 기록 태스크 레코드 링] ---
+// 넣는 쪽(CAN 수신 태스크) 하나, 빼는 쪽(기록 태스크) 하나인 잠금 없는 링.
+// 수신 태스크는 절대 기다리지 않음: 링이 차 있으면 그 프레임은 버리고 dropped 만 셈
+// (SD 카드가 수백 ms 멈춰도 TWAI 드라이버 큐가 넘치지 않게 하는 것이 목적).
+// head/tail 은 계속 증가하는 32비트 카운터 (뺄셈으로 개수 계산, 넘쳐도 괜찮음)
+// ESP-IDF 의존성 없음
+
+typedef struct {
+    can_record_t *slots;
+    uint32_t size;          // 2의 거듭제곱
+    atomic_uint head;       // 넣은 수 (수신 태스크만 씀)
+    atomic_uint tail;       // 뺀 수 (기록 태스크만 씀)
+    atomic_uint dropped;    // 링이 차서 버린 프레임 수
+    uint32_t high_water;    // 가장 많이 쌓였을 때의 개수 (수신 태스크가 갱신)
+} can_ring_t;
+
+// size 는 2의 거듭제곱 (아니면 false)
+bool can_ring_init(can_ring_t *r, can_record_t *slots, uint32_t size);
+
+// 수신 태스크: 빈자리가 없으면 false (dropped 증가)
+bool can_ring_push(can_ring_t *r, const can_record_t *rec);
+
+// 기록 태스크: 맨 앞 레코드를 보기만 함 (없으면 NULL). 다 쓴 뒤 can_ring_pop()
+const can_record_t *can_ring_peek(can_ring_t *r);
+void can_ring_pop(can_ring_t *r);
+
+static inline uint32_t can_ring_count(can_ring_t *r) {
+    return atomic_load_explicit(&r->head, memory_order_acquire) - atomic_load_explicit(&r->tail, memory_order_acquire);
+}
@@ -0,0 +1,155 @@
+#include "can_sdtest.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// --- [확인용 데이터] ---
+// xorshift32: 파일 위치마다 값이 달라서 섹터가 밀리거나 겹쳐 써져도 드러남
+static uint32_t next_word(uint32_t *x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+static void fill(uint32_t *words, size_t n, uint32_t *x) {
+    for (size_t i = 0; i < n; i++) words[i] = next_word(x);
+}
+
+static bool write_all(int f, const uint8_t *p, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(f, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool read_all(int f, uint8_t *p, size_t len) {
+    while (len > 0) {
+        ssize_t n = read(f, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// --- [읽어서 비교] ---
+bool can_sdtest_verify(const char *path, void *buf, size_t buf_size, size_t bytes, uint32_t seed) {
+    size_t chunk = buf_size & ~(size_t)3;
+    if (chunk == 0 || bytes % 4 != 0) return false;
+    uint32_t *words = buf;
+    uint32_t start = seed * 2654435761u | 1; // 0 이면 xorshift 가 0 에 머묾
+
+    // 1. 써서 카드까지 (fsync)
+    int f = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (f < 0) return false;
+    bool ok = true;
+    uint32_t x = start;
+    for (size_t done = 0; ok && done < bytes; done += chunk) {
+        size_t len = bytes - done < chunk ? bytes - done : chunk;
+        fill(words, len / 4, &x);
+        ok = write_all(f, buf, len);
+    }
+    if (fsync(f) != 0) ok = false;
+    if (close(f) != 0) ok = false;
+
+    // 2. 새로 열어서 읽고 같은 순서로 다시 만든 값과 비교
+    f = ok ? open(path, O_RDONLY) : -1;
+    if (f < 0) ok = false;
+    x = start;
+    for (size_t done = 0; ok && done < bytes; done += chunk) {
+        size_t len = bytes - done < chunk ? bytes - done : chunk;
+        memset(buf, 0, len);
+        if (!read_all(f, buf, len)) {
+            ok = false;
+            break;
+        }
+        for (size_t i = 0; i < len / 4; i++) {
+            if (words[i] != next_word(&x)) {
+                ok = false;
+                break;
+            }
+        }
+    }
+    if (f >= 0) close(f);
+    unlink(path);
+    return ok;
+}
+
+// --- [쓰기 속도] ---
+static bool bench_one(const char *path, void *buf, size_t block, uint64_t bytes, can_sdtest_clock_t now_us,
+                      can_sdtest_result_t *r) {
+    memset(r, 0, sizeof(*r));
+    r->block = block;
+    uint32_t x = (uint32_t)block | 1;
+    fill(buf, block / 4, &x); // 0 이 아닌 데이터 (카드가 0 을 따로 다루는 경우가 있어서)
+
+    uint64_t writes = bytes / block;
+    uint64_t sum_us = 0;
+    int64_t t_start = now_us();
+    int f = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (f < 0) return false;
+    bool ok = true;
+    for (uint64_t i = 0; i < writes; i++) {
+        int64_t t0 = now_us();
+        if (!write_all(f, buf, block)) {
+            ok = false;
+            break;
+        }
+        uint32_t us = (uint32_t)(now_us() - t0);
+        sum_us += us;
+        if (us > r->max_us) r->max_us = us;
+        r->writes++;
+        r->bytes += block;
+    }
+    int64_t t0 = now_us();
+    if (fsync(f) != 0) ok = false;
+    r->fsync_us = (uint32_t)(now_us() - t0);
+    if (close(f) != 0) ok = false;
+    r->total_us = (uint32_t)(now_us() - t_start);
+    unlink(path);
+
+    if (r->writes > 0) r->avg_us = (uint32_t)(sum_us / r->writes);
+    if (r->total_us > 0) r->mb_s = (float)r->bytes / (float)r->total_us;
+    r->ok = ok;
+    return ok;
+}
+
+bool can_sdtest_bench(const char *path, void *buf, size_t buf_size, const size_t *sizes, int n, uint64_t bytes,
+                      can_sdtest_clock_t now_us, can_sdtest_result_t *out) {
+    bool all_ok = true;
+    for (int i = 0; i < n; i++) {
+        if (sizes[i] == 0 || sizes[i] > buf_size || sizes[i] % 4 != 0 || bytes < sizes[i]) {
+            memset(&out[i], 0, sizeof(out[i]));
+            out[i].block = sizes[i];
+            all_ok = false;
+            continue;
+        }
+        if (!bench_one(path, buf, sizes[i], bytes, now_us, &out[i])) all_ok = false;
+    }
+    return all_ok;
+}
+
+// --- [목록 읽기] ---
+int can_sdtest_parse_sizes(const char *list, size_t *out, int max) {
+    int n = 0;
+    const char *p = list;
+    while (*p != '\0') {
+        while (isspace((unsigned char)*p) || *p == ',') p++;
+        if (*p == '\0') break;
+        char *end;
+        unsigned long v = strtoul(p, &end, 0);
+        if (end == p || v == 0 || n >= max) return -1;
+        p = end;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p != ',' && *p != '\0') return -1;
+        out[n++] = (size_t)v;
+    }
+    return n;
+}
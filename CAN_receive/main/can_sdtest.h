@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// --- [SD 카드 확인 / 쓰기 속도 측정] ---
+// 클럭을 올릴 때 "마운트가 됐다" 만으로는 부족함 (선이 길거나 풀업이 약하면 명령은 통하는데 데이터가 깨짐).
+// 그래서 클럭마다 파일을 써서 카드까지 보낸 뒤 (fsync) 다시 읽어 한 바이트씩 비교하고, 틀리면 그 클럭은 안 씀.
+//  - can_sdtest_verify: seed 로 만든 의사 난수 데이터를 bytes 만큼 쓰고 읽어서 비교 (파일은 지움)
+//  - can_sdtest_bench: 블록 크기마다 같은 양을 이어서 쓰고 (로거처럼 한 파일에 write 반복 + 마지막 fsync)
+//    MB/s 와 write 한 번의 시간 (평균 / 최대) 을 잼
+// 버퍼는 호출한 쪽이 줌 (카드로 바로 가도록 DMA 가능한 메모리, 가장 큰 블록 크기 이상).
+// POSIX open/write/read/fsync 만 쓰므로 PC 에서도 같은 코드가 동작 (tools/can_sd_bench)
+
+#define CAN_SDTEST_MAX_SIZES    8
+
+typedef int64_t (*can_sdtest_clock_t)(void);   // 마이크로초 (esp_timer_get_time)
+
+typedef struct {
+    size_t block;           // write 한 번의 크기
+    uint64_t bytes;         // 쓴 양
+    uint32_t writes;
+    uint32_t avg_us;        // write 한 번
+    uint32_t max_us;
+    uint32_t fsync_us;      // 마지막 fsync
+    uint32_t total_us;      // 열기부터 fsync 까지
+    float mb_s;             // bytes / total_us (MB = 10^6 바이트)
+    bool ok;
+} can_sdtest_result_t;
+
+// path 에 bytes 를 쓰고 읽어서 비교. 쓰기/읽기 실패나 다른 바이트가 있으면 false
+bool can_sdtest_verify(const char *path, void *buf, size_t buf_size, size_t bytes, uint32_t seed);
+
+// 블록 크기(sizes[i] <= buf_size)마다 bytes 를 path 에 씀 (블록 크기로 나눠지는 만큼). 측정 후 파일은 지움.
+// 모두 성공하면 true (실패한 크기는 out[i].ok = false)
+bool can_sdtest_bench(const char *path, void *buf, size_t buf_size, const size_t *sizes, int n, uint64_t bytes,
+                      can_sdtest_clock_t now_us, can_sdtest_result_t *out);
+
+// "512,4096,32768" -> 크기 목록. 잘못된 항목이나 0 이 있으면 -1
+int can_sdtest_parse_sizes(const char *list, size_t *out, int max);
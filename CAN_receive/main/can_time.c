@@ -0,0 +1,70 @@
+#include <string.h>
+#include <stdlib.h>
+#include "can_time.h"
+
+#define US_PER_SEC 1000000
+
+void can_time_init(can_time_t *t) {
+    memset(t, 0, sizeof(*t));
+}
+
+// 기준점부터의 경과 시간에 드리프트와 (처음 CAN_TIME_SLEW_US 동안) 오차 흡수분을 더한 값
+static int64_t elapsed_rtc(const can_time_t *t, int64_t local_us) {
+    int64_t d = local_us - t->anchor_local_us;
+    int64_t s = d < 0 ? 0 : d > CAN_TIME_SLEW_US ? CAN_TIME_SLEW_US : d;
+    return d + d * t->drift_ppb / 1000000000 + s * t->slew_ppb / 1000000000;
+}
+
+// 처음이거나 예측이 크게 틀림: 이 에지를 그대로 기준점으로 (드리프트는 수정 특성이므로 유지)
+static void relock(can_time_t *t, int64_t local_us, int64_t rtc_us) {
+    t->anchor_local_us = t->base_local_us = local_us;
+    t->anchor_rtc_us = t->base_rtc_us = rtc_us;
+    t->slew_ppb = 0;
+    t->has_anchor = true;
+    t->edges++;
+    t->steps++;
+}
+
+void can_time_edge(can_time_t *t, int64_t local_us, int64_t rtc_s) {
+    int64_t rtc_us = rtc_s * US_PER_SEC;
+    if (!t->has_anchor) {
+        relock(t, local_us, rtc_us);
+        return;
+    }
+
+    int64_t predicted = t->anchor_rtc_us + elapsed_rtc(t, local_us);
+    int64_t err = rtc_us - predicted;
+    if (llabs(err) > CAN_TIME_STEP_US) {
+        t->last_error_us = (int32_t)(err > INT32_MAX ? INT32_MAX : err < -INT32_MAX ? -INT32_MAX : err);
+        relock(t, local_us, rtc_us);
+        return;
+    }
+    t->edges++;
+    t->last_error_us = (int32_t)err;
+    if ((uint32_t)llabs(err) > t->max_error_us) t->max_error_us = (uint32_t)llabs(err);
+
+    // 드리프트: 처음 에지부터 지금까지 RTC 가 로컬보다 얼마나 더 흘렀나 (구간이 길수록 에지 오차의 영향이 작음)
+    int64_t span = local_us - t->base_local_us;
+    if (span >= CAN_TIME_MIN_BASE_US) {
+        int64_t drift = ((rtc_us - t->base_rtc_us) - span) * 1000000000 / span;
+        if (llabs(drift) <= CAN_TIME_MAX_DRIFT_PPB) t->drift_ppb = (int32_t)drift;
+    }
+
+    // 기준점은 지금까지 내보낸 시각에서 이어 가고, 남은 오차는 CAN_TIME_SLEW_US 동안 흡수
+    t->anchor_local_us = local_us;
+    t->anchor_rtc_us = predicted;
+    t->slew_ppb = (int32_t)(err * 1000000000 / CAN_TIME_SLEW_US);
+}
+
+bool can_time_tick(can_time_t *t, int64_t local_us) {
+    if (!t->has_anchor) return false;
+    int64_t predicted = t->anchor_rtc_us + elapsed_rtc(t, local_us);
+    can_time_edge(t, local_us, (predicted + US_PER_SEC / 2) / US_PER_SEC);
+    return true;
+}
+
+bool can_time_to_rtc(const can_time_t *t, int64_t local_us, int64_t *rtc_us) {
+    if (!t->has_anchor) return false;
+    *rtc_us = t->anchor_rtc_us + elapsed_rtc(t, local_us);
+    return true;
+}
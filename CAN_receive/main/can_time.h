@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- [CAN 로그 시각 (DS3231 + esp_timer)] ---
+// 프레임마다 DS3231 을 I2C 로 읽으면 (트랜잭션 2번, 100 kHz 에서 약 1 ms) 느리고 1초 단위밖에 안 됨.
+// RTC 의 초가 바뀌는 순간(에지)을 esp_timer 로 재서 "로컬 타이머 값 <-> RTC 시각" 기준점을 잡아 두고,
+// 프레임 시각은 esp_timer 값에서 계산합니다 (us 단위, I2C 없음).
+//  - 에지: DS3231 SQW 핀(1 Hz)의 하강 에지, 또는 초 레지스터가 바뀔 때까지 읽어서 찾은 순간 (약 +-0.5 ms)
+//  - 드리프트: ESP32 수정(수십 ppm)과 DS3231 TCXO(+-2 ppm) 의 차이. 첫 에지부터의 긴 구간으로 계산
+//  - 에지마다 남은 오차는 한 번에 맞추지 않고 CAN_TIME_SLEW_US 동안 조금씩 흡수 (시각이 거꾸로 가지 않음)
+//  - 오차가 CAN_TIME_STEP_US 보다 크면 (RTC 를 새로 맞춤 등) 그 자리에서 새로 잡음
+// 시간 단위는 모두 us. local_us 는 esp_timer_get_time(), rtc 는 1970-01-01 기준 (레코드 시각 형식).
+// ESP-IDF 의존성 없음: PC 에서 가짜 에지로 시험 가능 (tools/can_time_sim.c)
+
+#define CAN_TIME_STEP_US        100000      // 예측과 이보다 많이 다르면 새로 잡음
+#define CAN_TIME_SLEW_US        10000000    // 에지에서 남은 오차를 흡수하는 시간
+#define CAN_TIME_MIN_BASE_US    10000000    // 드리프트는 이보다 긴 구간이 모인 뒤부터 계산
+#define CAN_TIME_MAX_DRIFT_PPB  500000      // 이보다 큰 드리프트는 측정 오류로 보고 무시 (500 ppm)
+
+typedef struct {
+    // 기준점: 로컬 타이머가 anchor_local_us 일 때 RTC 는 anchor_rtc_us
+    int64_t anchor_local_us;
+    int64_t anchor_rtc_us;
+    int32_t drift_ppb;          // 로컬 타이머가 느린 정도 (+ 면 로컬 1초 동안 RTC 는 1초보다 더 흐름)
+    int32_t slew_ppb;           // 기준점부터 CAN_TIME_SLEW_US 동안만 더하는 보정
+    bool has_anchor;
+
+    // 드리프트 측정 구간의 시작 (처음 잡거나 새로 잡은 에지)
+    int64_t base_local_us;
+    int64_t base_rtc_us;
+
+    // 통계
+    uint32_t edges;             // 반영한 에지 수
+    uint32_t steps;             // 새로 잡은 횟수 (처음 포함)
+    int32_t last_error_us;      // 마지막 에지에서 예측과 실제의 차이
+    uint32_t max_error_us;      // 처음 잡은 뒤 |오차| 의 최대값 (새로 잡은 에지 제외)
+} can_time_t;
+
+void can_time_init(can_time_t *t);
+
+// RTC 의 초가 rtc_s (1970-01-01 기준 초) 로 바뀐 순간의 로컬 시각
+void can_time_edge(can_time_t *t, int64_t local_us, int64_t rtc_s);
+
+// 몇 초인지 모르는 에지 (SQW). 예측에서 가장 가까운 정각으로 반영. 아직 기준이 없으면 false
+bool can_time_tick(can_time_t *t, int64_t local_us);
+
+// 로컬 시각 -> RTC 시각. 아직 기준이 없으면 false (*rtc_us 는 그대로)
+bool can_time_to_rtc(const can_time_t *t, int64_t local_us, int64_t *rtc_us);
@@ -1,15 +1,33 @@
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
+#include <time.h>
 #include <sys/unistd.h>
 #include <sys/stat.h>
+#include "sdkconfig.h"
 #include "esp_vfs_fat.h"
 #include "sdmmc_cmd.h"
+#if CONFIG_CAN_SD_SDMMC
+#include "driver/sdmmc_host.h"
+#if !SOC_SDMMC_USE_GPIO_MATRIX
+#include "soc/sdmmc_pins.h"
+#endif
+#endif
+#include "esp_heap_caps.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "driver/i2c.h" 
 #include "driver/gpio.h"
 #include "driver/twai.h" // 여기가 핵심: can.h 대신 twai.h 사용
+#include "esp_timer.h"
+#include "can_log.h"
+#include "can_record.h"
+#include "can_ring.h"
+#include "can_dbc.h"
+#include "can_time.h"
+#include "can_filter.h"
+#include "can_sdtest.h"
 
 // 로그 태그
 static const char *TAG = "TWAI_Receive";
@@ -25,19 +43,30 @@ static const char *TAG = "TWAI_Receive";
 #define I2C_MASTER_NUM              0     // I2C 포트 번호 (0 또는 1)
 #define I2C_MASTER_FREQ_HZ          100000 // 통신 속도 (100kHz)
 #define DS3231_ADDR                 0x68  // DS3231의 I2C 주소
-
-//SD카드 핀
-#define SD_PIN_CS       GPIO_NUM_4
-#define SD_PIN_MOSI     GPIO_NUM_5
-#define SD_PIN_CLK      GPIO_NUM_6
-#define SD_PIN_MISO     GPIO_NUM_7
+#define DS3231_REG_SEC              0x00  // 초 (여기서부터 7바이트가 시각)
+#define DS3231_REG_CONTROL          0x0E  // 제어: INTCN(bit2)=0, RS2:RS1(bit4:3)=00 이면 SQW 핀에 1 Hz
+
+//SD카드 핀 (menuconfig: SPI 면 CMD = MOSI, D0 = MISO, D3 = CS)
+#define SD_PIN_CLK      CONFIG_CAN_SD_PIN_CLK
+#define SD_PIN_CMD      CONFIG_CAN_SD_PIN_CMD
+#define SD_PIN_D0       CONFIG_CAN_SD_PIN_D0
+#define SD_PIN_D3       CONFIG_CAN_SD_PIN_D3
+// GPIO 매트릭스가 없는 SDMMC (ESP32) 는 슬롯 1 의 고정 핀만 씀 (위 설정 값은 무시됨)
+#if CONFIG_CAN_SD_SDMMC && !SOC_SDMMC_USE_GPIO_MATRIX
+#define SD_BUS_PIN_D3   SDMMC_SLOT1_IOMUX_PIN_NUM_D3
+#else
+#define SD_BUS_PIN_D3   SD_PIN_D3
+#endif
 
 // 파일 시스템 마운트 지점
 #define MOUNT_POINT "/sdcard"
 
+#define LOG_STATS_PERIOD_MS 10000 // SD 쓰기 통계 출력 간격
+
 // --- [전역 변수] ---
-// 파일 이름을 저장할 공간 (예: 20260111_123000.csv)
-char current_filename[64] = {0};
+// 파일 이름을 저장할 공간 (예: 20260111_123000.can)
+char current_filename[CAN_LOG_PATH_LEN] = {0};
+static int64_t segment_hour = -1; // 지금 파일을 시작한 시각 (1970 기준 몇 번째 시간)
 
 // --- [유틸리티] BCD 변환 함수 ---
 // RTC는 데이터를 10진수가 아닌 BCD(Binary Coded Decimal) 포맷으로 저장합니다.
@@ -59,43 +88,263 @@ void i2c_master_init();
 void set_time(int year, int month, int day, int hour, int min, int sec);
 void get_time(int *year, int *month, int *day, int *hour, int *min, int *sec);
 esp_err_t init_sd_card();
-void write_to_sd(const char *data);
+bool write_to_sd(const void *data, size_t len);
+bool log_record(const can_record_t *rec);
+int64_t rtc_time_us();
+esp_err_t rtc_read_reg(uint8_t reg, uint8_t *data, size_t len);
+esp_err_t rtc_write_reg(uint8_t reg, uint8_t value);
 void create_new_filename();
+void segment_filename(char *path, size_t size);
+void print_frame(const can_record_t *rec);
+void load_signal_db(bool sd_ok);
+void make_rx_filter(twai_filter_config_t *f_config);
+void print_log_stats();
+void rtc_clock_init();
+
+// --- [수신 파이프라인] ---
+// CAN 수신 태스크(높은 우선순위) -> 레코드 링 -> 기록 루프(app_main) -> 핑퐁 버퍼 -> SD 쓰기 태스크
+// SD 카드가 FAT 할당 등으로 100 ms 넘게 멈춰도 수신 태스크는 링에 넣기만 하므로 TWAI 큐가 넘치지 않음.
+// 링이 차면 그 프레임만 버리고 센다 (드라이버 큐/하드웨어 FIFO 넘침은 twai_get_status_info 로 따로 셈)
+#define CAN_RX_TASK_PRIO    12
+#define SD_WRITE_TASK_PRIO  3   // 기록 루프(app_main, 1)보다 높게: 버퍼가 넘어오면 바로 카드로 (카드를 기다리는 동안은 잠듦)
+#define TWAI_RX_QUEUE_LEN   64  // 드라이버 큐 (수신 태스크가 링으로 옮기는 동안만 버티면 됨)
+#define LOG_POLL_MS         10  // 프레임이 없어도 이 간격으로 시간 flush 확인
+#define CONSOLE_MAX_LINES   20  // 초당 화면 출력 줄 수 (버스가 바쁘면 printf 가 기록을 늦추므로)
+#define SEGMENT_ALLOC_PRIO  1   // 다음 로그 파일 미리 잡기: 가장 낮게, 조각마다 양보 (SD 쓰기 태스크가 먼저)
+#define SEGMENT_RETRY_MS    5000 // 준비됐거나 실패했을 때 다시 볼 간격
+
+static can_record_t rx_slots[CONFIG_CAN_RX_RING_SIZE];
+// can_ring 은 2의 거듭제곱 크기만 받음 (아니면 init 이 실패해서 모든 프레임이 버려짐) -> 빌드에서 막음
+_Static_assert((CONFIG_CAN_RX_RING_SIZE & (CONFIG_CAN_RX_RING_SIZE - 1)) == 0,
+               "CONFIG_CAN_RX_RING_SIZE must be a power of two");
+static can_ring_t rx_ring;
+static TaskHandle_t log_task;   // 링을 비우는 기록 루프 (app_main)
+static TaskHandle_t sd_task;
+static uint32_t console_skipped; // 출력 줄 수 제한으로 화면에 안 찍은 프레임
+
+// 수신 태스크: 받아서 시각만 찍고 링으로 (I2C/printf/SD 없음)
+static void can_rx_task(void *arg) {
+    twai_message_t msg;
+    while (1) {
+        if (twai_receive(&msg, portMAX_DELAY) != ESP_OK) continue;
+
+        can_record_t rec = {
+            .time_us = esp_timer_get_time(), // 받은 순간 (기록 루프에서 RTC 시각으로 바꿈)
+            .id = msg.identifier,
+            .flags = (msg.extd ? CAN_REC_EXTD : 0) | (msg.rtr ? CAN_REC_RTR : 0),
+            .dlc = msg.data_length_code,
+        };
+        memcpy(rec.data, msg.data, rec.dlc < 8 ? rec.dlc : 8);
+        // 링이 비어 있었으면 기록 루프가 자고 있으므로 깨움
+        bool was_empty = can_ring_count(&rx_ring) == 0;
+        if (can_ring_push(&rx_ring, &rec) && was_empty) xTaskNotifyGive(log_task);
+    }
+}
+
+// SD 쓰기 태스크: 꽉 찬(또는 flush 할) 버퍼를 카드에 쓰고, 버퍼가 비었다고 기록 루프에 알림
+static void sd_write_task(void *arg) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (can_log_service()) {
+            if (log_task != NULL) xTaskNotifyGive(log_task);
+        }
+    }
+}
+
+static void kick_sd_task(void) {
+    xTaskNotifyGive(sd_task);
+}
+
+// 다음 로그 파일을 미리 잡아 두는 태스크: 버퍼 하나 크기씩 0 으로 채우고 한 틱 쉼
+static void segment_alloc_task(void *arg) {
+    while (1) {
+        if (can_log_prepare()) vTaskDelay(1);
+        else vTaskDelay(pdMS_TO_TICKS(SEGMENT_RETRY_MS));
+    }
+}
+
+// --- [시각 기준: DS3231 초 에지 + esp_timer] ---
+// RTC 의 초가 바뀌는 순간을 부팅 때 한 번 잡아 두고, 프레임 시각은 esp_timer 값에서 계산 (can_time.h).
+//  - SQW 핀 연결 (CONFIG_CAN_RTC_SQW_GPIO): 매초 하강 에지를 ISR 에서 기록해서 맞춤.
+//    I2C 는 CONFIG_CAN_RTC_RESYNC_S 마다 몇 초인지 확인할 때만
+//  - SQW 없음: CONFIG_CAN_RTC_RESYNC_S 마다 예측한 에지 조금 전부터 초 레지스터를 읽어서 에지를 찾음
+// 부팅이 끝난 뒤에는 I2C 를 이 태스크만 씀 (다른 곳은 부팅 중에만 RTC 를 읽고 씀)
+#define RTC_SYNC_TASK_PRIO      2
+#define RTC_EDGE_MARGIN_MS      20      // 예측한 에지보다 이만큼 먼저 읽기 시작
+#define RTC_EDGE_TIMEOUT_US     1100000 // 이 시간 안에 초가 안 바뀌면 실패 (RTC 가 멈춤/없음)
+#define RTC_SQW_TIMEOUT_MS      1500    // SQW 에지가 이만큼 안 오면 읽어서 찾는 방식으로
+
+static portMUX_TYPE clock_lock = portMUX_INITIALIZER_UNLOCKED; // clock_model 과 SQW 기록 보호
+static can_time_t clock_model;
+static int64_t isr_edge_us;     // 마지막 SQW 하강 에지 (clock_lock 으로 보호)
+static TaskHandle_t rtc_task;
+static bool sqw_ok;             // SQW 에지가 들어오고 있음
+
+static void IRAM_ATTR sqw_isr(void *arg) {
+    int64_t now = esp_timer_get_time(); // 최대한 먼저 기록
+    BaseType_t woken = pdFALSE;
+    portENTER_CRITICAL_ISR(&clock_lock);
+    isr_edge_us = now;
+    portEXIT_CRITICAL_ISR(&clock_lock);
+    if (rtc_task != NULL) vTaskNotifyGiveFromISR(rtc_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
 
+// 초 레지스터가 바뀔 때까지 읽어서 바뀐 순간을 찾음: 바뀌기 전/후 읽기 시각의 가운데 (읽기 한 번 약 0.5 ms)
+static bool find_rtc_edge(int64_t *edge_us, int64_t *rtc_s) {
+    uint8_t first, sec;
+    int64_t t0 = esp_timer_get_time();
+    if (rtc_read_reg(DS3231_REG_SEC, &first, 1) != ESP_OK) return false;
+    int64_t prev = (t0 + esp_timer_get_time()) / 2, limit = t0 + RTC_EDGE_TIMEOUT_US;
+    while (esp_timer_get_time() < limit) {
+        t0 = esp_timer_get_time();
+        if (rtc_read_reg(DS3231_REG_SEC, &sec, 1) != ESP_OK) return false;
+        int64_t mid = (t0 + esp_timer_get_time()) / 2;
+        if (sec != first) {
+            *edge_us = (prev + mid) / 2;
+            *rtc_s = rtc_time_us() / 1000000; // 방금 바뀌었으므로 같은 초 안에 읽힘
+            return true;
+        }
+        prev = mid;
+    }
+    return false;
+}
+
+static void clock_edge(int64_t edge_us, int64_t rtc_s) {
+    portENTER_CRITICAL(&clock_lock);
+    can_time_edge(&clock_model, edge_us, rtc_s);
+    portEXIT_CRITICAL(&clock_lock);
+}
+
+static bool clock_snapshot(can_time_t *out) {
+    portENTER_CRITICAL(&clock_lock);
+    *out = clock_model;
+    portEXIT_CRITICAL(&clock_lock);
+    return out->has_anchor;
+}
+
+// SQW 없이: 다음 에지 조금 전까지 자다가 읽어서 찾음
+static void resync_by_polling(void) {
+    can_time_t snap;
+    int64_t now_rtc;
+    if (clock_snapshot(&snap) && can_time_to_rtc(&snap, esp_timer_get_time(), &now_rtc)) {
+        int wait_ms = (int)((1000000 - now_rtc % 1000000) / 1000) - RTC_EDGE_MARGIN_MS;
+        if (wait_ms > 0) vTaskDelay(pdMS_TO_TICKS(wait_ms));
+    }
+    int64_t edge_us, rtc_s;
+    if (find_rtc_edge(&edge_us, &rtc_s)) clock_edge(edge_us, rtc_s);
+    else ESP_LOGW(TAG, "RTC second edge not found (I2C?)");
+}
+
+static void rtc_sync_task(void *arg) {
+    int64_t last_check_us = esp_timer_get_time();
+    while (1) {
+        if (!sqw_ok) {
+            vTaskDelay(pdMS_TO_TICKS(CONFIG_CAN_RTC_RESYNC_S * 1000));
+            resync_by_polling();
+            if (CONFIG_CAN_RTC_SQW_GPIO < 0) continue;
+        }
+        // SQW: 에지마다 반영, RESYNC_S 마다 RTC 를 읽어 몇 초인지 확인 (에지를 놓쳤어도 여기서 맞음)
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RTC_SQW_TIMEOUT_MS)) == 0) {
+            if (sqw_ok) ESP_LOGW(TAG, "No SQW edge from RTC, falling back to polling");
+            sqw_ok = false;
+            continue;
+        }
+        sqw_ok = true;
+        portENTER_CRITICAL(&clock_lock);
+        int64_t edge_us = isr_edge_us;
+        portEXIT_CRITICAL(&clock_lock);
+
+        if (edge_us - last_check_us >= CONFIG_CAN_RTC_RESYNC_S * 1000000LL) {
+            last_check_us = edge_us;
+            clock_edge(edge_us, rtc_time_us() / 1000000); // 에지 직후라 같은 초 안에 읽힘
+        } else {
+            portENTER_CRITICAL(&clock_lock);
+            can_time_tick(&clock_model, edge_us);
+            portEXIT_CRITICAL(&clock_lock);
+        }
+    }
+}
+
+// 부팅 때 한 번: 에지를 찾아 기준점을 잡고 (최대 1초), SQW 설정 후 동기화 태스크 시작
+void rtc_clock_init() {
+    can_time_init(&clock_model);
+    int64_t edge_us, rtc_s;
+    if (find_rtc_edge(&edge_us, &rtc_s)) {
+        clock_edge(edge_us, rtc_s);
+        ESP_LOGI(TAG, "Timebase locked to RTC second edge");
+    } else {
+        ESP_LOGE(TAG, "RTC second edge not found: frame times are time since boot");
+    }
+
+#if CONFIG_CAN_RTC_SQW_GPIO >= 0
+    // 1 Hz 출력 켜기 (나머지 비트는 그대로). 하강 에지가 초가 바뀌는 순간
+    uint8_t ctrl;
+    if (rtc_read_reg(DS3231_REG_CONTROL, &ctrl, 1) == ESP_OK &&
+        rtc_write_reg(DS3231_REG_CONTROL, ctrl & ~0x1C) == ESP_OK) {
+        const gpio_config_t io = {
+            .pin_bit_mask = 1ULL << CONFIG_CAN_RTC_SQW_GPIO,
+            .mode = GPIO_MODE_INPUT,
+            .pull_up_en = GPIO_PULLUP_ENABLE, // SQW 는 오픈 드레인
+            .intr_type = GPIO_INTR_NEGEDGE,
+        };
+        esp_err_t err = gpio_config(&io);
+        if (err == ESP_OK) {
+            err = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+            if (err == ESP_ERR_INVALID_STATE) err = ESP_OK; // 이미 설치됨
+        }
+        if (err == ESP_OK) err = gpio_isr_handler_add(CONFIG_CAN_RTC_SQW_GPIO, sqw_isr, NULL);
+        if (err == ESP_OK) {
+            sqw_ok = true;
+            ESP_LOGI(TAG, "RTC SQW input: GPIO %d", CONFIG_CAN_RTC_SQW_GPIO);
+        } else {
+            ESP_LOGW(TAG, "SQW GPIO setup failed (%s), polling instead", esp_err_to_name(err));
+        }
+    }
+#endif
+    xTaskCreate(rtc_sync_task, "rtc_sync", 3072, NULL, RTC_SYNC_TASK_PRIO, &rtc_task);
+}
 
 void app_main(void)
 {
+    log_task = xTaskGetCurrentTaskHandle();
+    can_ring_init(&rx_ring, rx_slots, CONFIG_CAN_RX_RING_SIZE);
+    xTaskCreate(sd_write_task, "sd_write", 4096, NULL, SD_WRITE_TASK_PRIO, &sd_task);
+
     //I2C 초기화
     i2c_master_init();
     ESP_LOGI(TAG, "I2C Initialized");
 
     // 2. SD 카드 초기화
-    if (init_sd_card() != ESP_OK) {
+    bool sd_ok = init_sd_card() == ESP_OK;
+    if (!sd_ok) {
         ESP_LOGE(TAG, "SD Card Init Failed! System Halted.");
         // SD 없으면 멈추게 하려면 return; 추가
     } else {
-        // 부팅 로그 남기기
-        write_to_sd("SYSTEM_START, Power On Reset\n");
-        // 3. [핵심] 부팅 직후 파일 이름 생성!
+        // 3. [핵심] 부팅 직후 파일 이름 생성 + 파일 열기 (머리말은 파일마다 can_log 가 맨 앞에 넣음)
         create_new_filename();
-        
-        // 헤더(제목) 쓰기
-        write_to_sd("TimeStamp, Sensor_Type, Data1, Data2, Data3\n");
+
+        // 부팅 기록 (CSV 제목 줄은 PC 변환기가 붙임)
+        can_record_t boot = { .time_us = rtc_time_us(), .id = CAN_EVENT_BOOT, .flags = CAN_REC_EVENT };
+        log_record(&boot);
+        can_log_sync(); // 여기까지는 바로 카드에
     }
 
+    // 화면 출력용 신호 표 (SD 카드의 .dbc 파일, 없으면 기본 표)
+    load_signal_db(sd_ok);
+
     // 2. 시간 설정 (컴파일 시간을 받아서 저장/ 기존시간이 더 최신이면 건너뜀)
     set_time_smart();
 
-    //3. 시간 저장을 위한 변수 선언
-    int year, month, day, hour, min, sec;
-
-    //파일 저장용 문자열 버퍼
-    char csv_buffer[128]; // 파일 저장용 문자열 버퍼
+    // 시각 기준 잡기 (이후로 프레임마다 RTC 를 읽지 않음)
+    rtc_clock_init();
 
     // 1. 설정 구조체 초기화 (TWAI 접두어 사용)
     twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(TX_GPIO_NUM, RX_GPIO_NUM, TWAI_MODE_NORMAL);
+    g_config.rx_queue_len = TWAI_RX_QUEUE_LEN;
     twai_timing_config_t t_config = TWAI_TIMING_CONFIG_500KBITS(); // 속도 500kbps
     twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL(); // 모든 ID 수신
+    make_rx_filter(&f_config); // CONFIG_CAN_RX_FILTER_IDS 가 있으면 그 ID 만
 
     // 2. 드라이버 설치
     if (twai_driver_install(&g_config, &t_config, &f_config) == ESP_OK) {
@@ -112,79 +361,150 @@ void app_main(void)
         ESP_LOGE(TAG, "Failed to start driver");
         return;
     }
+    xTaskCreate(can_rx_task, "can_rx", 3072, NULL, CAN_RX_TASK_PRIO, NULL);
 
     while (1) {
         //===========================================
-        // [수신] 메시지 받기 (큐에 있는 것 모두 처리)
+        // [기록] 링에 쌓인 프레임을 모두 버퍼로 옮김
         // ==========================================
-        twai_message_t rx_msg;
-        
-        // while문을 써서 쌓여있는 메시지를 빠르게 다 읽어옵니다.
-        while (twai_receive(&rx_msg, pdMS_TO_TICKS(10)) == ESP_OK) {
-            get_time(&year, &month, &day, &hour, &min, &sec); //시간 갱신
-
-            // 2. ID에 따라 데이터 해석 및 출력
-            switch (rx_msg.identifier) {
-                
-                // [CASE A] 버튼 (0x100)
-                case 0x100:
-                    printf("--------------------------------------------------\n");
-                    printf("[%02d:%02d:%02d] 🔘 EVENT: Button Clicked!\n", hour, min, sec);
-                    printf("--------------------------------------------------\n");
-                    sprintf(csv_buffer, "%04d-%02d-%02d %02d:%02d:%02d, BUTTON, Clicked\n", 
-                            year, month, day, hour, min, sec);
-                    write_to_sd(csv_buffer);
-                    break;
-
-                // [CASE B] 온습도 (0x200)
-                case 0x200:
-                    if (rx_msg.data_length_code >= 2) {
-                        int temp = rx_msg.data[0];
-                        int hum = rx_msg.data[1];
-                        // 한 줄로 깔끔하게 출력
-                        printf("[%02d:%02d:%02d] 🌡️ DHT11 | Temp: %2d°C  Hum: %2d%%\n", hour, min, sec, temp, hum);
-                        sprintf(csv_buffer, "%04d-%02d-%02d %02d:%02d:%02d, DHT11, Temp:%d, Hum:%d\n", 
-                                year, month, day, hour, min, sec, temp, hum);
-                        write_to_sd(csv_buffer);
-                    }
-                    break;
-
-                // [CASE C] MPU6500 가속도 (0x300)
-                case 0x300:
-                    if (rx_msg.data_length_code == 6) {
-                        // 1. 데이터 합치기
-                        int16_t raw_ax = (int16_t)((rx_msg.data[0] << 8) | rx_msg.data[1]);
-                        int16_t raw_ay = (int16_t)((rx_msg.data[2] << 8) | rx_msg.data[3]);
-                        int16_t raw_az = (int16_t)((rx_msg.data[4] << 8) | rx_msg.data[5]);
-
-                        // 2. 사람이 보기 편하게 변환 (나누기 16384)
-                        float ax_g = raw_ax / 16384.0;
-                        float ay_g = raw_ay / 16384.0;
-                        float az_g = raw_az / 16384.0;
-
-                        // 3. 소수점 2자리까지 출력
-                        printf("[%02d:%02d:%02d] 🚀 Accel | X: %.2f g  Y: %.2f g  Z: %.2f g\n", 
-                            hour, min, sec, ax_g, ay_g, az_g);
-
-                        // CSV 저장 (숫자만 콤마로 구분하면 엑셀에서 보기 편함)
-                        sprintf(csv_buffer, "%04d-%02d-%02d %02d:%02d:%02d, ACCEL, %.2f, %.2f, %.2f\n", 
-                                year, month, day, hour, min, sec, ax_g, ay_g, az_g);
-                        write_to_sd(csv_buffer);
-                    }
-                    break;
-
-                default:
-                    // 알 수 없는 ID가 들어왔을 때
-                    printf("[%02d:%02d:%02d] UNKNOWN ID: 0x%lx Len: %d\n", hour, min, sec, rx_msg.identifier, rx_msg.data_length_code);
-                    break;
-            }
+        // 새 프레임이 들어오거나 SD 버퍼가 비면 깨어남 (아니면 LOG_POLL_MS 마다)
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_POLL_MS));
+
+        // 이번에 옮길 프레임은 모두 같은 기준으로 (잠금은 한 번만)
+        can_time_t clock;
+        bool clock_ok = clock_snapshot(&clock);
+
+        const can_record_t *rx;
+        while ((rx = can_ring_peek(&rx_ring)) != NULL) {
+            can_record_t rec = *rx;
+            int64_t rtc_us;
+            // 받은 순간의 esp_timer 값 -> RTC 시각 (기준을 못 잡았으면 부팅 후 시간 그대로)
+            if (clock_ok && can_time_to_rtc(&clock, rx->time_us, &rtc_us)) rec.time_us = (uint64_t)rtc_us;
+
+            // 두 버퍼가 모두 카드로 가는 중: 링에 남겨 두고 SD 쓰기 태스크가 깨워 줄 때까지
+            if (!log_record(&rec)) break;
+            can_ring_pop(&rx_ring);
+
+            print_frame(&rec);
+            can_log_on_id(rec.id); // 이벤트 ID(버튼 등)면 바로 카드에 씀
+        }
+
+#if CONFIG_CAN_LOG_ROTATE_HOURLY
+        // 정시를 넘으면 다음 파일로 (크기로 넘어가는 것은 can_log 가 알아서). 버퍼가 바쁘면 다음 바퀴에
+        int64_t now_rtc_us;
+        if (clock_ok && segment_hour >= 0 && can_time_to_rtc(&clock, esp_timer_get_time(), &now_rtc_us) &&
+            now_rtc_us / 3600000000LL != segment_hour) {
+            can_log_rotate();
         }
+#endif
 
-        // 0.1초 대기
-        vTaskDelay(pdMS_TO_TICKS(10));
+        // 시간이 됐으면 버퍼에 쌓인 것을 카드에 씀 + 통계 출력
+        can_log_poll();
+        print_log_stats();
     }
 }
 
+// --- [신호 표] ---
+// 화면에 찍을 때 ID 별로 어떤 신호가 어디에 있는지. SD 카드에 CONFIG_CAN_DBC_FILE (.dbc) 이 있으면 그 파일을,
+// 없으면 can_record.c 의 기본 표 (tools/can_log2csv 도 같은 표로 CSV 를 만듦). ID 를 늘릴 때는 표에 줄만 추가
+static can_dbc_t signal_db;
+
+void load_signal_db(bool sd_ok) {
+    if (!can_dbc_init(&signal_db, CONFIG_CAN_DBC_MAX_MESSAGES, CONFIG_CAN_DBC_MAX_SIGNALS)) {
+        ESP_LOGE(TAG, "Signal table: out of memory");
+        return;
+    }
+    int n = -1;
+    if (sd_ok && strlen(CONFIG_CAN_DBC_FILE) > 0) {
+        n = can_dbc_load_file(&signal_db, MOUNT_POINT "/" CONFIG_CAN_DBC_FILE);
+    }
+    if (n >= 0) {
+        ESP_LOGI(TAG, "Signal table: %s, %d messages, %d signals (%lu skipped)", CONFIG_CAN_DBC_FILE,
+                 signal_db.num_messages, signal_db.num_signals, (unsigned long)signal_db.skipped);
+    } else {
+        can_dbc_load_table(&signal_db, can_record_signals, can_record_num_signals);
+        ESP_LOGI(TAG, "Signal table: built-in, %d messages", signal_db.num_messages);
+    }
+    can_dbc_build(&signal_db);
+}
+
+// --- [수신 필터] ---
+// CONFIG_CAN_RX_FILTER_IDS ("0x100,0x200-0x2FF") 를 하드웨어 필터 하나 또는 둘로 바꿈.
+// 필터가 통과시킨 원하지 않는 ID 는 그대로 기록됨 (하드웨어가 덜 걸러 준 만큼 ISR/링 부하만 늘어남)
+void make_rx_filter(twai_filter_config_t *f_config) {
+    if (strlen(CONFIG_CAN_RX_FILTER_IDS) == 0) {
+        ESP_LOGI(TAG, "RX filter: accept all");
+        return;
+    }
+    can_filter_range_t ranges[CAN_FILTER_MAX_RANGES];
+    bool extd = false; // bool 설정이 n 이면 sdkconfig.h 에 아예 없으므로 #if 로
+#if CONFIG_CAN_RX_FILTER_EXTENDED
+    extd = true;
+#endif
+    int n = can_filter_parse(CONFIG_CAN_RX_FILTER_IDS, extd, ranges, CAN_FILTER_MAX_RANGES);
+    can_filter_plan_t plan;
+    if (n <= 0 || !can_filter_plan(ranges, n, extd, &plan)) {
+        ESP_LOGW(TAG, "RX filter: bad ID list \"%s\", accept all", CONFIG_CAN_RX_FILTER_IDS);
+        return;
+    }
+    f_config->acceptance_code = plan.acceptance_code;
+    f_config->acceptance_mask = plan.acceptance_mask;
+    f_config->single_filter = plan.single_filter;
+    ESP_LOGI(TAG, "RX filter: %s, code 0x%08lx mask 0x%08lx, %llu wanted / %llu accepted IDs (false accept %.1f%%)",
+             plan.single_filter ? "single" : "dual", (unsigned long)plan.acceptance_code,
+             (unsigned long)plan.acceptance_mask, (unsigned long long)plan.wanted, (unsigned long long)plan.accepted,
+             plan.false_accept * 100);
+}
+
+// --- [화면 출력] ---
+// 신호 표로 해석해서 출력 (신호 없는 이벤트 메시지는 항상, 나머지는 초당 CONSOLE_MAX_LINES 줄까지).
+// 로그 루프 (app_main) 에서만 부르므로 큰 버퍼는 static 으로 (기본 main 태스크 스택 3.5 KB 에 올리지 않음)
+void print_frame(const can_record_t *rec) {
+    static int64_t window_start_us;
+    static int lines;
+    int64_t now = esp_timer_get_time();
+    if (now - window_start_us >= 1000000) {
+        window_start_us = now;
+        lines = 0;
+    }
+    const can_dbc_message_t *m = can_dbc_find(&signal_db, rec->id, (rec->flags & CAN_REC_EXTD) != 0);
+    bool event = m != NULL && m->num_signals == 0;
+    if (!event && lines >= CONSOLE_MAX_LINES) {
+        console_skipped++;
+        return;
+    }
+    lines++;
+
+    int64_t t = (int64_t)(rec->time_us / 1000000);
+    int hour = (int)(t % 86400 / 3600), min = (int)(t % 3600 / 60), sec = (int)(t % 60);
+    int ms = (int)(rec->time_us / 1000 % 1000);
+
+    if (m == NULL) {
+        // 표에 없는 ID
+        printf("[%02d:%02d:%02d.%03d] UNKNOWN ID: 0x%lx Len: %d\n", hour, min, sec, ms,
+               (unsigned long)rec->id, rec->dlc);
+        return;
+    }
+    if (event) {
+        printf("--------------------------------------------------\n");
+        printf("[%02d:%02d:%02d.%03d] 🔘 EVENT: %s\n", hour, min, sec, ms, m->name);
+        printf("--------------------------------------------------\n");
+        return;
+    }
+
+    // 한 줄로: [시각] 메시지 | 신호: 값 단위 ...  (DLC 가 짧아 담기지 않은 신호는 빼고, 하나도 없으면 생략)
+    static float values[CAN_DBC_MAX_MSG_SIGNALS];
+    static char line[256];
+    if (can_dbc_decode(&signal_db, m, rec->data, rec->dlc, values) == 0) return;
+    int n = snprintf(line, sizeof(line), "[%02d:%02d:%02d.%03d] %s |", hour, min, sec, ms, m->name);
+    const can_dbc_signal_t *sig = &signal_db.signals[m->first_signal];
+    for (int i = 0; i < m->num_signals && n < (int)sizeof(line); i++) {
+        if (isnan(values[i])) continue;
+        n += snprintf(line + n, sizeof(line) - n, " %s: %.*f%s", sig[i].name, sig[i].decimals, values[i], sig[i].unit);
+    }
+    printf("%s\n", line);
+}
+
 // 월(Month) 문자열을 숫자로 변환하는 도우미 함수
 int get_month_number(const char *m) {
     if (strncmp(m, "Jan", 3) == 0) return 1;
@@ -337,63 +657,320 @@ void get_time(int *year, int *month, int *day, int *hour, int *min, int *sec) {
 // [SD 카드 관련 함수]
 // ====================================================
 // [핵심 함수] 파일 이름 생성기
-void create_new_filename() {
-    int year, month, day, hour, min, sec;
-    
-    // 1. 현재 RTC 시간 읽기
-    get_time(&year, &month, &day, &hour, &min, &sec);
-
-    // 2. 파일 이름 생성 (형식: /sdcard/YYYYMMDD_HHMMSS.csv)
-    // 예: /sdcard/20260111_153000.csv
-    sprintf(current_filename, "%s/%04d%02d%02d_%02d%02d%02d.csv", 
-            MOUNT_POINT, year, month, day, hour, min, sec);
-            
-    ESP_LOGI(TAG, "New Log File Created: %s", current_filename);
+// 로그 파일 이름 = 시작 시각 (형식: /sdcard/YYYYMMDD_HHMMSS.can, 바이너리 레코드)
+// 예: /sdcard/20260111_153000.can. 다음 파일로 넘어갈 때마다 can_log 가 다시 부름.
+// 같은 초에 두 번 넘어가면 (크기가 차는 것과 정시가 겹침) 이름이 같아져서 방금 닫은 파일을 덮어쓰므로
+// 두 번째부터는 _1, _2 ... 를 붙임 (20260111_153000_1.can)
+void segment_filename(char *path, size_t size) {
+    static int64_t last_second = -1;
+    static int same_second = 0;
+
+    // 시각 기준이 잡혔으면 esp_timer 로 (I2C 없음), 아니면 RTC 를 읽어서
+    int64_t now_us = 0;
+    can_time_t clock;
+    if (!clock_snapshot(&clock) || !can_time_to_rtc(&clock, esp_timer_get_time(), &now_us)) now_us = rtc_time_us();
+
+    time_t t = (time_t)(now_us / 1000000);
+    struct tm tm;
+    gmtime_r(&t, &tm); // RTC 시각을 그대로 1970 기준으로 저장했으므로 시간대 변환 없이
+    same_second = t == last_second ? same_second + 1 : 0;
+    last_second = t;
+    char suffix[8] = "";
+    if (same_second > 0) snprintf(suffix, sizeof(suffix), "_%d", same_second);
+    snprintf(path, size, "%s/%04d%02d%02d_%02d%02d%02d%s.can", MOUNT_POINT, tm.tm_year + 1900, tm.tm_mon + 1,
+             tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, suffix);
+
+    // 화면/통계용 이름과 정시 확인용 시간 (둘 다 기록 루프에서만 씀)
+    snprintf(current_filename, sizeof(current_filename), "%s", path);
+    segment_hour = now_us / 3600000000LL;
+    ESP_LOGI(TAG, "New Log File Created: %s", path);
 }
 
-esp_err_t init_sd_card() {
-    esp_vfs_fat_sdmmc_mount_config_t mount_config = {
-        .format_if_mount_failed = false, // 포맷 안 함 (중요 데이터를 위해 false 추천)
-        .max_files = 5,
-        .allocation_unit_size = 16 * 1024
-    };
-    sdmmc_card_t *card;
-    
-    // SPI 버스 설정
-    spi_bus_config_t bus_cfg = {
-        .mosi_io_num = SD_PIN_MOSI,
-        .miso_io_num = SD_PIN_MISO,
-        .sclk_io_num = SD_PIN_CLK,
-        .quadwp_io_num = -1,
-        .quadhd_io_num = -1,
-        .max_transfer_sz = 4000,
+void create_new_filename() {
+    // 1. 현재 RTC 시간으로 파일 이름 생성
+    char path[CAN_LOG_PATH_LEN];
+    segment_filename(path, sizeof(path));
+
+    // 2. 파일은 한 번만 열어 두고 버퍼에 모아서 씀 (쓰기 정책은 menuconfig).
+    //    CONFIG_CAN_LOG_SEGMENT_MB 마다 (그리고 정시마다) 미리 잡아 둔 다음 파일로 넘어감
+    static can_record_header_t header; // 파일마다 맨 앞에
+    can_record_header_init(&header);
+    can_log_policy_t policy = {
+        .flush_ms = CONFIG_CAN_LOG_FLUSH_MS,
+        .segment_size = (uint64_t)CONFIG_CAN_LOG_SEGMENT_MB * 1024 * 1024,
+        .segment_dir = MOUNT_POINT,
+        .name = segment_filename,
+        .preamble = &header,
+        .preamble_len = sizeof(header),
     };
-    // SPI 버스 초기화 (SPI2_HOST 사용)
-    esp_err_t ret = spi_bus_initialize(SPI2_HOST, &bus_cfg, SPI_DMA_CH_AUTO);
-    if (ret != ESP_OK) return ret;
+    can_log_parse_ids(&policy, CONFIG_CAN_LOG_FLUSH_IDS);
+    if (!can_log_open(path, &policy, kick_sd_task)) {
+        ESP_LOGE(TAG, "Failed to open file: %s", path);
+        current_filename[0] = '\0';
+        return;
+    }
+    if (policy.segment_size > 0) {
+        xTaskCreate(segment_alloc_task, "log_alloc", 3072, NULL, SEGMENT_ALLOC_PRIO, NULL);
+    }
+}
+
+// --- [SD 카드 연결] ---
+// SPI(SDSPI) 또는 SD 버스(SDMMC 호스트). SD 버스는 D1/D2 까지 연결돼 있으면 4비트, 아니면 1비트.
+// 클럭은 예전 설정(5 MHz)으로 마운트한 뒤 20 / 40 MHz 로 올려 봄 (CONFIG_CAN_SD_MAX_FREQ_KHZ 까지).
+// 단계마다 다시 마운트하고 시험 파일을 써서 다시 읽어 비교 (can_sdtest). 마운트나 비교가 실패하면
+// 마지막으로 통과한 클럭으로 다시 마운트. 4비트가 5 MHz 에서도 안 되면 1비트로 처음부터.
+#define SD_SAFE_FREQ_KHZ    5000            // 선이 길어도 되는 클럭 (예전 설정)
+#define SD_TEST_BUF_SIZE    (32 * 1024)     // 시험 파일을 이만큼씩 쓰고 읽음
+#define SD_TEST_FILE        MOUNT_POINT "/SDTEST.TMP"
+#if CONFIG_CAN_SD_SDMMC
+#define SD_TRANSPORT_NAME   "SDMMC"
+#else
+#define SD_TRANSPORT_NAME   "SPI"
+#endif
+
+static sdmmc_card_t *sd_card;   // 마운트된 카드 (없으면 NULL)
+
+static const esp_vfs_fat_sdmmc_mount_config_t mount_config = {
+    .format_if_mount_failed = false, // 포맷 안 함 (중요 데이터를 위해 false 추천)
+    .max_files = 5,
+    .allocation_unit_size = 16 * 1024
+};
+
+static esp_err_t sd_mount(int freq_khz, int width) {
+#if CONFIG_CAN_SD_SDMMC
+    sdmmc_host_t host = SDMMC_HOST_DEFAULT();
+    host.max_freq_khz = freq_khz;
+    if (width == 1) host.flags &= ~SDMMC_HOST_FLAG_4BIT;
+
+    sdmmc_slot_config_t slot_config = SDMMC_SLOT_CONFIG_DEFAULT();
+    slot_config.width = width;
+#if SOC_SDMMC_USE_GPIO_MATRIX
+    slot_config.clk = SD_PIN_CLK;
+    slot_config.cmd = SD_PIN_CMD;
+    slot_config.d0 = SD_PIN_D0;
+    if (width == 4) {
+        slot_config.d1 = CONFIG_CAN_SD_PIN_D1;
+        slot_config.d2 = CONFIG_CAN_SD_PIN_D2;
+        slot_config.d3 = SD_PIN_D3;
+    }
+#endif
+    slot_config.flags |= SDMMC_SLOT_FLAG_INTERNAL_PULLUP; // 약하므로 CMD/D0~D3 에 10k 외부 풀업 권장
+    if (width == 1) {
+        // 1비트 모드에서는 드라이버가 D3 를 설정하지 않음. D3 는 SPI 모드의 CS 라서 CMD0 때 낮게 떠 있으면
+        // 카드가 SPI 모드로 들어가 버림 -> 마운트 전에 높게 고정 (4비트에서 내려온 경우 SD 신호에서도 떼어냄)
+        const gpio_config_t d3 = {
+            .pin_bit_mask = 1ULL << SD_BUS_PIN_D3,
+            .mode = GPIO_MODE_OUTPUT,
+            .pull_up_en = GPIO_PULLUP_ENABLE,
+        };
+        gpio_set_level(SD_BUS_PIN_D3, 1);
+        gpio_config(&d3);
+    }
+    return esp_vfs_fat_sdmmc_mount(MOUNT_POINT, &host, &slot_config, &mount_config, &sd_card);
+#else
+    // SPI 버스는 한 번만 (카드를 다시 마운트해도 버스는 그대로)
+    static bool bus_ready = false;
+    if (!bus_ready) {
+        spi_bus_config_t bus_cfg = {
+            .mosi_io_num = SD_PIN_CMD,
+            .miso_io_num = SD_PIN_D0,
+            .sclk_io_num = SD_PIN_CLK,
+            .quadwp_io_num = -1,
+            .quadhd_io_num = -1,
+            .max_transfer_sz = 4000, // 블록(512 B)마다 SPI 전송 하나라서 속도는 이 값이 아니라 클럭이 정함
+        };
+        // SPI 버스 초기화 (SPI2_HOST 사용)
+        esp_err_t ret = spi_bus_initialize(SPI2_HOST, &bus_cfg, SPI_DMA_CH_AUTO);
+        if (ret != ESP_OK) return ret;
+        bus_ready = true;
+    }
 
     // SD 카드 슬롯 설정
     sdmmc_host_t host = SDSPI_HOST_DEFAULT();
     host.slot = SPI2_HOST;
-    host.max_freq_khz = 5000; // 5MHz (선이 길면 낮추세요)
+    host.max_freq_khz = freq_khz;
 
     sdspi_device_config_t slot_config = SDSPI_DEVICE_CONFIG_DEFAULT();
-    slot_config.gpio_cs = SD_PIN_CS;
+    slot_config.gpio_cs = SD_PIN_D3;
     slot_config.host_id = host.slot;
+    return esp_vfs_fat_sdspi_mount(MOUNT_POINT, &host, &slot_config, &mount_config, &sd_card);
+#endif
+}
 
-    return esp_vfs_fat_sdspi_mount(MOUNT_POINT, &host, &slot_config, &mount_config, &card);
+static void sd_unmount(void) {
+    esp_vfs_fat_sdcard_unmount(MOUNT_POINT, sd_card);
+    sd_card = NULL;
 }
 
-void write_to_sd(const char *data) {
-    // 파일 이름이 비어있으면(초기화 실패 등) 실행 안 함
-    if (strlen(current_filename) == 0) return;
+// 이 클럭/폭으로 마운트하고 시험 파일을 써서 읽어 비교. 실패하면 마운트를 풀고 false
+static bool sd_try(int freq_khz, int width, void *buf, esp_err_t *err) {
+    if (sd_card != NULL) sd_unmount();
+    *err = sd_mount(freq_khz, width);
+    if (*err != ESP_OK) {
+        ESP_LOGW(TAG, "SD %d-bit %d kHz: mount failed (%s)", width, freq_khz, esp_err_to_name(*err));
+        return false;
+    }
+    int64_t t0 = esp_timer_get_time();
+    if (!can_sdtest_verify(SD_TEST_FILE, buf, SD_TEST_BUF_SIZE, CONFIG_CAN_SD_VERIFY_KB * 1024, (uint32_t)freq_khz)) {
+        ESP_LOGW(TAG, "SD %d-bit %d kHz: read-back check failed", width, freq_khz);
+        sd_unmount();
+        *err = ESP_ERR_INVALID_CRC;
+        return false;
+    }
+    ESP_LOGI(TAG, "SD %d-bit %d kHz (card %d kHz): read-back check OK, %d KB in %ld ms", width, freq_khz,
+             sd_card->max_freq_khz, CONFIG_CAN_SD_VERIFY_KB, (long)((esp_timer_get_time() - t0) / 1000));
+    return true;
+}
 
-    // 아까 만든 전역변수(current_filename)를 사용하여 파일 열기
-    FILE *f = fopen(current_filename, "a");
-    if (f == NULL) {
-        ESP_LOGE(TAG, "Failed to write to file: %s", current_filename);
+#if CONFIG_CAN_SD_BENCH
+// 블록 크기마다 CONFIG_CAN_SD_BENCH_KB 를 이어서 쓰고 MB/s 와 write 한 번의 시간을 출력 (기록 시작 전에 한 번)
+static void sd_benchmark(void) {
+    size_t sizes[CAN_SDTEST_MAX_SIZES], max = 0;
+    int n = can_sdtest_parse_sizes(CONFIG_CAN_SD_BENCH_SIZES, sizes, CAN_SDTEST_MAX_SIZES);
+    if (n <= 0) {
+        ESP_LOGW(TAG, "Bad CONFIG_CAN_SD_BENCH_SIZES: \"%s\"", CONFIG_CAN_SD_BENCH_SIZES);
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        if (sizes[i] > max) max = sizes[i];
+    }
+    void *buf = max <= 65536 ? heap_caps_malloc(max, MALLOC_CAP_DMA) : NULL;
+    if (buf == NULL) {
+        ESP_LOGW(TAG, "SD benchmark: no buffer for %u bytes", (unsigned)max);
         return;
     }
-    fprintf(f, data);
-    fclose(f);
-}
\ No newline at end of file
+    can_sdtest_result_t res[CAN_SDTEST_MAX_SIZES];
+    can_sdtest_bench(SD_TEST_FILE, buf, max, sizes, n, (uint64_t)CONFIG_CAN_SD_BENCH_KB * 1024, esp_timer_get_time, res);
+    free(buf);
+    for (int i = 0; i < n; i++) {
+        ESP_LOGI(TAG, "[SD bench] %6u B x %lu: %.2f MB/s | write avg %lu us, max %lu us | fsync %lu us%s",
+                 (unsigned)res[i].block, (unsigned long)res[i].writes, res[i].mb_s, (unsigned long)res[i].avg_us,
+                 (unsigned long)res[i].max_us, (unsigned long)res[i].fsync_us, res[i].ok ? "" : " (FAILED)");
+    }
+}
+#endif
+
+esp_err_t init_sd_card() {
+    static const int steps_khz[] = { SD_SAFE_FREQ_KHZ, 20000, 40000 }; // 20 MHz = 기본 속도, 40 MHz = 고속 모드
+    void *buf = heap_caps_malloc(SD_TEST_BUF_SIZE, MALLOC_CAP_DMA);
+    if (buf == NULL) return ESP_ERR_NO_MEM;
+
+    int width = 1;
+#if CONFIG_CAN_SD_SDMMC
+    if (CONFIG_CAN_SD_PIN_D1 >= 0 && CONFIG_CAN_SD_PIN_D2 >= 0) width = 4;
+#endif
+    esp_err_t err = ESP_FAIL;
+    int good_khz = 0;
+    while (good_khz == 0) {
+        for (int i = 0; i < sizeof(steps_khz) / sizeof(steps_khz[0]); i++) {
+            int khz = steps_khz[i] < CONFIG_CAN_SD_MAX_FREQ_KHZ ? steps_khz[i] : CONFIG_CAN_SD_MAX_FREQ_KHZ;
+            if (!sd_try(khz, width, buf, &err)) break;
+            good_khz = khz;
+            // 한도에 닿았거나 카드가 더 올라가지 않음 (고속 모드 없는 카드는 20 MHz 에 머묾)
+            if (khz == CONFIG_CAN_SD_MAX_FREQ_KHZ || sd_card->max_freq_khz < khz) break;
+        }
+        if (good_khz > 0 || width == 1) break;
+        ESP_LOGW(TAG, "SD 4-bit failed, falling back to 1-bit");
+        width = 1;
+    }
+    // 올리다 실패했으면 마지막으로 통과한 클럭으로 다시
+    if (good_khz > 0 && sd_card == NULL) {
+        err = sd_mount(good_khz, width);
+    }
+    free(buf);
+    if (good_khz == 0 || err != ESP_OK) return err;
+
+    ESP_LOGI(TAG, "SD card: %s %d-bit, %d kHz", SD_TRANSPORT_NAME, width, sd_card->max_freq_khz);
+    sdmmc_card_print_info(stdout, sd_card);
+#if CONFIG_CAN_SD_BENCH
+    sd_benchmark();
+#endif
+    return ESP_OK;
+}
+
+// DS3231 레지스터 읽기 (reg 부터 len 바이트)
+esp_err_t rtc_read_reg(uint8_t reg, uint8_t *data, size_t len) {
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (DS3231_ADDR << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_write_byte(cmd, reg, true);
+    i2c_master_start(cmd); // 반복 시작 (한 트랜잭션으로)
+    i2c_master_write_byte(cmd, (DS3231_ADDR << 1) | I2C_MASTER_READ, true);
+    i2c_master_read(cmd, data, len, I2C_MASTER_LAST_NACK);
+    i2c_master_stop(cmd);
+    esp_err_t err = i2c_master_cmd_begin(I2C_MASTER_NUM, cmd, pdMS_TO_TICKS(100));
+    i2c_cmd_link_delete(cmd);
+    return err;
+}
+
+esp_err_t rtc_write_reg(uint8_t reg, uint8_t value) {
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (DS3231_ADDR << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_write_byte(cmd, reg, true);
+    i2c_master_write_byte(cmd, value, true);
+    i2c_master_stop(cmd);
+    esp_err_t err = i2c_master_cmd_begin(I2C_MASTER_NUM, cmd, pdMS_TO_TICKS(100));
+    i2c_cmd_link_delete(cmd);
+    return err;
+}
+
+// 지금 RTC 시각 (1970-01-01 기준 마이크로초, 레코드 시각 형식)
+int64_t rtc_time_us() {
+    int year, month, day, hour, min, sec;
+    get_time(&year, &month, &day, &hour, &min, &sec);
+    return can_record_epoch(year, month, day, hour, min, sec) * 1000000;
+}
+
+// 프레임(또는 로거 이벤트) 하나를 저장. 버퍼가 모두 카드로 가는 중이면 false (나중에 다시)
+bool log_record(const can_record_t *rec) {
+    return write_to_sd(rec, sizeof(*rec));
+}
+
+bool write_to_sd(const void *data, size_t len) {
+    // 파일 이름이 비어있으면(초기화 실패 등) 저장하지 않고 넘어감
+    if (strlen(current_filename) == 0) return true;
+
+    // RAM 버퍼에만 추가 (카드에 쓰는 건 버퍼가 차거나, 시간이 되거나, 이벤트 ID 가 왔을 때 SD 쓰기 태스크가)
+    return can_log_write(data, len);
+}
+
+// --- [SD 쓰기 통계] ---
+// 카드에 몇 번, 얼마나 오래 썼는지 / fsync 간격이 정책대로 지켜지는지 주기적으로 출력
+void print_log_stats() {
+    static int64_t last_print_us = 0;
+    int64_t now = esp_timer_get_time();
+    if (now - last_print_us < LOG_STATS_PERIOD_MS * 1000LL) return;
+    last_print_us = now;
+
+    // 어디서 프레임을 잃었는지: 하드웨어 FIFO / 드라이버 큐 / 기록 링
+    twai_status_info_t twai;
+    if (twai_get_status_info(&twai) == ESP_OK) {
+        ESP_LOGI(TAG, "[RX] ring %lu/%d (max %lu), dropped: ring %u, driver queue %lu, hw fifo %lu | console skipped %lu",
+                 (unsigned long)can_ring_count(&rx_ring), CONFIG_CAN_RX_RING_SIZE, (unsigned long)rx_ring.high_water,
+                 atomic_load(&rx_ring.dropped), (unsigned long)twai.rx_missed_count,
+                 (unsigned long)twai.rx_overrun_count, (unsigned long)console_skipped);
+    }
+    can_time_t clock;
+    if (clock_snapshot(&clock)) {
+        ESP_LOGI(TAG, "[TIME] %s, edges %lu, relocks %lu | drift %+.2f ppm | last error %ld us, max %lu us",
+                 sqw_ok ? "SQW" : "polling", (unsigned long)clock.edges, (unsigned long)clock.steps,
+                 clock.drift_ppb / 1000.0, (long)clock.last_error_us, (unsigned long)clock.max_error_us);
+    }
+    if (strlen(current_filename) == 0) return;
+
+    can_log_stats_t st;
+    can_log_get_stats(&st);
+    ESP_LOGI(TAG, "[SD] %llu bytes | flush: size %lu, time %lu, event %lu | write %lu (avg %lu us, max %lu us)",
+             (unsigned long long)st.bytes, (unsigned long)st.flush_size, (unsigned long)st.flush_time,
+             (unsigned long)st.flush_event, (unsigned long)st.writes,
+             (unsigned long)(st.writes ? st.write_total_us / st.writes : 0), (unsigned long)st.write_max_us);
+    ESP_LOGI(TAG, "[SD] fsync %lu (avg %lu us, max %lu us), longest gap %lu ms, errors %lu",
+             (unsigned long)st.fsyncs, (unsigned long)(st.fsyncs ? st.fsync_total_us / st.fsyncs : 0),
+             (unsigned long)st.fsync_max_us, (unsigned long)st.fsync_gap_max_ms, (unsigned long)st.errors);
+    ESP_LOGI(TAG, "[SD] both buffers busy %lu times", (unsigned long)st.stalls);
+    ESP_LOGI(TAG, "[SD] buffer to card: p50 %lu us, p99 %lu us, p99.9 %lu us | files %lu (no spare %lu), next %s, alloc errors %lu",
+             (unsigned long)can_log_percentile_us(&st, 500), (unsigned long)can_log_percentile_us(&st, 990),
+             (unsigned long)can_log_percentile_us(&st, 999), (unsigned long)st.segments,
+             (unsigned long)st.spare_misses, st.spare_ready ? "ready" : "preparing", (unsigned long)st.alloc_errors);
+}
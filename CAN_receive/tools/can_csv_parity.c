@@ -0,0 +1,114 @@
+// --- [CSV 일치 확인 (PC 용)] ---
+// 바이너리 기록으로 바꾸기 전 로거가 프레임마다 sprintf 로 쓰던 CSV 줄과, 지금의 can_record_format_csv()
+// (기본 신호 표 can_record_signals 로 해석) 가 같은 줄을 만드는지 무작위 프레임으로 비교합니다.
+// 예전 코드는 아래 legacy_csv() 에 그대로 옮겨 둠 (twai_message_t 대신 can_record_t 를 받는 것만 다름).
+// 일부러 달라진 두 가지는 따로 셈 (틀린 것으로 치지 않음):
+//  - 29비트 ID: 예전 코드는 확장 프레임인지 보지 않고 ID 숫자만 비교 (확장 0x100 도 버튼), 지금은 11비트만
+//  - 가속도(0x300) DLC 7/8: 예전에는 버림, 지금은 앞 6 바이트로 해석 (화면 출력과 같게)
+//
+// 빌드 & 실행 (CAN_receive/tools 폴더에서):
+//   gcc -O2 -I../main -o can_csv_parity can_csv_parity.c ../main/can_record.c ../main/can_dbc.c -lm
+//   ./can_csv_parity [frames] [seed]      (기본 200000 프레임, 시드 1. 틀린 줄이 하나라도 있으면 종료 코드 1)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "can_record.h"
+
+// --- [예전 로거의 CSV 줄] ---
+// 시각은 get_time() 이 주던 달력 값 그대로
+static int legacy_csv(const can_record_t *r, int year, int month, int day, int hour, int min, int sec,
+                      char *csv_buffer) {
+    switch (r->id) {
+        // [CASE A] 버튼 (0x100)
+        case 0x100:
+            return sprintf(csv_buffer, "%04d-%02d-%02d %02d:%02d:%02d, BUTTON, Clicked\n",
+                           year, month, day, hour, min, sec);
+
+        // [CASE B] 온습도 (0x200)
+        case 0x200:
+            if (r->dlc >= 2) {
+                int temp = r->data[0];
+                int hum = r->data[1];
+                return sprintf(csv_buffer, "%04d-%02d-%02d %02d:%02d:%02d, DHT11, Temp:%d, Hum:%d\n",
+                               year, month, day, hour, min, sec, temp, hum);
+            }
+            break;
+
+        // [CASE C] MPU6500 가속도 (0x300)
+        case 0x300:
+            if (r->dlc == 6) {
+                int16_t raw_ax = (int16_t)((r->data[0] << 8) | r->data[1]);
+                int16_t raw_ay = (int16_t)((r->data[2] << 8) | r->data[3]);
+                int16_t raw_az = (int16_t)((r->data[4] << 8) | r->data[5]);
+                float ax_g = raw_ax / 16384.0;
+                float ay_g = raw_ay / 16384.0;
+                float az_g = raw_az / 16384.0;
+                return sprintf(csv_buffer, "%04d-%02d-%02d %02d:%02d:%02d, ACCEL, %.2f, %.2f, %.2f\n",
+                               year, month, day, hour, min, sec, ax_g, ay_g, az_g);
+            }
+            break;
+    }
+    return 0;
+}
+
+// xorshift32 (PC 마다 rand() 가 달라도 같은 프레임이 나오도록)
+static uint32_t next_rand(uint32_t *x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+int main(int argc, char **argv) {
+    long frames = argc > 1 ? atol(argv[1]) : 200000;
+    uint32_t x = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) | 1 : 1;
+
+    can_dbc_t db;
+    if (!can_dbc_init(&db, 16, 64)) return 1;
+    can_dbc_load_table(&db, can_record_signals, can_record_num_signals);
+    if (!can_dbc_build(&db)) return 1;
+
+    // 알려진 ID 위주로, 모르는 ID 도 조금. DLC 0~8, 열에 하나는 확장 프레임
+    static const uint32_t ids[] = { 0x100, 0x200, 0x300, 0x100, 0x200, 0x300, 0x123, 0x7FF };
+    long lines = 0, errors = 0, extd_diff = 0, accel_diff = 0;
+    char got[256], want[256];
+    for (long i = 0; i < frames; i++) {
+        can_record_t r = { 0 };
+        int64_t t = 1735689600 + (int64_t)(next_rand(&x) % (100u * 365 * 86400)); // 2025 ~ 2124 년
+        r.time_us = (uint64_t)t * 1000000 + next_rand(&x) % 1000000;
+        r.id = ids[next_rand(&x) % (sizeof(ids) / sizeof(ids[0]))];
+        r.flags = next_rand(&x) % 10 == 0 ? CAN_REC_EXTD : 0;
+        r.dlc = (uint8_t)(next_rand(&x) % 9);
+        for (int k = 0; k < 8; k++) r.data[k] = (uint8_t)next_rand(&x);
+
+        // 예전 로거가 받던 달력 시각 (gmtime 은 RTC 시각을 시간대 없이 그대로 풀어 줌)
+        time_t tt = (time_t)t;
+        struct tm tm;
+        gmtime_r(&tt, &tm);
+        int n_want = legacy_csv(&r, tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min,
+                                tm.tm_sec, want);
+        int n_got = can_record_format_csv(&db, &r, false, got, sizeof(got));
+        if (n_want > 0) lines++;
+        if (n_want == n_got && (n_want == 0 || strcmp(want, got) == 0)) continue;
+
+        if ((r.flags & CAN_REC_EXTD) && n_got == 0) {
+            extd_diff++;
+        } else if (r.id == 0x300 && r.dlc > 6 && n_want == 0 && strstr(got, ", ACCEL, ") != NULL) {
+            accel_diff++;
+        } else {
+            if (errors < 10) {
+                printf("mismatch: id 0x%lX%s dlc %u\n  old: %s  new: %s", (unsigned long)r.id,
+                       (r.flags & CAN_REC_EXTD) ? " (extd)" : "", r.dlc, n_want > 0 ? want : "(none)\n",
+                       n_got > 0 ? got : "(none)\n");
+            }
+            errors++;
+        }
+    }
+    can_dbc_free(&db);
+
+    printf("frames %ld, old CSV lines %ld\n", frames, lines);
+    printf("  expected differences: 29-bit IDs %ld, ACCEL DLC 7/8 %ld\n", extd_diff, accel_diff);
+    printf("%s (%ld mismatches)\n", errors ? "FAILED" : "OK", errors);
+    return errors ? 1 : 0;
+}
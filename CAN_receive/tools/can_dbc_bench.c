@@ -0,0 +1,242 @@
+// --- [CAN 신호 해석 벤치마크 (PC 용)] ---
+// main/can_dbc.c 를 PC 에서 그대로 돌려 봅니다.
+//  - 무작위 신호 표를 만들어 .dbc 파일로 쓰고 can_dbc_load_file() 로 다시 읽음 (파서 확인)
+//    메시지마다 신호 -s 개가 8 바이트를 나눠 가짐, 인텔/모토로라, 부호 있음/없음, 배율/오프셋 무작위
+//  - 확인: 무작위 프레임 20만 개를 비트 하나씩 따라가는 단순한 해석(DBC 규칙 그대로)과 비교
+//  - 측정: 프레임 -n 개 (10% 는 표에 없는 ID) 를 ID 찾기 + 전체 신호 해석. 초당 신호 수 출력
+//    비교용으로 단순한 해석(신호마다 비트 반복)의 속도도 같이
+//
+// 빌드 & 실행 (CAN_receive/tools 폴더에서):
+//   gcc -O2 -I../main -o can_dbc_bench can_dbc_bench.c ../main/can_dbc.c -lm
+//   ./can_dbc_bench [-m messages] [-s signals/message] [-n frames]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "can_dbc.h"
+
+#define DBC_PATH     "/tmp/can_dbc_bench.dbc"
+#define CHECK_FRAMES 200000
+
+typedef struct {
+    int start, length;
+    bool big_endian, is_signed;
+    double scale, offset;
+} ref_signal_t;
+
+typedef struct {
+    uint32_t id;
+    bool extd;
+    int first, count;
+} ref_message_t;
+
+static ref_message_t *ref_msgs;
+static ref_signal_t *ref_sigs;
+static int num_msgs, num_sigs;
+
+static uint32_t rng = 12345;
+static uint32_t rand_u32(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// DBC 규칙 그대로 비트 하나씩: 인텔은 시작 비트부터 위로, 모토로라는 시작 비트(MSB)부터 7..0 톱니 순서로
+static double ref_decode(const ref_signal_t *s, const uint8_t *data) {
+    uint64_t v = 0;
+    int pos = s->start;
+    for (int i = 0; i < s->length; i++) {
+        int bit;
+        if (s->big_endian) {
+            bit = (data[pos / 8] >> (pos % 8)) & 1;
+            v = v << 1 | (uint64_t)bit;
+            pos = pos % 8 == 0 ? pos + 15 : pos - 1;
+        } else {
+            bit = (data[(pos + i) / 8] >> ((pos + i) % 8)) & 1;
+            v |= (uint64_t)bit << i;
+        }
+    }
+    int64_t raw = (int64_t)v;
+    if (s->is_signed && s->length < 64 && (v >> (s->length - 1)) & 1) raw -= (int64_t)1 << s->length;
+    return (double)raw * s->scale + s->offset;
+}
+
+// 무작위 표를 .dbc 로 씀 (메시지마다 64비트를 신호 수만큼 나눔)
+static bool write_dbc(int messages, int per_msg) {
+    FILE *f = fopen(DBC_PATH, "w");
+    if (f == NULL) return false;
+    fprintf(f, "VERSION \"\"\n\nBU_: ECU\n\n");
+    ref_msgs = calloc(messages, sizeof(*ref_msgs));
+    ref_sigs = calloc((size_t)messages * per_msg, sizeof(*ref_sigs));
+
+    // 표준 ID 를 섞어서 앞에서부터, 모자라면 확장 ID
+    uint16_t perm[2048];
+    for (int i = 0; i < 2048; i++) perm[i] = (uint16_t)i;
+    for (int i = 2047; i > 0; i--) {
+        int j = rand_u32() % (i + 1);
+        uint16_t t = perm[i]; perm[i] = perm[j]; perm[j] = t;
+    }
+    for (int m = 0; m < messages; m++) {
+        ref_message_t *rm = &ref_msgs[num_msgs++];
+        rm->extd = m >= 1800;
+        rm->id = rm->extd ? 0x18000000u + (uint32_t)m * 7 : perm[m];
+        rm->first = num_sigs;
+        rm->count = per_msg;
+        fprintf(f, "BO_ %lu MSG_%d: 8 ECU\n", (unsigned long)(rm->id | (rm->extd ? 0x80000000u : 0)), m);
+
+        bool big_endian = rand_u32() & 1;
+        int pos = 0; // 위(모토로라) 또는 아래(인텔)부터 채운 비트 수
+        for (int k = 0; k < per_msg; k++) {
+            // 남은 신호마다 최소 1비트를 남기고, 평균 길이의 2배까지. 마지막 신호는 남은 비트 전부
+            int left = 64 - pos, max_len = left - (per_msg - k - 1);
+            if (max_len > 2 * 64 / per_msg) max_len = 2 * 64 / per_msg;
+            int length = k == per_msg - 1 ? left : 1 + (int)(rand_u32() % (uint32_t)max_len);
+            ref_signal_t *s = &ref_sigs[num_sigs++];
+            s->length = length;
+            s->big_endian = big_endian;
+            s->is_signed = length > 1 && (rand_u32() & 1);
+            s->start = big_endian ? pos / 8 * 8 + (7 - pos % 8) : pos;
+            static const double scales[] = { 1, 0.1, 0.01, 0.5, 0.25, 1.0 / 16384, 0.0625, 2 };
+            s->scale = scales[rand_u32() % 8];
+            s->offset = (double)((int)(rand_u32() % 81) - 40);
+            pos += length;
+            fprintf(f, " SG_ S%d_%d : %d|%d@%c%c (%.10g,%.10g) [0|0] \"u\" ECU\n", m, k, s->start, s->length,
+                    big_endian ? '0' : '1', s->is_signed ? '-' : '+', s->scale, s->offset);
+        }
+        fprintf(f, "\n");
+    }
+    // 멀티플렉스 신호는 건너뛰고 (건너뜀 1), 가짜 메시지와 그 신호는 조용히 무시해야 함
+    fprintf(f, "BO_ %lu MUXED: 8 ECU\n", 0x80000000UL | 0x17000000UL);
+    fprintf(f, " SG_ Mode M : 0|8@1+ (1,0) [0|0] \"\" ECU\n");
+    fprintf(f, " SG_ Value m1 : 8|16@1+ (1,0) [0|0] \"\" ECU\n");
+    fprintf(f, "BO_ 3221225472 VECTOR__INDEPENDENT_SIG_MSG: 0 Vector__XXX\n");
+    fprintf(f, " SG_ Orphan : 0|8@1+ (1,0) [0|0] \"\" Vector__XXX\n");
+    fclose(f);
+    return true;
+}
+
+static void random_frame(uint32_t *id, bool *extd, uint8_t *data, const ref_message_t **rm) {
+    if (rand_u32() % 10 == 0) { // 표에 없는 ID
+        *id = 0x1FFFF000u + rand_u32() % 0x1000;
+        *extd = true;
+        *rm = NULL;
+    } else {
+        *rm = &ref_msgs[rand_u32() % num_msgs];
+        *id = (*rm)->id;
+        *extd = (*rm)->extd;
+    }
+    uint32_t a = rand_u32(), b = rand_u32();
+    memcpy(data, &a, 4);
+    memcpy(data + 4, &b, 4);
+}
+
+int main(int argc, char **argv) {
+    int messages = 500, per_msg = 8;
+    long frames = 2000000;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:s:n:")) != -1) {
+        switch (opt) {
+            case 'm': messages = atoi(optarg); break;
+            case 's': per_msg = atoi(optarg); break;
+            case 'n': frames = atol(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-m messages] [-s signals/message] [-n frames]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (messages < 1 || messages > 4000 || per_msg < 1 || per_msg > 64) {
+        fprintf(stderr, "messages 1..4000, signals/message 1..64\n");
+        return 2;
+    }
+    if (!write_dbc(messages, per_msg)) {
+        perror(DBC_PATH);
+        return 1;
+    }
+
+    can_dbc_t db;
+    if (!can_dbc_init(&db, messages + 1, messages * per_msg + 1)) return 1; // + MUXED
+    double t0 = now_s();
+    int loaded = can_dbc_load_file(&db, DBC_PATH);
+    can_dbc_build(&db);
+    double load_s = now_s() - t0;
+    printf("%s: 메시지 %d, 신호 %d 읽음 (건너뜀 %lu), %.1f ms\n", DBC_PATH, db.num_messages, loaded,
+           (unsigned long)db.skipped, load_s * 1000);
+    if (db.num_messages != messages + 1 || loaded != num_sigs + 1 || db.skipped != 1) {
+        printf("파일 읽기 오류! (기대: 메시지 %d, 신호 %d, 건너뜀 1)\n", messages + 1, num_sigs + 1);
+        return 1;
+    }
+
+    // 1. 단순한 해석과 비교
+    float values[CAN_DBC_MAX_MSG_SIGNALS];
+    long mismatches = 0, lookup_errors = 0;
+    for (long i = 0; i < CHECK_FRAMES; i++) {
+        uint32_t id;
+        bool extd;
+        uint8_t data[8];
+        const ref_message_t *rm;
+        random_frame(&id, &extd, data, &rm);
+        const can_dbc_message_t *m = can_dbc_find(&db, id, extd);
+        if ((m == NULL) != (rm == NULL) || (m != NULL && m->num_signals != rm->count)) {
+            lookup_errors++;
+            continue;
+        }
+        if (m == NULL) continue;
+        can_dbc_decode(&db, m, data, 8, values);
+        for (int k = 0; k < rm->count; k++) {
+            // float 로 계산하므로 배율을 곱한 값과 오프셋 크기에 비례하는 오차는 허용
+            const ref_signal_t *rs = &ref_sigs[rm->first + k];
+            double want = ref_decode(rs, data);
+            if (fabs(want - values[k]) > 1e-6 * (fabs(want - rs->offset) + fabs(rs->offset)) + 1e-9) mismatches++;
+        }
+    }
+    printf("확인: 프레임 %d 개, ID 찾기 오류 %ld, 값 불일치 %ld\n", CHECK_FRAMES, lookup_errors, mismatches);
+
+    // 2. 속도: 미리 만든 프레임으로 (난수 생성 시간 제외)
+    enum { POOL = 4096 };
+    static uint32_t ids[POOL];
+    static bool extds[POOL];
+    static uint8_t datas[POOL][8];
+    static const ref_message_t *rms[POOL];
+    for (int i = 0; i < POOL; i++) random_frame(&ids[i], &extds[i], datas[i], &rms[i]);
+
+    double sum = 0;
+    long signals = 0;
+    t0 = now_s();
+    for (long i = 0; i < frames; i++) {
+        int p = (int)(i & (POOL - 1));
+        const can_dbc_message_t *m = can_dbc_find(&db, ids[p], extds[p]);
+        if (m == NULL) continue;
+        signals += can_dbc_decode(&db, m, datas[p], 8, values);
+        sum += values[0];
+    }
+    double table_s = now_s() - t0;
+
+    long ref_signals = 0;
+    long ref_frames = frames / 10;
+    t0 = now_s();
+    for (long i = 0; i < ref_frames; i++) {
+        int p = (int)(i & (POOL - 1));
+        const ref_message_t *rm = rms[p];
+        if (rm == NULL) continue;
+        for (int k = 0; k < rm->count; k++) sum += ref_decode(&ref_sigs[rm->first + k], datas[p]);
+        ref_signals += rm->count;
+    }
+    double ref_s = now_s() - t0;
+
+    printf("표 해석:    프레임 %ld 개, %.0f 프레임/s, %.1f M 신호/s (신호당 %.1f ns)\n", frames, frames / table_s,
+           signals / table_s / 1e6, table_s / signals * 1e9);
+    printf("비트 반복:  %.1f M 신호/s (신호당 %.1f ns) -> 표 해석이 %.1f 배\n", ref_signals / ref_s / 1e6,
+           ref_s / ref_signals * 1e9, (signals / table_s) / (ref_signals / ref_s));
+    printf("(합계 %.3g)\n", sum);
+    can_dbc_free(&db);
+    return lookup_errors == 0 && mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,221 @@
+// --- [TWAI 수신 필터 계산/확인 (PC 용)] ---
+// main/can_filter.c 를 PC 에서 그대로 돌려서 필터 값을 계산하고, 하드웨어 비교 규칙으로 확인합니다.
+//  - 하드웨어 규칙 (ESP32 TRM, SJA1000 과 같음): 레지스터 32비트 = ACR0..ACR3, mask 1 = 상관없음
+//      single 표준: ID 31..21, RTR 20, 데이터1 15..8, 데이터2 7..0 (19..16 안 씀)
+//      single 확장: ID 31..3, RTR 2 (1..0 안 씀)
+//      dual 표준:   필터1 = ID 31..21, RTR 20, 데이터1 19..16 + 3..0 / 필터2 = ID 15..5, RTR 4
+//      dual 확장:   필터1 = ID[28:13] 31..16 / 필터2 = ID[28:13] 15..0
+//    ID 공간 전체(표준 2048, 확장 2^29)를 하나씩 넣어 보고 (RTR / 데이터 / 안 쓰는 비트는 무작위)
+//    1. 원하는 ID 가 모두 통과하는지  2. 통과한 수가 계산과 같은지 확인
+//  - 목록을 주면: 필터 값과 twai_filter_config_t 한 줄을 출력 (CAN_transmit 처럼 Kconfig 없는 곳에 붙여 넣기)
+//  - -t: 무작위 목록 (표준 N 개 + 확장 8 개) 확인. 표준 ID 8개 이하는 두 무리로 나누는 경우를 모두 따져 본
+//    최적값과도 비교하고, 필터 하나만 쓸 때보다 false accept 가 얼마나 줄었는지 출력
+//
+// 빌드 & 실행 (CAN_receive/tools 폴더에서):
+//   gcc -O2 -I../main -o can_filter_plan can_filter_plan.c ../main/can_filter.c
+//   ./can_filter_plan [-x] "0x100,0x200-0x2FF"     (-x: 확장 ID)
+//   ./can_filter_plan -t [cases]                   (기본 2000)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "can_filter.h"
+
+static uint32_t rng = 12345;
+static uint32_t rand_u32(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+// 하드웨어가 이 프레임을 받는지 (can_filter.c 와 따로 적은 비교 규칙)
+static bool hw_accepts(const can_filter_plan_t *p, uint32_t id, uint32_t noise) {
+    uint32_t code = p->acceptance_code, mask = p->acceptance_mask;
+    uint32_t rtr = noise & 1, data1 = (noise >> 1) & 0xFF, data2 = (noise >> 9) & 0xFF, unused = noise >> 17;
+    if (p->single_filter) {
+        uint32_t reg = p->extd ? id << 3 | rtr << 2 | (unused & 0x3)
+                               : id << 21 | rtr << 20 | (unused & 0xF) << 16 | data1 << 8 | data2;
+        return ((reg ^ code) & ~mask) == 0;
+    }
+    if (p->extd) {
+        uint32_t reg = (id >> 13) << 16 | id >> 13;
+        uint32_t diff = (reg ^ code) & ~mask;
+        return (diff & 0xFFFF0000) == 0 || (diff & 0x0000FFFF) == 0;
+    }
+    uint32_t reg1 = id << 21 | rtr << 20 | (data1 >> 4) << 16 | (data1 & 0xF);
+    uint32_t reg2 = id << 5 | rtr << 4;
+    return ((reg1 ^ code) & ~mask & 0xFFFF000F) == 0 || ((reg2 ^ code) & ~mask & 0x0000FFF0) == 0;
+}
+
+static int cmp_range(const void *a, const void *b) {
+    uint32_t x = ((const can_filter_range_t *)a)->lo, y = ((const can_filter_range_t *)b)->lo;
+    return x < y ? -1 : x > y;
+}
+
+// ID 공간 전체를 하드웨어 규칙으로 확인. 원하는데 떨어진 ID 수 (통과한 수는 *accepted)
+static uint64_t verify(const can_filter_plan_t *p, const can_filter_range_t *ranges, int n, uint64_t *accepted) {
+    can_filter_range_t sorted[CAN_FILTER_MAX_RANGES];
+    memcpy(sorted, ranges, sizeof(*ranges) * n);
+    qsort(sorted, n, sizeof(*sorted), cmp_range);
+    uint32_t id_max = p->extd ? 0x1FFFFFFF : 0x7FF;
+    uint64_t missed = 0, count = 0;
+    int r = 0;
+    for (uint64_t id = 0; id <= id_max; id++) {
+        while (r < n && sorted[r].hi < id) r++;
+        bool wanted = false;
+        for (int k = r; k < n && sorted[k].lo <= id; k++) {
+            if (sorted[k].hi >= id) { wanted = true; break; }
+        }
+        bool ok = hw_accepts(p, (uint32_t)id, (uint32_t)(id * 2654435761u) ^ (uint32_t)(id >> 7));
+        count += ok;
+        if (wanted && !ok) missed++;
+    }
+    *accepted = count;
+    return missed;
+}
+
+static void print_plan(const can_filter_plan_t *p) {
+    printf("  %s 필터, code 0x%08lX mask 0x%08lX\n", p->single_filter ? "single" : "dual",
+           (unsigned long)p->acceptance_code, (unsigned long)p->acceptance_mask);
+    for (int i = 0; i < (p->single_filter ? 1 : 2); i++) {
+        printf("  필터%d: ID 0x%0*lX, 상관없는 비트 0x%0*lX (%llu 개)\n", i + 1, p->extd ? 8 : 3,
+               (unsigned long)p->block_code[i], p->extd ? 8 : 3, (unsigned long)p->block_mask[i],
+               1ULL << __builtin_popcount(p->block_mask[i]));
+    }
+    printf("  원하는 ID %llu, 통과 ID %llu, false accept %.2f%%\n", (unsigned long long)p->wanted,
+           (unsigned long long)p->accepted, p->false_accept * 100);
+}
+
+// 표준 ID 몇 개: 두 무리로 나누는 경우를 모두 따져 본 최소 통과 수 (필터 하나도 포함)
+static uint64_t brute_force(const uint32_t *ids, int n) {
+    uint64_t best = UINT64_MAX;
+    for (uint32_t part = 0; part < 1u << (n - 1); part++) { // ids[n-1] 은 늘 B 쪽
+        uint32_t ma = 0, mb = 0, ca = 0, cb = ids[n - 1];
+        bool has_a = false;
+        for (int i = 0; i < n; i++) {
+            if (part >> i & 1) {
+                if (has_a) ma |= ca ^ ids[i];
+                else ca = ids[i];
+                has_a = true;
+            } else {
+                mb |= cb ^ ids[i];
+            }
+        }
+        ca &= ~ma;
+        cb &= ~mb;
+        uint64_t size = 1ULL << __builtin_popcount(mb);
+        if (has_a) {
+            size += 1ULL << __builtin_popcount(ma);
+            if (((ca ^ cb) & ~(ma | mb)) == 0) size -= 1ULL << __builtin_popcount(ma & mb);
+        }
+        if (size < best) best = size;
+    }
+    return best;
+}
+
+// 무작위 목록: ID 하나 또는 범위 1~8 개
+static int random_list(bool extd, can_filter_range_t *out, bool *only_ids) {
+    int n = 1 + rand_u32() % 8;
+    uint32_t id_max = extd ? 0x1FFFFFFF : 0x7FF;
+    *only_ids = true;
+    // 실제 버스처럼 가까운 ID 끼리 모이는 경우가 많게: 절반은 기준 ID 근처
+    uint32_t base = rand_u32() & id_max;
+    for (int i = 0; i < n; i++) {
+        uint32_t lo = rand_u32() % 2 ? (base + rand_u32() % 64) & id_max : rand_u32() & id_max;
+        uint32_t len = rand_u32() % 4 == 0 ? rand_u32() % (extd ? 100000 : 40) : 0;
+        if (len > 0) *only_ids = false;
+        out[i].lo = lo;
+        out[i].hi = lo + len > id_max ? id_max : lo + len;
+    }
+    return n;
+}
+
+static int run_tests(int cases) {
+    int failures = 0, compared = 0, optimal = 0, duals = 0;
+    double fa_single = 0, fa_plan = 0, gap_sum = 0;
+    for (int c = 0; c < cases + 8; c++) {
+        bool extd = c >= cases;
+        can_filter_range_t ranges[CAN_FILTER_MAX_RANGES];
+        bool only_ids;
+        int n = random_list(extd, ranges, &only_ids);
+
+        can_filter_plan_t plan;
+        if (!can_filter_plan(ranges, n, extd, &plan)) {
+            printf("계산 실패 (case %d)\n", c);
+            failures++;
+            continue;
+        }
+        uint64_t accepted;
+        uint64_t missed = verify(&plan, ranges, n, &accepted);
+        if (missed > 0 || accepted != plan.accepted) {
+            printf("오류 (case %d, %s): 떨어진 원하는 ID %llu, 통과 %llu (계산 %llu)\n", c, extd ? "확장" : "표준",
+                   (unsigned long long)missed, (unsigned long long)accepted, (unsigned long long)plan.accepted);
+            print_plan(&plan);
+            failures++;
+            continue;
+        }
+        duals += !plan.single_filter;
+        // 필터 하나만 쓸 때 (ID 들 사이에 다른 비트 = 상관없음)
+        uint32_t diff = 0;
+        for (int i = 0; i < n; i++) {
+            uint32_t span = ranges[i].lo ^ ranges[i].hi;    // 범위 안에서 바뀌는 비트 (가장 높은 것 아래 전부)
+            if (span != 0) span = 0xFFFFFFFFu >> __builtin_clz(span);
+            diff |= span | (ranges[i].lo ^ ranges[0].lo);
+        }
+        uint64_t single = 1ULL << __builtin_popcount(diff);
+        fa_single += (double)(single - plan.wanted) / single;
+        fa_plan += plan.false_accept;
+
+        if (!extd && only_ids && n >= 2) {
+            uint32_t ids[8];
+            for (int i = 0; i < n; i++) ids[i] = ranges[i].lo;
+            uint64_t best = brute_force(ids, n);
+            compared++;
+            if (plan.accepted == best) optimal++;
+            else gap_sum += (double)(plan.accepted - best) / best;
+        }
+    }
+    int total = cases + 8;
+    printf("무작위 목록 %d 개 (표준 %d, 확장 8): 오류 %d, dual 선택 %d\n", total, cases, failures, duals);
+    printf("  평균 false accept: 필터 하나 %.1f%% -> 계산 결과 %.1f%%\n", fa_single / total * 100,
+           fa_plan / total * 100);
+    if (compared > 0) {
+        printf("  표준 ID 목록 %d 개를 모든 나눔과 비교: 최적 %d (%.1f%%), 나머지는 평균 %.1f%% 더 통과\n", compared,
+               optimal, 100.0 * optimal / compared, compared > optimal ? gap_sum / (compared - optimal) * 100 : 0);
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    bool extd = false;
+    const char *list = NULL;
+    int cases = -1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-x") == 0) extd = true;
+        else if (strcmp(argv[i], "-t") == 0) cases = i + 1 < argc ? atoi(argv[++i]) : 2000;
+        else list = argv[i];
+    }
+    if (cases > 0) return run_tests(cases);
+    if (list == NULL) {
+        fprintf(stderr, "usage: %s [-x] \"0x100,0x200-0x2FF\" | -t [cases]\n", argv[0]);
+        return 2;
+    }
+
+    can_filter_range_t ranges[CAN_FILTER_MAX_RANGES];
+    int n = can_filter_parse(list, extd, ranges, CAN_FILTER_MAX_RANGES);
+    can_filter_plan_t plan;
+    if (n <= 0 || !can_filter_plan(ranges, n, extd, &plan)) {
+        fprintf(stderr, "잘못된 ID 목록: %s\n", list);
+        return 2;
+    }
+    printf("%s (%s ID, 항목 %d 개)\n", list, extd ? "확장" : "표준", n);
+    print_plan(&plan);
+    uint64_t accepted;
+    uint64_t missed = verify(&plan, ranges, n, &accepted);
+    printf("  확인: 떨어진 원하는 ID %llu, 통과 %llu (%s)\n", (unsigned long long)missed,
+           (unsigned long long)accepted, missed == 0 && accepted == plan.accepted ? "OK" : "오류!");
+    printf("  twai_filter_config_t f_config = { .acceptance_code = 0x%08lX, .acceptance_mask = 0x%08lX, "
+           ".single_filter = %s };\n", (unsigned long)plan.acceptance_code, (unsigned long)plan.acceptance_mask,
+           plan.single_filter ? "true" : "false");
+    return missed == 0 && accepted == plan.accepted ? 0 : 1;
+}
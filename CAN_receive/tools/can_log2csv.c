@@ -0,0 +1,121 @@
+// --- [CAN 바이너리 로그 -> CSV 변환 (PC 용)] ---
+// SD 카드의 .can 파일(main/can_record.h 형식)을 로거가 예전에 직접 쓰던 것과 같은 CSV 로 바꿉니다.
+// 해석은 로거 화면 출력과 같은 신호 표 (기본은 can_record.c 의 버튼 0x100 / 온습도 0x200 / 가속도 0x300) 와
+// 같은 can_record_format_csv() 를 씀.
+//  -d : 기본 표 대신 .dbc 파일 (로거 SD 카드의 signals.dbc 와 같은 것)
+//  -a : 해석하지 않는 ID 도 원본 바이트로 출력 ("RAW, 0x123, 8, 01 02 ...")
+//  -s : 마지막에 ID 별 프레임 수를 stderr 로
+// 머리줄은 로거가 SD 카드에 쓰던 순서대로: 부팅 이벤트 줄 (SYSTEM_START) 바로 다음에, 부팅 이벤트로
+// 시작하지 않는 파일 (나눠진 뒤쪽 파일 등) 은 맨 앞에.
+// 파일 끝이 레코드 중간에서 잘렸으면(전원 차단 등) 거기까지만 변환.
+// 미리 잡아 둔 파일을 닫지 못하고 꺼졌으면 쓴 데 뒤가 0 으로 채워져 있음: 0 레코드가 나오면 거기까지.
+//
+// 빌드 & 실행 (CAN_receive/tools 폴더에서):
+//   gcc -O2 -I../main -o can_log2csv can_log2csv.c ../main/can_record.c ../main/can_dbc.c -lm
+//   ./can_log2csv [-a] [-s] [-d signals.dbc] 20260111_153000.can > 20260111_153000.csv
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "can_record.h"
+
+#define MAX_IDS 256
+
+typedef struct {
+    uint32_t id;
+    uint8_t flags;
+    unsigned long count;
+} id_count_t;
+
+static id_count_t ids[MAX_IDS];
+static int id_total;
+
+static void count_id(const can_record_t *r) {
+    for (int i = 0; i < id_total; i++) {
+        if (ids[i].id == r->id && ids[i].flags == r->flags) {
+            ids[i].count++;
+            return;
+        }
+    }
+    if (id_total < MAX_IDS) ids[id_total++] = (id_count_t){ r->id, r->flags, 1 };
+}
+
+int main(int argc, char **argv) {
+    bool all = false, summary = false;
+    const char *dbc_path = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "asd:")) != -1) {
+        if (opt == 'a') all = true;
+        else if (opt == 's') summary = true;
+        else if (opt == 'd') dbc_path = optarg;
+        else optind = argc + 1;
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-a] [-s] [-d signals.dbc] file.can > file.csv\n", argv[0]);
+        return 2;
+    }
+
+    // 신호 표 (로거와 같은 크기 제한은 없음: PC 라서 넉넉하게)
+    can_dbc_t db;
+    if (!can_dbc_init(&db, 4096, 16384)) return 1;
+    if (dbc_path != NULL) {
+        if (can_dbc_load_file(&db, dbc_path) < 0) {
+            perror(dbc_path);
+            return 1;
+        }
+    } else {
+        can_dbc_load_table(&db, can_record_signals, can_record_num_signals);
+    }
+    if (!can_dbc_build(&db)) return 1;
+    FILE *f = fopen(argv[optind], "rb");
+    if (f == NULL) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    can_record_t rec;
+    if (fread(&rec, sizeof(rec), 1, f) != 1 || !can_record_is_header(&rec)) {
+        fprintf(stderr, "%s: CAN 로그 파일이 아님 (머리말 없음)\n", argv[optind]);
+        return 1;
+    }
+    const can_record_header_t *h = (const can_record_header_t *)&rec;
+    if (h->version != CAN_RECORD_VERSION || h->record_size != sizeof(can_record_t)) {
+        fprintf(stderr, "지원하지 않는 버전 %u (레코드 %u 바이트)\n", h->version, h->record_size);
+        return 1;
+    }
+
+    static const char csv_header[] = "TimeStamp, Sensor_Type, Data1, Data2, Data3\n";
+    bool header_done = false;
+    unsigned long records = 0;
+    char line[1024];
+    static const can_record_t empty;
+    while (fread(&rec, sizeof(rec), 1, f) == 1) {
+        if (memcmp(&rec, &empty, sizeof(rec)) == 0) break; // 미리 잡은 자리 (여기부터 안 씀)
+        if (can_record_is_header(&rec)) continue; // 이어서 쓴 자리
+        records++;
+        if (summary) count_id(&rec);
+        bool boot = (rec.flags & CAN_REC_EVENT) && rec.id == CAN_EVENT_BOOT;
+        if (!boot && !header_done) {
+            fputs(csv_header, stdout);
+            header_done = true;
+        }
+        int n = can_record_format_csv(&db, &rec, all, line, sizeof(line));
+        if (n > 0) fputs(line, stdout);
+        if (boot) {
+            fputs(csv_header, stdout);
+            header_done = true;
+        }
+    }
+    if (!header_done) fputs(csv_header, stdout);
+    fclose(f);
+    can_dbc_free(&db);
+
+    if (summary) {
+        fprintf(stderr, "레코드 %lu개\n", records);
+        for (int i = 0; i < id_total; i++) {
+            fprintf(stderr, "  %s 0x%03lX: %lu\n", ids[i].flags & CAN_REC_EVENT ? "이벤트" : "ID",
+                    (unsigned long)ids[i].id, ids[i].count);
+        }
+    }
+    return 0;
+}
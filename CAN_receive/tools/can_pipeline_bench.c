@@ -0,0 +1,213 @@
+// --- [CAN 수신 파이프라인 벤치마크 (PC 용)] ---
+// 500 kbit/s 버스를 빈틈없이 채우는 프레임을 실제 시간에 맞춰 만들어서 main/can_ring.c + main/can_log.c 로
+// 기록해 보고, 잃은 프레임이 있는지 셉니다. SD 카드는 실제 파일에 쓰되 지연을 흉내 냄:
+//   버퍼 하나(8 KB) 쓰기마다 -w ms, -e 번째 쓰기마다 -k ms 더 멈춤 (FAT 할당 / 카드 내부 정리)
+// 모드:
+//   기본 : 수신 스레드 -> 링(4096) -> 기록 스레드 -> 핑퐁 버퍼 -> SD 스레드  (main.c 와 같은 구조)
+//   -i   : 예전 구조. 한 루프가 받고 카드에도 직접 씀 (링 = TWAI 드라이버 큐 64 개)
+// 두 모드를 같은 조건으로 돌려서 비교. 프레임 시각 자리에 번호를 넣어 두고, 다 쓴 뒤 파일을 다시 읽어
+// 개수와 순서를 확인함.
+//
+// 빌드 & 실행 (CAN_receive/tools 폴더에서):
+//   gcc -O2 -I../main -o can_pipeline_bench can_pipeline_bench.c ../main/can_ring.c ../main/can_log.c ../main/can_record.c ../main/can_dbc.c -lm -lpthread
+//   ./can_pipeline_bench [-i] [-t seconds] [-d dlc] [-w ms] [-k ms] [-e n]
+//   (-d 0 이 프레임 수가 가장 많은 최악의 경우: 초당 약 10600 프레임)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include "can_record.h"
+#include "can_ring.h"
+#include "can_log.h"
+
+#define BUS_BPS         500000
+#define RING_SIZE       4096    // CONFIG_CAN_RX_RING_SIZE 기본값
+#define TWAI_QUEUE_LEN  64      // main.c 의 TWAI_RX_QUEUE_LEN
+#define LOG_POLL_MS     10
+#define LOG_PATH        "/tmp/can_pipeline_bench.can"
+
+static int seconds = 10, dlc = 8, inline_mode = 0;
+static int write_ms = 8, spike_ms = 150, spike_every = 20;
+
+static can_record_t slots[RING_SIZE];
+static can_ring_t ring;
+static sem_t log_wake, sd_wake;
+static atomic_int rx_done, sd_stop;
+static uint64_t generated;
+static uint32_t sd_calls;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void sleep_us(long us) {
+    struct timespec ts = { us / 1000000, (us % 1000000) * 1000L };
+    nanosleep(&ts, NULL);
+}
+
+// 표준 ID 데이터 프레임 한 개의 비트 수 (비트 스터핑 없이 = 가장 짧게 = 초당 프레임이 가장 많게)
+static int frame_bits(int n) {
+    return 47 + 8 * n;
+}
+
+static int inline_pending; // 예전 구조: 넘겨받았지만 아직 쓰지 않은 버퍼 수
+
+// 카드 쓰기 한 번 (지연은 버퍼를 넘겨받은 채로 기다려야 하므로 can_log_service 앞에서)
+static void sd_write_one(void) {
+    sd_calls++;
+    long ms = write_ms + (spike_every > 0 && sd_calls % spike_every == 0 ? spike_ms : 0);
+    sleep_us(ms * 1000L);
+    can_log_service();
+}
+
+// kick 한 번 = 넘긴 버퍼 하나
+static void kick(void) {
+    if (inline_mode) inline_pending++;
+    else sem_post(&sd_wake);
+}
+
+// 버스 + 수신 태스크: 프레임이 들어올 시각에 맞춰 링에 넣음
+static void *rx_thread(void *arg) {
+    double start = now_s(), frame_s = (double)frame_bits(dlc) / BUS_BPS;
+    uint64_t total = (uint64_t)(seconds / frame_s);
+    for (uint64_t i = 0; i < total;) {
+        uint64_t due = (uint64_t)((now_s() - start) / frame_s);
+        if (due > total) due = total;
+        for (; i < due; i++) {
+            can_record_t rec = { .time_us = i, .id = 0x100 + (uint32_t)(i % 0x500), .dlc = (uint8_t)dlc };
+            memcpy(rec.data, &i, 8);
+            bool was_empty = can_ring_count(&ring) == 0;
+            if (can_ring_push(&ring, &rec) && was_empty) sem_post(&log_wake);
+        }
+        sleep_us(200);
+    }
+    generated = total;
+    atomic_store(&rx_done, 1);
+    sem_post(&log_wake);
+    return NULL;
+}
+
+static void *sd_thread(void *arg) {
+    while (!atomic_load(&sd_stop)) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += 50 * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) { ts.tv_sec++; ts.tv_nsec -= 1000000000L; }
+        if (sem_timedwait(&sd_wake, &ts) != 0) continue;
+        // main.c 의 sd_write_task 와 같이: 다 쓸 때마다 기록 스레드를 깨움
+        sd_write_one();
+        sem_post(&log_wake);
+    }
+    return NULL;
+}
+
+// 기록 루프 (main.c 의 app_main while 문)
+static void log_loop(void) {
+    for (;;) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += LOG_POLL_MS * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) { ts.tv_sec++; ts.tv_nsec -= 1000000000L; }
+        sem_timedwait(&log_wake, &ts);
+
+        const can_record_t *rx;
+        while ((rx = can_ring_peek(&ring)) != NULL) {
+            can_record_t rec = *rx;
+            if (!can_log_write(&rec, sizeof(rec))) break;
+            can_ring_pop(&ring);
+            can_log_on_id(rec.id);
+            // 예전 구조: 버퍼가 넘어가면 그 자리에서 카드에 씀 (그동안 아무것도 받지 못함)
+            for (; inline_pending > 0; inline_pending--) sd_write_one();
+        }
+        can_log_poll();
+        for (; inline_pending > 0; inline_pending--) sd_write_one();
+        if (atomic_load(&rx_done) && can_ring_count(&ring) == 0) return;
+    }
+}
+
+// 파일을 다시 읽어 개수와 순서 확인. 읽은 레코드 수 (순서가 틀리면 -1)
+static long verify(void) {
+    FILE *f = fopen(LOG_PATH, "rb");
+    if (f == NULL) return -1;
+    can_record_t rec;
+    long n = 0;
+    int64_t last = -1;
+    while (fread(&rec, sizeof(rec), 1, f) == 1) {
+        if (can_record_is_header(&rec)) continue;
+        if ((int64_t)rec.time_us <= last) {
+            fclose(f);
+            return -1;
+        }
+        last = (int64_t)rec.time_us;
+        n++;
+    }
+    fclose(f);
+    return n;
+}
+
+int main(int argc, char **argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "it:d:w:k:e:")) != -1) {
+        switch (opt) {
+            case 'i': inline_mode = 1; break;
+            case 't': seconds = atoi(optarg); break;
+            case 'd': dlc = atoi(optarg); break;
+            case 'w': write_ms = atoi(optarg); break;
+            case 'k': spike_ms = atoi(optarg); break;
+            case 'e': spike_every = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-i] [-t seconds] [-d dlc] [-w ms] [-k ms] [-e n]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (dlc < 0 || dlc > 8) dlc = 8;
+
+    can_ring_init(&ring, slots, inline_mode ? TWAI_QUEUE_LEN : RING_SIZE);
+    sem_init(&log_wake, 0, 0);
+    sem_init(&sd_wake, 0, 0);
+    remove(LOG_PATH);
+    can_log_policy_t policy = { .flush_ms = 1000 };
+    can_log_parse_ids(&policy, "0x100");
+    if (!can_log_open(LOG_PATH, &policy, kick)) {
+        perror(LOG_PATH);
+        return 1;
+    }
+
+    printf("%s: %d 초, DLC %d, 초당 %.0f 프레임 (%.0f KB/s 기록), 카드 쓰기 %d ms + %d 번째마다 %d ms\n",
+           inline_mode ? "예전 구조 (한 루프)" : "파이프라인", seconds, dlc,
+           (double)BUS_BPS / frame_bits(dlc), (double)BUS_BPS / frame_bits(dlc) * sizeof(can_record_t) / 1024,
+           write_ms, spike_every, spike_ms);
+
+    pthread_t rx, sd;
+    pthread_create(&rx, NULL, rx_thread, NULL);
+    if (!inline_mode) pthread_create(&sd, NULL, sd_thread, NULL);
+    log_loop();
+    pthread_join(rx, NULL);
+    if (!inline_mode) {
+        atomic_store(&sd_stop, 1);
+        pthread_join(sd, NULL);
+    }
+    can_log_stats_t st;
+    can_log_get_stats(&st);
+    can_log_close();
+
+    uint32_t dropped = atomic_load(&ring.dropped);
+    long stored = verify();
+    printf("  프레임 %llu, 버림 %u (%.2f%%), 링 최대 %u/%u, 버퍼 둘 다 사용 중 %u 번\n",
+           (unsigned long long)generated, dropped, 100.0 * dropped / generated,
+           ring.high_water, ring.size, st.stalls);
+    printf("  카드 쓰기 %u 번 (write() 자체 최대 %.1f ms, 흉내 낸 지연 제외), fsync %u 번\n", st.writes, st.write_max_us / 1000.0, st.fsyncs);
+    if (stored < 0) {
+        printf("  파일 확인 실패: 순서가 틀림\n");
+        return 1;
+    }
+    printf("  파일에 %ld 개 (%s)\n", stored,
+           (uint64_t)stored == generated - dropped ? "받은 것 모두, 순서대로" : "개수가 맞지 않음!");
+    return (uint64_t)stored == generated - dropped && (inline_mode || dropped == 0) ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// --- [SD 카드 확인 / 쓰기 속도 측정 (PC 용)] ---
+// main/can_sdtest.c 를 PC 에서 그대로 돌림. 로거가 부팅 때 하는 것과 같은 두 가지:
+//  - 읽어서 비교: 시험 파일을 써서 읽고 비교. 먼저 그대로 통과하는지, 그다음 read 를 가로채서
+//    (-Wl,--wrap=read) 비트 하나 / 섹터 하나 밀림 / 중간에 끊김을 넣었을 때 모두 잡아내는지 확인
+//  - 쓰기 속도: 블록 크기마다 같은 양을 이어서 쓰고 MB/s 와 write 한 번의 시간 (menuconfig 의 SD 벤치마크와 같은 표)
+// 폴더를 PC 에 꽂은 SD 카드로 주면 같은 카드를 PC 에서 잴 수 있음 (PC 는 캐시가 있어서 write 는 빠르고 fsync 가 큼).
+//
+// 빌드 & 실행 (CAN_receive/tools 폴더에서):
+//   gcc -O2 -I../main -o can_sd_bench can_sd_bench.c ../main/can_sdtest.c -Wl,--wrap=read
+//   ./can_sd_bench [-d folder] [-s 512,4096,8192,32768] [-k KB per size] [-v verify KB]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "can_sdtest.h"
+
+// --- [read 가로채기: 읽은 데이터를 망가뜨림] ---
+enum { FAULT_NONE, FAULT_BITFLIP, FAULT_SHIFT, FAULT_SHORT };
+static int fault;
+static long fault_at = 100000;     // 이 바이트 위치 근처에서
+static long read_pos;
+
+ssize_t __real_read(int fd, void *buf, size_t len);
+ssize_t __wrap_read(int fd, void *buf, size_t len) {
+    ssize_t n = __real_read(fd, buf, len);
+    if (n <= 0 || fault == FAULT_NONE) return n;
+    long start = read_pos;
+    read_pos += n;
+    if (fault_at < start || fault_at >= read_pos) return n;
+    uint8_t *p = buf;
+    long at = fault_at - start;
+    switch (fault) {
+    case FAULT_BITFLIP:     // 선 하나가 한 번 튐
+        p[at] ^= 0x10;
+        break;
+    case FAULT_SHIFT:       // 섹터 하나를 앞 섹터로 (주소가 밀림)
+        at -= at % 512;
+        if (at >= 512) memcpy(p + at, p + at - 512, n - at < 512 ? n - at : 512);
+        else p[at] ^= 1;
+        break;
+    case FAULT_SHORT:       // 카드가 응답하지 않음
+        return -1;
+    }
+    return n;
+}
+
+static int64_t host_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int main(int argc, char **argv) {
+    const char *dir = "/tmp", *size_list = "512,4096,8192,32768";
+    long bench_kb = 16384, verify_kb = 256;
+    int opt;
+    while ((opt = getopt(argc, argv, "d:s:k:v:")) != -1) {
+        switch (opt) {
+        case 'd': dir = optarg; break;
+        case 's': size_list = optarg; break;
+        case 'k': bench_kb = atol(optarg); break;
+        case 'v': verify_kb = atol(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-d folder] [-s sizes] [-k KB] [-v KB]\n", argv[0]);
+            return 2;
+        }
+    }
+    size_t sizes[CAN_SDTEST_MAX_SIZES], max = 32 * 1024;
+    int n = can_sdtest_parse_sizes(size_list, sizes, CAN_SDTEST_MAX_SIZES);
+    if (n <= 0) {
+        fprintf(stderr, "bad size list: %s\n", size_list);
+        return 2;
+    }
+    for (int i = 0; i < n; i++) {
+        if (sizes[i] > max) max = sizes[i];
+    }
+    char path[512];
+    snprintf(path, sizeof(path), "%s/SDTEST.TMP", dir);
+    void *buf = malloc(max);
+    int errors = 0;
+
+    // 1. 읽어서 비교 (로거와 같은 32 KB 버퍼)
+    static const char *names[] = { "clean", "bit flip", "sector shift", "read error" };
+    size_t verify_bytes = (size_t)verify_kb * 1024;
+    if (fault_at >= (long)verify_bytes) fault_at = (long)verify_bytes / 2 + 7;
+    for (int f = FAULT_NONE; f <= FAULT_SHORT; f++) {
+        fault = f;
+        read_pos = 0;
+        bool ok = can_sdtest_verify(path, buf, 32 * 1024, verify_bytes, 20000);
+        bool expect = f == FAULT_NONE;
+        printf("verify %-13s %s%s\n", names[f], ok ? "pass" : "FAIL", ok == expect ? "" : "   <-- wrong");
+        if (ok != expect) errors++;
+        if (access(path, F_OK) == 0) {
+            printf("  test file left behind\n");
+            errors++;
+        }
+    }
+    fault = FAULT_NONE;
+
+    // 2. 쓰기 속도
+    can_sdtest_result_t res[CAN_SDTEST_MAX_SIZES];
+    if (!can_sdtest_bench(path, buf, max, sizes, n, (uint64_t)bench_kb * 1024, host_now_us, res)) errors++;
+    printf("\n%8s %8s %10s %12s %12s %12s\n", "block", "writes", "MB/s", "avg us", "max us", "fsync us");
+    for (int i = 0; i < n; i++) {
+        printf("%8zu %8u %10.2f %12u %12u %12u%s\n", res[i].block, res[i].writes, res[i].mb_s, res[i].avg_us,
+               res[i].max_us, res[i].fsync_us, res[i].ok ? "" : "  FAILED");
+        if (res[i].ok && res[i].bytes != (uint64_t)bench_kb * 1024 / res[i].block * res[i].block) errors++;
+    }
+    free(buf);
+    printf("\n%s (%d errors)\n", errors ? "FAILED" : "OK", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,324 @@
+// --- [로그 세그먼트 벤치마크 (PC 용)] ---
+// main/can_log.c 를 PC 에서 그대로 돌려서 (1) 파일 하나를 늘려 가며 쓸 때와 (2) 미리 잡아 둔 고정 크기
+// 파일로 나눠 쓸 때의 "버퍼 하나를 카드로 보내는 시간" 분포를 비교하고, 나눈 파일이 맞는지 확인합니다.
+//
+// SD 카드는 실제 파일에 쓰되 시간은 흉내 냄 (write/fsync/ftruncate/rename 을 -Wl,--wrap 으로 가로챔).
+// 카드는 한 번에 하나만 (잠금), 흉내 낸 시간 동안 잠금을 잡고 잠:
+//  - 이어지는 데이터 쓰기: 0.3 ms + 크기 / -r MB/s
+//  - 작은 자리 쓰기 (FAT 섹터, 디렉터리 항목, FSInfo): -m ms, 그중 -g % 는 카드 내부 정리로 -k ms 더
+//    (데이터 영역과 FAT 영역을 오가며 쓰면 카드가 열어 둔 블록을 닫고 정리해야 해서 가끔 크게 멈춤)
+//  - FatFs 처럼: 파일이 커진 뒤의 fsync = FAT 2벌 + FSInfo + 디렉터리 = 작은 쓰기 4번,
+//    크기가 그대로인 fsync = 디렉터리 1번, 파일이 커지며 FAT 섹터(클러스터 128개)를 넘어가면 FAT 2번,
+//    ftruncate = 4번, rename = 1번. 클러스터는 16 KB (main.c 의 allocation_unit_size)
+// 흉내 낸 값이므로 절대 시간보다 두 방식의 차이를 보는 용도. 실제 카드의 값은 로거의 [SD] 통계 줄 (p50/p99/p99.9).
+//
+// 기록: -b KB/s 로 24 바이트 레코드 (번호를 time_us 에), 1초마다 flush. 세그먼트 모드는 -s MB 마다 넘어가고,
+// -R 초마다 can_log_rotate (정시 넘어가기 대신). 미리 잡기 스레드는 조각마다 1 ms 쉼.
+// 확인: 파일마다 머리말로 시작, 레코드 번호가 파일을 넘어가며 빠짐없이 이어짐, 닫은 파일 끝에 0 이 없음.
+//
+// 빌드 & 실행 (CAN_receive/tools 폴더에서):
+//   gcc -O2 -I../main -o can_segment_bench can_segment_bench.c ../main/can_log.c ../main/can_record.c ../main/can_dbc.c -lm -lpthread -Wl,--wrap=write,--wrap=fsync,--wrap=ftruncate,--wrap=rename
+//   ./can_segment_bench [-t seconds] [-b KB/s] [-s MB] [-R seconds] [-r MB/s] [-m ms] [-g %] [-k ms]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include "can_record.h"
+#include "can_log.h"
+
+#define DIR_PATH    "/tmp/can_segment_bench.d"
+#define CLUSTER     (16 * 1024)
+#define FAT_SECTOR_CLUSTERS 128     // FAT32 섹터 하나 = 클러스터 128 개
+
+static int seconds = 30, rotate_s = 10;
+static double bus_kbps = 192, seg_mb = 2, rate_mbps = 2.0, small_ms = 3, gc_percent = 2, gc_ms = 150;
+
+ssize_t __real_write(int fd, const void *buf, size_t n);
+int __real_fsync(int fd);
+int __real_ftruncate(int fd, off_t len);
+int __real_rename(const char *from, const char *to);
+
+// --- [SD 카드 흉내] ---
+static pthread_mutex_t card = PTHREAD_MUTEX_INITIALIZER;
+static off_t synced_size[1024];     // fd 별 마지막 fsync 때 크기
+static uint32_t rng = 12345;
+static unsigned small_count, gc_count; // 작은 자리 쓰기 / 그중 정리로 멈춘 수
+
+static uint32_t rand_u32(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void sleep_us(double us) {
+    if (us <= 0) return;
+    struct timespec ts = { (time_t)(us / 1e6), (long)(us - (long)(us / 1e6) * 1e6) * 1000L };
+    nanosleep(&ts, NULL);
+}
+
+// 작은 자리 쓰기 n 번 (카드 잠금 안에서)
+static double small_writes(int n) {
+    double us = 0;
+    for (int i = 0; i < n; i++) {
+        us += small_ms * 1000;
+        small_count++;
+        if (rand_u32() % 10000 < gc_percent * 100) {
+            us += gc_ms * 1000;
+            gc_count++;
+        }
+    }
+    return us;
+}
+
+static off_t file_size(int fd) {
+    struct stat st;
+    return fstat(fd, &st) == 0 ? st.st_size : 0;
+}
+
+ssize_t __wrap_write(int fd, const void *buf, size_t n) {
+    if (fd < 3) return __real_write(fd, buf, n);
+    pthread_mutex_lock(&card);
+    off_t pos = lseek(fd, 0, SEEK_CUR), size = file_size(fd);
+    double us = 300 + n / rate_mbps;
+    if (pos + (off_t)n > size) { // 파일이 커짐: FAT 섹터를 넘어가면 앞 섹터를 2벌 씀
+        long before = (long)((size + CLUSTER - 1) / CLUSTER) / FAT_SECTOR_CLUSTERS;
+        long after = (long)((pos + (off_t)n + CLUSTER - 1) / CLUSTER) / FAT_SECTOR_CLUSTERS;
+        if (after != before) us += small_writes(2);
+    }
+    sleep_us(us);
+    ssize_t r = __real_write(fd, buf, n);
+    pthread_mutex_unlock(&card);
+    return r;
+}
+
+int __wrap_fsync(int fd) {
+    pthread_mutex_lock(&card);
+    off_t size = file_size(fd);
+    bool grew = fd < 1024 && size != synced_size[fd];
+    if (fd < 1024) synced_size[fd] = size;
+    sleep_us(small_writes(grew ? 4 : 1));
+    int r = __real_fsync(fd);
+    pthread_mutex_unlock(&card);
+    return r;
+}
+
+int __wrap_ftruncate(int fd, off_t len) {
+    pthread_mutex_lock(&card);
+    if (fd < 1024) synced_size[fd] = len;
+    sleep_us(small_writes(4));
+    int r = __real_ftruncate(fd, len);
+    pthread_mutex_unlock(&card);
+    return r;
+}
+
+int __wrap_rename(const char *from, const char *to) {
+    pthread_mutex_lock(&card);
+    sleep_us(small_writes(1));
+    int r = __real_rename(from, to);
+    pthread_mutex_unlock(&card);
+    return r;
+}
+
+// --- [로거 흉내] ---
+static sem_t sd_wake;
+static atomic_int stop_sd, stop_alloc;
+static int segment_no;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void kick(void) {
+    sem_post(&sd_wake);
+}
+
+static void name_segment(char *path, size_t size) {
+    snprintf(path, size, DIR_PATH "/SEG%05d.CAN", segment_no++);
+}
+
+static void *sd_thread(void *arg) {
+    (void)arg;
+    while (!atomic_load(&stop_sd)) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += 10 * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) { ts.tv_sec++; ts.tv_nsec -= 1000000000L; }
+        sem_timedwait(&sd_wake, &ts);
+        while (can_log_service()) {
+        }
+    }
+    return NULL;
+}
+
+static void *alloc_thread(void *arg) {
+    (void)arg;
+    while (!atomic_load(&stop_alloc)) {
+        if (can_log_prepare()) sleep_us(1000);
+        else sleep_us(100000);
+    }
+    return NULL;
+}
+
+static void clean_dir(void) {
+    DIR *d = opendir(DIR_PATH);
+    if (d == NULL) {
+        mkdir(DIR_PATH, 0755);
+        return;
+    }
+    struct dirent *e;
+    char path[512];
+    while ((e = readdir(d)) != NULL) {
+        if (e->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), DIR_PATH "/%s", e->d_name);
+        unlink(path);
+    }
+    closedir(d);
+}
+
+static int cmp_str(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// 파일을 이름 순으로 읽어서 확인. 레코드 수 (틀리면 -1)
+static long verify(uint64_t expected, uint64_t segment_size, int *files) {
+    DIR *d = opendir(DIR_PATH);
+    char *names[4096];
+    int n = 0;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL && n < 4096) {
+        if (strncmp(e->d_name, "SEG", 3) == 0) names[n++] = strdup(e->d_name);
+    }
+    closedir(d);
+    qsort(names, n, sizeof(*names), cmp_str);
+    *files = n;
+
+    uint64_t next = 0;
+    long bad = 0;
+    for (int i = 0; i < n; i++) {
+        char path[512];
+        snprintf(path, sizeof(path), DIR_PATH "/%s", names[i]);
+        FILE *f = fopen(path, "rb");
+        struct stat st;
+        stat(path, &st);
+        if (segment_size > 0 && (uint64_t)st.st_size > segment_size) bad++;
+        if (st.st_size % sizeof(can_record_t) != 0) bad++; // 0 꼬리가 남았거나 잘림
+        can_record_t rec;
+        if (fread(&rec, sizeof(rec), 1, f) != 1 || !can_record_is_header(&rec)) bad++;
+        while (fread(&rec, sizeof(rec), 1, f) == 1) {
+            if (can_record_is_header(&rec)) continue;
+            if (rec.time_us != next) bad++;
+            next = rec.time_us + 1;
+        }
+        fclose(f);
+        free(names[i]);
+    }
+    if (bad > 0 || next != expected) {
+        printf("  확인 실패: 문제 %ld, 마지막 번호 %llu / %llu\n", bad, (unsigned long long)next,
+               (unsigned long long)expected);
+        return -1;
+    }
+    return (long)next;
+}
+
+static int run(bool segments) {
+    clean_dir();
+    segment_no = 0;
+    memset(synced_size, 0, sizeof(synced_size));
+    small_count = gc_count = 0;
+    atomic_store(&stop_sd, 0);
+    atomic_store(&stop_alloc, 0);
+
+    static can_record_header_t header;
+    can_record_header_init(&header);
+    can_log_policy_t policy = {
+        .flush_ms = 1000,
+        .segment_size = segments ? (uint64_t)(seg_mb * 1024 * 1024) : 0,
+        .segment_dir = DIR_PATH,
+        .name = name_segment,
+        .preamble = &header,
+        .preamble_len = sizeof(header),
+    };
+    char path[CAN_LOG_PATH_LEN];
+    name_segment(path, sizeof(path));
+    if (!can_log_open(path, &policy, kick)) {
+        perror(path);
+        return 1;
+    }
+    pthread_t sd, alloc;
+    pthread_create(&sd, NULL, sd_thread, NULL);
+    pthread_create(&alloc, NULL, alloc_thread, NULL);
+
+    // 1 ms 마다 그동안 들어왔어야 할 레코드를 넣음 (못 넣으면 다음에 이어서: 링이 있는 셈)
+    double start = now_s(), per_s = bus_kbps * 1024 / sizeof(can_record_t), last_rotate = start;
+    uint64_t sent = 0, total = (uint64_t)(per_s * seconds);
+    uint64_t backlog_max = 0;
+    while (sent < total) {
+        double t = now_s();
+        uint64_t due = (uint64_t)((t - start) * per_s);
+        if (due > total) due = total;
+        if (due - sent > backlog_max) backlog_max = due - sent;
+        while (sent < due) {
+            can_record_t rec = { .time_us = sent, .id = 0x123, .dlc = 8 };
+            if (!can_log_write(&rec, sizeof(rec))) break;
+            sent++;
+        }
+        can_log_poll();
+        if (segments && rotate_s > 0 && t - last_rotate >= rotate_s && can_log_rotate()) last_rotate = t;
+        sleep_us(1000);
+    }
+    atomic_store(&stop_alloc, 1);
+    pthread_join(alloc, NULL);
+    atomic_store(&stop_sd, 1);
+    pthread_join(sd, NULL);
+    can_log_stats_t st;
+    can_log_get_stats(&st);
+    can_log_close();
+
+    int files;
+    long stored = verify(total, policy.segment_size, &files);
+    printf("%s\n", segments ? "세그먼트 (미리 잡은 파일)" : "파일 하나를 늘려 감 (예전)");
+    printf("  버퍼 -> 카드: p50 %.1f ms, p99 %.1f ms, p99.9 %.1f ms, 최대 write %.1f / fsync %.1f ms\n",
+           can_log_percentile_us(&st, 500) / 1000.0, can_log_percentile_us(&st, 990) / 1000.0,
+           can_log_percentile_us(&st, 999) / 1000.0, st.write_max_us / 1000.0, st.fsync_max_us / 1000.0);
+    printf("  쓰기 %u, fsync %u, 파일 %d (미리 잡은 것 없이 %u), 미리 잡기 실패 %u, 가장 많이 밀린 레코드 %llu\n",
+           st.writes, st.fsyncs, files, st.spare_misses, st.alloc_errors, (unsigned long long)backlog_max);
+    printf("  작은 자리 쓰기 %u 번 (정리로 멈춤 %u 번, 미리 잡기 포함)\n", small_count, gc_count);
+    printf("  레코드 %llu: %s\n", (unsigned long long)total, stored >= 0 ? "모두 순서대로" : "오류!");
+    return stored >= 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "t:b:s:R:r:m:g:k:")) != -1) {
+        switch (opt) {
+            case 't': seconds = atoi(optarg); break;
+            case 'b': bus_kbps = atof(optarg); break;
+            case 's': seg_mb = atof(optarg); break;
+            case 'R': rotate_s = atoi(optarg); break;
+            case 'r': rate_mbps = atof(optarg); break;
+            case 'm': small_ms = atof(optarg); break;
+            case 'g': gc_percent = atof(optarg); break;
+            case 'k': gc_ms = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-t seconds] [-b KB/s] [-s MB] [-R seconds] [-r MB/s] [-m ms] [-g %%] [-k ms]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+    if (seg_mb < 0.0625) seg_mb = 0.0625;
+    sem_init(&sd_wake, 0, 0);
+    printf("%d 초씩, %.0f KB/s, 세그먼트 %.1f MB (+%d 초마다 넘어감), 카드 %.1f MB/s, 작은 쓰기 %.0f ms (%.0f%% 는 +%.0f ms)\n",
+           seconds, bus_kbps, seg_mb, rotate_s, rate_mbps, small_ms, gc_percent, gc_ms);
+    int r = run(false);
+    r |= run(true);
+    return r;
+}
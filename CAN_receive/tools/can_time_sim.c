@@ -0,0 +1,121 @@
+// --- [CAN 로그 시각 시뮬레이션 (PC 용)] ---
+// main/can_time.c 에 가짜 DS3231 초 에지를 넣고, 프레임 시각이 RTC 와 얼마나 다른지 잽니다.
+//  - esp_timer: RTC 보다 +25 ppm 빠르고, 온도 변화처럼 15분 주기로 +-1 ppm 흔들림
+//  - SQW 모드(기본): 매초 하강 에지, ISR 지연 2~8 us. 60초마다 RTC 를 읽어 몇 초인지 확인
+//    300~310초: SQW 에지가 끊김 (드리프트로만 계산)
+//  - 읽기 모드(-p): 60초마다 초 레지스터를 읽어서 에지를 찾음, 에지 오차 +-300 us (읽기 한 번 약 0.5 ms)
+//  - 1230초: 누가 RTC 를 2초 앞으로 맞춤 (새로 잡는지 확인, 그 뒤 60초는 통계에서 뺌)
+// 1 ms 마다 can_time_to_rtc() 결과와 실제 RTC 시각의 차이를 모으고, 시각이 거꾸로 간 적이 있는지 확인.
+// 비교: 예전처럼 프레임마다 RTC 를 읽으면 1초 단위라 평균 500 ms, 최대 1초 늦음.
+//
+// 빌드 & 실행 (CAN_receive/tools 폴더에서):
+//   gcc -O2 -I../main -o can_time_sim can_time_sim.c ../main/can_time.c -lm
+//   ./can_time_sim [seconds]        (기본 1800초)
+//   ./can_time_sim -p [seconds]     (SQW 없이 읽어서 찾기)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "can_time.h"
+
+#define RTC_BASE_S      1768620310LL    // 2026-01-17 03:25:10
+#define LOCAL_BASE_US   3000000LL       // 부팅 후 3초에 처음 에지
+#define QUERY_STEP_US   1000
+#define RESYNC_S        60              // CONFIG_CAN_RTC_RESYNC_S 기본값
+#define STEP_AT_S       1230
+#define STEP_S          2
+
+static uint32_t rng = 12345;
+static uint32_t rand_u32(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+static int64_t rand_range(int64_t lo, int64_t hi) {
+    return lo + rand_u32() % (uint32_t)(hi - lo + 1);
+}
+
+// RTC 경과 시간(us) -> esp_timer 값. 주파수 오차를 적분
+static double true_ppm(double t_s) {
+    return 25.0 + 1.0 * sin(2 * M_PI * t_s / 900.0);
+}
+static int64_t local_at(int64_t t_us) {
+    double t = t_us / 1e6;
+    double extra = 25.0 * t - 900.0 / (2 * M_PI) * (cos(2 * M_PI * t / 900.0) - 1.0);
+    return LOCAL_BASE_US + t_us + (int64_t)llround(extra);
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+int main(int argc, char **argv) {
+    int polling = 0, seconds = 1800;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0) polling = 1;
+        else seconds = atoi(argv[i]);
+    }
+    if (seconds <= STEP_AT_S + RESYNC_S * 2) {
+        fprintf(stderr, "seconds must be > %d\n", STEP_AT_S + RESYNC_S * 2);
+        return 2;
+    }
+
+    can_time_t t;
+    can_time_init(&t);
+    size_t cap = (size_t)seconds * (1000000 / QUERY_STEP_US);
+    uint32_t *errs = malloc(cap * sizeof(*errs));
+    size_t n = 0;
+    double err_sum = 0;
+    long backwards = 0, max_back_us = 0;
+    int64_t last_out = INT64_MIN;
+    uint32_t step_max = 0;
+
+    for (int64_t tu = 0; tu < (int64_t)seconds * 1000000; tu += QUERY_STEP_US) {
+        int64_t k = tu / 1000000;
+        int64_t rtc_offset_s = k >= STEP_AT_S ? STEP_S : 0;
+
+        // 초 에지 (RTC 가 k 초로 바뀐 순간)
+        if (tu % 1000000 == 0) {
+            int64_t rtc_s = RTC_BASE_S + k + rtc_offset_s;
+            if (polling) {
+                if (k % RESYNC_S == 0) can_time_edge(&t, local_at(tu) + rand_range(-300, 300), rtc_s);
+            } else if (k < 300 || k >= 310) {
+                int64_t edge = local_at(tu) + rand_range(2, 8);
+                if (k % RESYNC_S == 0) can_time_edge(&t, edge, rtc_s);  // RTC 를 읽어 확인
+                else can_time_tick(&t, edge);
+            }
+        }
+
+        // 프레임 하나를 이 순간에 받았다고 치고 시각 계산
+        int64_t out;
+        if (!can_time_to_rtc(&t, local_at(tu), &out)) continue;
+        if (out < last_out) {
+            backwards++;
+            if (last_out - out > max_back_us) max_back_us = (long)(last_out - out);
+        }
+        last_out = out;
+
+        int64_t truth = (RTC_BASE_S + rtc_offset_s) * 1000000 + tu;
+        uint32_t e = (uint32_t)llabs(out - truth);
+        if (k >= STEP_AT_S && k < STEP_AT_S + RESYNC_S) { // RTC 를 바꾼 직후 (SQW 는 다음 확인 때 맞춰짐)
+            if (e > step_max) step_max = e;
+            continue;
+        }
+        errs[n++] = e;
+        err_sum += e;
+    }
+
+    qsort(errs, n, sizeof(*errs), cmp_u32);
+    printf("%s, %d 초, esp_timer +25 ppm (+-1 ppm)\n", polling ? "읽어서 찾기 (SQW 없음)" : "SQW", seconds);
+    printf("  |오차|: 평균 %.1f us, 중간 %u us, 99%% %u us, 최대 %u us  (예전 1초 단위: 평균 500000 us)\n",
+           err_sum / n, errs[n / 2], errs[n * 99 / 100], errs[n - 1]);
+    printf("  드리프트 추정 %+.3f ppm (실제 %+.3f ppm), 에지 %u, 새로 잡음 %u, 마지막 에지 오차 %d us\n",
+           t.drift_ppb / 1000.0, -true_ppm(seconds), t.edges, t.steps, t.last_error_us);
+    printf("  RTC 를 %d 초 바꾼 뒤 %d 초 동안 최대 오차 %.3f s (다음 확인에서 새로 잡기 전까지)\n",
+           STEP_S, RESYNC_S, step_max / 1e6);
+    printf("  시각이 거꾸로 간 횟수 %ld (최대 %ld us)\n", backwards, max_back_us);
+    free(errs);
+    return backwards == 0 && t.steps == 2 ? 0 : 1;
+}
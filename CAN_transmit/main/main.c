@@ -18,6 +18,16 @@ static const char *TAG = "CAN_Transmit";    // 로그 태그
 #define I2C_MASTER_SCL_IO   5  //가속도 센서 SCL 핀 번호
 #define I2C_MASTER_SDA_IO   6  //가속도 센서 SDA 핀 번호
 
+// 수신 필터: 일부러 수신을 사실상 끔. 이 보드는 받은 메시지를 쓰지 않고 (아래 수신 루프는 화면 출력뿐),
+// 모두 받으면 바쁜 버스에서 수신 루프가 끝나지 않아 센서 전송이 멈추기 때문.
+// 통과시키는 0x100, 0x200, 0x300 은 이 보드 자신이 보내는 ID 이고, normal 모드에서는 자기 프레임을
+// 받지 않으므로 보통은 아무것도 들어오지 않음 (같은 펌웨어 보드를 한 버스에 더 달았을 때만 그 프레임이 보임).
+// 이 보드가 쓸 메시지가 생기면 그 ID 로 다시 계산:  CAN_receive/tools/can_filter_plan "0x100,0x200,0x300"
+// (dual 필터: 필터1 = 0x100, 필터2 = 0x200/0x300 -> 원하지 않는 ID 통과 0%)
+#define RX_FILTER_CODE      0x20004000
+#define RX_FILTER_MASK      0x001F201F
+#define RX_FILTER_SINGLE    false
+
 //[MPU6500-I2C설정
 #define I2C_MASTER_NUM              0     // I2C 포트 0번 사용
 #define I2C_MASTER_FREQ_HZ          400000 // 속도 400kHz
@@ -51,7 +61,11 @@ void app_main(void)
     // 1. 설정 구조체 초기화 (TWAI 접두어 사용)
     twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(TX_GPIO_NUM, RX_GPIO_NUM, TWAI_MODE_NORMAL);
     twai_timing_config_t t_config = TWAI_TIMING_CONFIG_500KBITS(); // 속도 500kbps
-    twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL(); // 모든 ID 수신
+    twai_filter_config_t f_config = {
+        .acceptance_code = RX_FILTER_CODE,
+        .acceptance_mask = RX_FILTER_MASK,
+        .single_filter = RX_FILTER_SINGLE,
+    };
     // 2. 드라이버 설치 및 시작
     if (twai_driver_install(&g_config, &t_config, &f_config) == ESP_OK) {
         ESP_LOGI(TAG, "CAN Driver installed");
@@ -126,7 +140,7 @@ void app_main(void)
             last_accel_tick = current_tick;
         }
         // ==========================================
-        // [수신] 메시지 받기 (큐에 있는 것 모두 처리)
+        // [수신] 메시지 받기 (큐에 있는 것 모두 처리). 위 수신 필터 때문에 보통은 아무것도 없음
         twai_message_t rx_msg;
         
         // while문을 써서 쌓여있는 메시지를 빠르게 다 읽어옵니다.
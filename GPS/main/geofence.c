@@ -0,0 +1,300 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "geofence.h"
+
+#define E7_PER_METER_NUM 10000000 // 위도 1도 = 약 111320 m -> 1 m = 1e7 / 111320 (1e-7 도 단위)
+#define E7_PER_METER_DEN 111320
+#define CELLS_PER_FENCE  4        // 격자 칸 수 목표 = 구역 수 x 이 값
+#define ITEMS_PER_FENCE  16       // 칸 목록 총길이가 (구역 수 x 이 값 + 칸 수) 를 넘으면 칸을 키움
+
+bool geofence_init(geofence_t *gf, int max_fences, int max_vertices, geofence_cb_t cb, void *ctx) {
+    memset(gf, 0, sizeof(*gf));
+    if (max_fences <= 0 || max_fences > UINT16_MAX || max_vertices < 0) return false;
+
+    gf->fences = calloc(max_fences, sizeof(geofence_shape_t));
+    gf->vertices = calloc(max_vertices > 0 ? max_vertices : 1, sizeof(geofence_point_t));
+    gf->inside_bits = calloc((max_fences + 31) / 32, sizeof(uint32_t));
+    if (gf->fences == NULL || gf->vertices == NULL || gf->inside_bits == NULL) {
+        geofence_free(gf);
+        return false;
+    }
+    gf->max_fences = max_fences;
+    gf->max_vertices = max_vertices;
+    gf->cb = cb;
+    gf->ctx = ctx;
+    return true;
+}
+
+void geofence_free(geofence_t *gf) {
+    free(gf->fences);
+    free(gf->vertices);
+    free(gf->inside_bits);
+    free(gf->cell_start);
+    free(gf->cell_items);
+    memset(gf, 0, sizeof(*gf));
+}
+
+static bool valid_coord(int32_t lat, int32_t lon) {
+    return lat >= -90 * 10000000 && lat <= 90 * 10000000 && lon >= -180 * 10000000 && lon <= 180 * 10000000;
+}
+
+int geofence_add_circle(geofence_t *gf, int32_t lat, int32_t lon, uint32_t radius_m, uint32_t tag) {
+    if (gf->built || gf->num_fences >= gf->max_fences || !valid_coord(lat, lon) || radius_m == 0) return -1;
+
+    // 반지름을 위도 방향 1e-7 도로. 경도 방향은 cos(위도) 만큼 좁아지므로 dx 에 cos 를 곱해서 비교
+    int64_t r = (int64_t)radius_m * E7_PER_METER_NUM / E7_PER_METER_DEN;
+    int32_t cos_q16 = (int32_t)(cos(lat * (M_PI / 180.0 / 1e7)) * 65536.0);
+    if (r == 0 || cos_q16 <= 0) return -1;
+    int64_t r_lon = r * 65536 / cos_q16;
+    if (r * 2 > GEOFENCE_MAX_SPAN_E7 || r_lon * 2 > GEOFENCE_MAX_SPAN_E7) return -1; // 너무 크거나 극지방
+
+    int id = gf->num_fences++;
+    geofence_shape_t *f = &gf->fences[id];
+    memset(f, 0, sizeof(*f));
+    f->tag = tag;
+    f->center_lat = lat;
+    f->center_lon = lon;
+    f->radius2 = r * r;
+    f->cos_q16 = cos_q16;
+    f->min_lat = lat - (int32_t)r;
+    f->max_lat = lat + (int32_t)r;
+    f->min_lon = lon - (int32_t)r_lon;
+    f->max_lon = lon + (int32_t)r_lon;
+    return id;
+}
+
+int geofence_add_polygon(geofence_t *gf, const geofence_point_t *pts, int n, uint32_t tag) {
+    if (gf->built || gf->num_fences >= gf->max_fences || n < 3 || n > UINT16_MAX ||
+        n > gf->max_vertices - gf->num_vertices) {
+        return -1;
+    }
+
+    int32_t min_lat = pts[0].lat, max_lat = pts[0].lat, min_lon = pts[0].lon, max_lon = pts[0].lon;
+    for (int i = 0; i < n; i++) {
+        if (!valid_coord(pts[i].lat, pts[i].lon)) return -1;
+        if (pts[i].lat < min_lat) min_lat = pts[i].lat;
+        if (pts[i].lat > max_lat) max_lat = pts[i].lat;
+        if (pts[i].lon < min_lon) min_lon = pts[i].lon;
+        if (pts[i].lon > max_lon) max_lon = pts[i].lon;
+    }
+    // 교차 검사에서 (좌표 차이 x 좌표 차이) 가 int64 를 넘지 않도록 크기 제한
+    if ((int64_t)max_lat - min_lat > GEOFENCE_MAX_SPAN_E7 || (int64_t)max_lon - min_lon > GEOFENCE_MAX_SPAN_E7) {
+        return -1;
+    }
+
+    int id = gf->num_fences++;
+    geofence_shape_t *f = &gf->fences[id];
+    memset(f, 0, sizeof(*f));
+    f->tag = tag;
+    f->first_vertex = (uint32_t)gf->num_vertices;
+    f->num_vertices = (uint16_t)n;
+    f->min_lat = min_lat;
+    f->max_lat = max_lat;
+    f->min_lon = min_lon;
+    f->max_lon = max_lon;
+    memcpy(&gf->vertices[gf->num_vertices], pts, n * sizeof(geofence_point_t));
+    gf->num_vertices += n;
+    return id;
+}
+
+// --- [정확한 포함 검사] ---
+// 다각형: 점에서 동쪽으로 그은 반직선이 변을 몇 번 지나는지 (홀수면 안).
+// 교점 x 를 나눗셈 없이 곱셈 비교로 구함 (좌표는 구역 모서리 기준으로 작게 만들어서 곱셈이 넘치지 않음)
+static bool polygon_contains(const geofence_t *gf, const geofence_shape_t *f, int32_t lat, int32_t lon) {
+    const geofence_point_t *v = &gf->vertices[f->first_vertex];
+    int64_t py = lat - f->min_lat, px = lon - f->min_lon;
+    bool inside = false;
+
+    for (int i = 0, j = f->num_vertices - 1; i < f->num_vertices; j = i++) {
+        int64_t yi = v[i].lat - f->min_lat, xi = v[i].lon - f->min_lon;
+        int64_t yj = v[j].lat - f->min_lat, xj = v[j].lon - f->min_lon;
+        if ((yi > py) == (yj > py)) continue;
+
+        // px < xi + (py - yi) * (xj - xi) / (yj - yi) 를 (yj - yi) 부호에 맞춰 곱셈으로
+        int64_t lhs = (px - xi) * (yj - yi), rhs = (py - yi) * (xj - xi);
+        if (yj > yi ? lhs < rhs : lhs > rhs) inside = !inside;
+    }
+    return inside;
+}
+
+static bool circle_contains(const geofence_shape_t *f, int32_t lat, int32_t lon) {
+    int64_t dy = (int64_t)lat - f->center_lat;
+    int64_t dx = ((int64_t)lon - f->center_lon) * f->cos_q16 / 65536;
+    return dx * dx + dy * dy <= f->radius2;
+}
+
+static bool shape_contains(const geofence_t *gf, const geofence_shape_t *f, int32_t lat, int32_t lon) {
+    if (lat < f->min_lat || lat > f->max_lat || lon < f->min_lon || lon > f->max_lon) return false;
+    return f->num_vertices ? polygon_contains(gf, f, lat, lon) : circle_contains(f, lat, lon);
+}
+
+bool geofence_contains(const geofence_t *gf, int fence, int32_t lat, int32_t lon) {
+    if (fence < 0 || fence >= gf->num_fences) return false;
+    return shape_contains(gf, &gf->fences[fence], lat, lon);
+}
+
+// --- [격자 색인] ---
+// 구역 f 가 걸치는 칸 범위
+static void cell_range(const geofence_t *gf, const geofence_shape_t *f, int *r0, int *r1, int *c0, int *c1) {
+    *r0 = (int)(((int64_t)f->min_lat - gf->grid_lat) / gf->cell_h);
+    *r1 = (int)(((int64_t)f->max_lat - gf->grid_lat) / gf->cell_h);
+    *c0 = (int)(((int64_t)f->min_lon - gf->grid_lon) / gf->cell_w);
+    *c1 = (int)(((int64_t)f->max_lon - gf->grid_lon) / gf->cell_w);
+}
+
+// rows x cols 격자로 나눴을 때 칸 목록의 총길이
+static uint64_t count_items(geofence_t *gf, int64_t height, int64_t width, int rows, int cols) {
+    gf->rows = rows;
+    gf->cols = cols;
+    gf->cell_h = (int32_t)((height + rows - 1) / rows);
+    gf->cell_w = (int32_t)((width + cols - 1) / cols);
+
+    uint64_t items = 0;
+    for (int i = 0; i < gf->num_fences; i++) {
+        int r0, r1, c0, c1;
+        cell_range(gf, &gf->fences[i], &r0, &r1, &c0, &c1);
+        items += (uint64_t)(r1 - r0 + 1) * (c1 - c0 + 1);
+    }
+    return items;
+}
+
+static void free_cells(geofence_t *gf) {
+    free(gf->cell_start);
+    free(gf->cell_items);
+    gf->cell_start = NULL;
+    gf->cell_items = NULL;
+}
+
+bool geofence_build(geofence_t *gf) {
+    free_cells(gf);
+    gf->built = false;
+    if (gf->num_fences == 0) return false;
+
+    // 모든 구역을 덮는 사각형
+    int32_t min_lat = gf->fences[0].min_lat, max_lat = gf->fences[0].max_lat;
+    int32_t min_lon = gf->fences[0].min_lon, max_lon = gf->fences[0].max_lon;
+    for (int i = 1; i < gf->num_fences; i++) {
+        const geofence_shape_t *f = &gf->fences[i];
+        if (f->min_lat < min_lat) min_lat = f->min_lat;
+        if (f->max_lat > max_lat) max_lat = f->max_lat;
+        if (f->min_lon < min_lon) min_lon = f->min_lon;
+        if (f->max_lon > max_lon) max_lon = f->max_lon;
+    }
+    gf->grid_lat = min_lat;
+    gf->grid_lon = min_lon;
+    int64_t height = (int64_t)max_lat - min_lat + 1, width = (int64_t)max_lon - min_lon + 1;
+
+    // 칸이 거의 정사각형이 되도록 나눔. 큰 구역이 많아서 칸 목록이 너무 길어지면 칸을 키워서 다시
+    uint64_t target = (uint64_t)gf->num_fences * CELLS_PER_FENCE;
+    if (target > GEOFENCE_MAX_CELLS) target = GEOFENCE_MAX_CELLS;
+    uint64_t items;
+    for (;;) {
+        double side = sqrt((double)height * (double)width / (double)target);
+        int64_t rows = (int64_t)ceil(height / side), cols = (int64_t)ceil(width / side);
+        if (rows < 1) rows = 1;
+        if (cols < 1) cols = 1;
+        while (rows * cols > GEOFENCE_MAX_CELLS) {
+            if (rows > cols) rows = (rows + 1) / 2;
+            else cols = (cols + 1) / 2;
+        }
+        items = count_items(gf, height, width, (int)rows, (int)cols);
+        if (target == 1 || items <= (uint64_t)gf->num_fences * ITEMS_PER_FENCE + (uint64_t)(rows * cols)) break;
+        target = target / 4 ? target / 4 : 1;
+    }
+    if (items > UINT32_MAX) return false;
+
+    // 칸별 개수 -> 시작 위치 -> 채우기 (목록을 한 배열에 이어 붙임)
+    int cells = gf->rows * gf->cols;
+    gf->cell_start = calloc(cells + 1, sizeof(uint32_t));
+    gf->cell_items = malloc((items ? items : 1) * sizeof(uint16_t));
+    if (gf->cell_start == NULL || gf->cell_items == NULL) {
+        free_cells(gf);
+        return false;
+    }
+    for (int i = 0; i < gf->num_fences; i++) {
+        int r0, r1, c0, c1;
+        cell_range(gf, &gf->fences[i], &r0, &r1, &c0, &c1);
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) gf->cell_start[r * gf->cols + c + 1]++;
+        }
+    }
+    for (int c = 0; c < cells; c++) gf->cell_start[c + 1] += gf->cell_start[c];
+
+    uint32_t *fill = malloc(cells * sizeof(uint32_t));
+    if (fill == NULL) {
+        free_cells(gf); // 반쯤 만든 색인을 남기지 않음 (built 가 false 라 쓰이지도 않음)
+        return false;
+    }
+    memcpy(fill, gf->cell_start, cells * sizeof(uint32_t));
+    for (int i = 0; i < gf->num_fences; i++) {
+        int r0, r1, c0, c1;
+        cell_range(gf, &gf->fences[i], &r0, &r1, &c0, &c1);
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) gf->cell_items[fill[r * gf->cols + c]++] = (uint16_t)i;
+        }
+    }
+    free(fill);
+    gf->built = true;
+    return true;
+}
+
+// --- [fix 검사] ---
+static bool is_inside(const geofence_t *gf, int fence) {
+    return gf->inside_bits[fence / 32] & (1u << (fence % 32));
+}
+
+static void set_inside(geofence_t *gf, int fence, bool on) {
+    if (on) gf->inside_bits[fence / 32] |= 1u << (fence % 32);
+    else gf->inside_bits[fence / 32] &= ~(1u << (fence % 32));
+}
+
+static void test_fence(geofence_t *gf, int fence, int32_t lat, int32_t lon, uint16_t *found, int *num_found) {
+    const geofence_shape_t *f = &gf->fences[fence];
+    if (lat < f->min_lat || lat > f->max_lat || lon < f->min_lon || lon > f->max_lon) return;
+    gf->exact_tests++;
+    bool in = f->num_vertices ? polygon_contains(gf, f, lat, lon) : circle_contains(f, lat, lon);
+    if (in && *num_found < GEOFENCE_MAX_INSIDE) found[(*num_found)++] = (uint16_t)fence;
+}
+
+void geofence_update(geofence_t *gf, int32_t lat, int32_t lon) {
+    uint16_t found[GEOFENCE_MAX_INSIDE];
+    int num_found = 0;
+    gf->evaluations++;
+
+    if (gf->built) {
+        // 점이 속한 칸의 목록만 (격자 밖이면 어느 구역에도 없음)
+        int64_t r = ((int64_t)lat - gf->grid_lat), c = ((int64_t)lon - gf->grid_lon);
+        if (r >= 0 && c >= 0) {
+            r /= gf->cell_h;
+            c /= gf->cell_w;
+            if (r < gf->rows && c < gf->cols) {
+                int cell = (int)r * gf->cols + (int)c;
+                for (uint32_t k = gf->cell_start[cell]; k < gf->cell_start[cell + 1]; k++) {
+                    test_fence(gf, gf->cell_items[k], lat, lon, found, &num_found);
+                }
+            }
+        }
+    } else {
+        // 색인을 안 만들었으면 전부 검사
+        for (int i = 0; i < gf->num_fences; i++) test_fence(gf, i, lat, lon, found, &num_found);
+    }
+
+    // 나온 구역 먼저 (옆 구역으로 넘어가면 EXIT -> ENTER 순서)
+    for (int i = 0; i < gf->num_inside; i++) {
+        int fence = gf->inside[i];
+        bool still = false;
+        for (int k = 0; k < num_found && !still; k++) still = found[k] == fence;
+        if (!still) {
+            set_inside(gf, fence, false);
+            if (gf->cb) gf->cb(fence, gf->fences[fence].tag, GEOFENCE_EXIT, gf->ctx);
+        }
+    }
+    for (int k = 0; k < num_found; k++) {
+        if (is_inside(gf, found[k])) continue;
+        set_inside(gf, found[k], true);
+        if (gf->cb) gf->cb(found[k], gf->fences[found[k]].tag, GEOFENCE_ENTER, gf->ctx);
+    }
+    memcpy(gf->inside, found, num_found * sizeof(found[0]));
+    gf->num_inside = num_found;
+}
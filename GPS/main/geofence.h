@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- [지오펜스 (원 / 다각형 구역 출입 감지)] ---
+// 수천 개의 구역을 10Hz 로 검사할 수 있도록 격자 색인을 씁니다.
+//  - 모든 구역을 덮는 사각형을 격자로 나누고, 칸마다 "이 칸에 걸치는 구역" 목록을 미리 만들어 둠
+//  - fix 가 들어오면 그 점이 속한 칸의 목록만 정확히 검사 (구역 수와 상관없이 몇 개만 검사)
+//  - 좌표는 nmea_parser 와 같은 1e-7 도 정수. 검사 중에는 float/double 을 쓰지 않음
+//    (원의 경도 방향 축척 cos(위도) 만 추가할 때 한 번 계산해서 Q16 정수로 저장)
+// 들어갈 때/나올 때 콜백을 부름. 경도 180도를 넘나드는 구역은 지원하지 않음.
+// ESP-IDF 의존성 없음 (PC 의 tools/geofence_bench 가 같은 코드로 측정)
+
+#define GEOFENCE_MAX_INSIDE   64        // 동시에 안에 있을 수 있는 구역 수
+#define GEOFENCE_MAX_SPAN_E7  100000000 // 구역 하나의 최대 크기 (10도, 정수 곱셈이 넘치지 않는 범위)
+#define GEOFENCE_MAX_CELLS    65536     // 격자 칸 수 상한
+
+typedef enum {
+    GEOFENCE_ENTER = 0,
+    GEOFENCE_EXIT,
+} geofence_event_t;
+
+// fence: 추가한 순서 (0 부터), tag: 추가할 때 준 값
+typedef void (*geofence_cb_t)(int fence, uint32_t tag, geofence_event_t ev, void *ctx);
+
+typedef struct {
+    int32_t min_lat, min_lon, max_lat, max_lon; // 감싸는 사각형 (빠른 제외용)
+    uint32_t tag;
+    uint32_t first_vertex;  // 다각형: vertices[] 안의 시작 위치
+    uint16_t num_vertices;  // 0 이면 원
+    int32_t center_lat, center_lon; // 원
+    int64_t radius2;        // 원: 반지름^2 (1e-7 도 단위, 위도 방향)
+    int32_t cos_q16;        // 원: cos(중심 위도) x 65536
+} geofence_shape_t;
+
+typedef struct {
+    int32_t lat, lon;
+} geofence_point_t;
+
+typedef struct {
+    // 구역
+    geofence_shape_t *fences;
+    int num_fences, max_fences;
+    geofence_point_t *vertices;
+    int num_vertices, max_vertices;
+
+    // 격자 색인 (geofence_build 가 만듦). 칸 c 의 구역 목록 = cell_items[cell_start[c] .. cell_start[c+1])
+    int32_t grid_lat, grid_lon;     // 격자 왼쪽 아래 모서리
+    int32_t cell_h, cell_w;         // 칸 크기 (1e-7 도)
+    int rows, cols;
+    uint32_t *cell_start;
+    uint16_t *cell_items;
+    bool built;
+
+    // 지금 안에 있는 구역
+    uint16_t inside[GEOFENCE_MAX_INSIDE];
+    int num_inside;
+    uint32_t *inside_bits;          // 구역 번호별 1비트 (빠른 포함 확인)
+
+    geofence_cb_t cb;
+    void *ctx;
+
+    // 통계
+    uint32_t evaluations;
+    uint32_t exact_tests;           // 사각형 검사를 통과해 정확히 검사한 횟수
+} geofence_t;
+
+// 최대 구역 수 / 다각형 꼭짓점 총수를 정해서 메모리를 한 번에 할당. 실패하면 false
+bool geofence_init(geofence_t *gf, int max_fences, int max_vertices, geofence_cb_t cb, void *ctx);
+void geofence_free(geofence_t *gf);
+
+// 구역 추가 (geofence_build 전에). 성공하면 구역 번호, 실패하면 -1
+int geofence_add_circle(geofence_t *gf, int32_t lat, int32_t lon, uint32_t radius_m, uint32_t tag);
+int geofence_add_polygon(geofence_t *gf, const geofence_point_t *pts, int n, uint32_t tag);
+
+// 격자 색인 만들기 (구역을 다 추가한 뒤 한 번). 메모리 부족이면 false
+bool geofence_build(geofence_t *gf);
+
+// fix 하나 검사. 들어가거나 나온 구역마다 콜백을 부름
+void geofence_update(geofence_t *gf, int32_t lat, int32_t lon);
+
+// 점이 구역 안인지 (색인 없이 구역 하나만 검사)
+bool geofence_contains(const geofence_t *gf, int fence, int32_t lat, int32_t lon);
@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "sdkconfig.h"
+#include "nmea_parser.h"
+#include "gps_snapshot.h"
+#include "gps_events.h"
+#include "gps_assist.h"
+
+static const char *TAG = "GPS_ASSIST";
+
+#define NVS_NAMESPACE     "gps_assist"
+#define NVS_KEY_FIX       "fix"
+#define NVS_KEY_DB        "db"
+#define SAVED_VERSION     1
+#define SAVE_MS           (CONFIG_GPS_ASSIST_SAVE_MIN * 60000u) // GPS_ASSIST 가 켜져 있을 때만 빌드됨 (CMakeLists.txt)
+#define POS_ACC_CM        10000000  // 꺼져 있는 동안 100 km 안에서 움직였다고 가정
+#define VALID_UTC_S       1704067200 // 2024-01-01. 시스템 시계가 이보다 앞이면 시각을 모름
+#define RTC_DRIFT_DIV     20        // 시스템 시계 오차: 마지막 저장 뒤 지난 시간의 1/20 (RTC 내부 RC 클럭, 넉넉하게)
+#define DB_POLL_MS        2000      // 데이터베이스 요청 후 응답을 모으는 시간
+#define DB_FRAME_GAP_MS   10        // 데이터베이스를 돌려줄 때 프레임 사이 간격 (수신기 입력 버퍼 넘침 방지)
+
+// NVS 에 저장하는 마지막 fix
+typedef struct {
+    uint32_t version;
+    int32_t lat, lon;       // 1e-7 도
+    int32_t alt_cm;
+    int64_t utc_s;          // fix 의 UTC (1970 부터 초)
+    uint32_t ttff_ms;       // 그 부팅의 TTFF
+} saved_fix_t;
+
+static uart_port_t gps_port;
+static gps_receiver_t receiver;
+static gps_assist_status_t status;
+static saved_fix_t saved;
+
+// 데이터베이스 수집: 파서 태스크가 채우고 assist 태스크가 읽음 (부팅 때는 주입할 내용을 읽어 두는 곳)
+static uint8_t db_buf[GPS_ASSIST_DB_MAX];
+static size_t db_len;
+static bool db_collecting;
+static bool db_overflow;
+static portMUX_TYPE db_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void format_e7(char *out, size_t size, int32_t e7) {
+    uint32_t abs_val = e7 < 0 ? -(uint32_t)e7 : (uint32_t)e7;
+    snprintf(out, size, "%s%lu.%07lu", e7 < 0 ? "-" : "",
+             (unsigned long)(abs_val / GPS_COORD_SCALE), (unsigned long)(abs_val % GPS_COORD_SCALE));
+}
+
+static void send_ubx(uint8_t cls, uint8_t id, const void *payload, uint16_t len) {
+    uint8_t frame[64];
+    size_t n = ubx_build(frame, sizeof(frame), cls, id, payload, len);
+    if (n > 0) uart_write_bytes(gps_port, frame, n);
+}
+
+static void put_u16(uint8_t *p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; p[2] = (v >> 16) & 0xFF; p[3] = v >> 24;
+}
+
+// --- [부팅 때 주입] ---
+// 시스템 시계가 살아 있으면 (소프트 리셋, 딥슬립) 그 시각과 불확실성(초). 모르면 false
+static bool known_time(struct tm *tm, uint32_t *acc_s) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    if (tv.tv_sec < VALID_UTC_S || saved.utc_s == 0 || tv.tv_sec < saved.utc_s) return false;
+
+    time_t now = tv.tv_sec;
+    gmtime_r(&now, tm);
+    *acc_s = 1 + (uint32_t)((tv.tv_sec - saved.utc_s) / RTC_DRIFT_DIV);
+    return true;
+}
+
+static void inject_mtk(void) {
+    struct tm tm;
+    uint32_t acc_s;
+    if (!known_time(&tm, &acc_s)) {
+        // PMTK741 은 위치와 함께 시각이 꼭 필요함
+        ESP_LOGI(TAG, "시각을 몰라서 주입 안 함 (MediaTek 은 위치에 시각이 필요)");
+        return;
+    }
+
+    char body[96], lat[16], lon[16];
+    snprintf(body, sizeof(body), "PMTK740,%04d,%02d,%02d,%02d,%02d,%02d",
+             tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    status.time_injected = gps_config_pmtk(gps_port, body);
+
+    format_e7(lat, sizeof(lat), saved.lat);
+    format_e7(lon, sizeof(lon), saved.lon);
+    snprintf(body, sizeof(body), "PMTK741,%s,%s,%ld,%04d,%02d,%02d,%02d,%02d,%02d", lat, lon,
+             (long)(saved.alt_cm / 100), tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+             tm.tm_hour, tm.tm_min, tm.tm_sec);
+    status.pos_injected = gps_config_pmtk(gps_port, body);
+}
+
+static void inject_ublox(void) {
+    struct tm tm;
+    uint32_t acc_s;
+
+    // MGA 메시지는 기본 설정에서 ACK 가 없으므로 보내기만 함. 시각을 먼저 보내야 위치/궤도를 바로 씀
+    if (known_time(&tm, &acc_s)) {
+        uint8_t ini[24] = {0};
+        ini[0] = 0x10;                      // type = TIME_UTC
+        ini[3] = (uint8_t)-128;             // leapSecs = 모름
+        put_u16(&ini[4], tm.tm_year + 1900);
+        ini[6] = tm.tm_mon + 1;
+        ini[7] = tm.tm_mday;
+        ini[8] = tm.tm_hour;
+        ini[9] = tm.tm_min;
+        ini[10] = tm.tm_sec;
+        put_u16(&ini[16], acc_s > UINT16_MAX ? UINT16_MAX : acc_s); // tAccS
+        send_ubx(UBX_CLASS_MGA, UBX_MGA_INI, ini, sizeof(ini));
+        status.time_injected = true;
+    }
+
+    uint8_t pos[20] = {0};
+    pos[0] = 0x01;                          // type = POS_LLH
+    put_u32(&pos[4], (uint32_t)saved.lat);
+    put_u32(&pos[8], (uint32_t)saved.lon);
+    put_u32(&pos[12], (uint32_t)saved.alt_cm);
+    put_u32(&pos[16], POS_ACC_CM);
+    send_ubx(UBX_CLASS_MGA, UBX_MGA_INI, pos, sizeof(pos));
+    status.pos_injected = true;
+    uart_wait_tx_done(gps_port, pdMS_TO_TICKS(100));
+}
+
+// 저장해 둔 MGA-DBD 프레임들을 그대로 돌려줌
+static void inject_db(const uint8_t *db, size_t len) {
+    size_t off = 0;
+    while (off + 8 <= len) {
+        size_t frame = 8 + ubx_u16(&db[off + 4]);
+        if (db[off] != UBX_SYNC1 || db[off + 1] != UBX_SYNC2 || off + frame > len) break;
+        uart_write_bytes(gps_port, &db[off], frame);
+        uart_wait_tx_done(gps_port, pdMS_TO_TICKS(100));
+        vTaskDelay(pdMS_TO_TICKS(DB_FRAME_GAP_MS));
+        off += frame;
+    }
+    status.db_injected = off;
+}
+
+// --- [저장] ---
+void gps_assist_on_ubx(const ubx_decoder_t *d) {
+    if (d->cls != UBX_CLASS_MGA || d->id != UBX_MGA_DBD) return;
+
+    portENTER_CRITICAL(&db_lock);
+    if (db_collecting) {
+        size_t n = ubx_build(db_buf + db_len, sizeof(db_buf) - db_len, d->cls, d->id, d->payload, d->len);
+        if (n == 0) db_overflow = true;
+        db_len += n;
+    }
+    portEXIT_CRITICAL(&db_lock);
+}
+
+// 수신기에 데이터베이스를 요청하고 DB_POLL_MS 동안 모음. 모은 바이트 수 (실패하면 0)
+static size_t poll_db(void) {
+    portENTER_CRITICAL(&db_lock);
+    db_len = 0;
+    db_overflow = false;
+    db_collecting = true;
+    portEXIT_CRITICAL(&db_lock);
+
+    send_ubx(UBX_CLASS_MGA, UBX_MGA_DBD, NULL, 0);
+    vTaskDelay(pdMS_TO_TICKS(DB_POLL_MS));
+
+    portENTER_CRITICAL(&db_lock);
+    db_collecting = false;
+    portEXIT_CRITICAL(&db_lock);
+
+    if (db_overflow) {
+        ESP_LOGW(TAG, "궤도 데이터베이스가 %d 바이트보다 커서 저장 안 함", GPS_ASSIST_DB_MAX);
+        return 0;
+    }
+    return db_len;
+}
+
+static void save(const GPS_Data *gps) {
+    saved.version = SAVED_VERSION;
+    saved.lat = gps->latitude;
+    saved.lon = gps->longitude;
+    saved.alt_cm = gps->altitude_cm;
+    saved.utc_s = (int64_t)gps_days_from_civil(gps->year, gps->month, gps->day) * 86400 + gps->utc_ms / 1000;
+    saved.ttff_ms = status.ttff_ms;
+
+    size_t db = receiver == GPS_RECEIVER_UBLOX ? poll_db() : 0;
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, NVS_KEY_FIX, &saved, sizeof(saved));
+        if (err == ESP_OK && db > 0) err = nvs_set_blob(nvs, NVS_KEY_DB, db_buf, db);
+        if (err == ESP_OK) err = nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "NVS 저장 실패: %s", esp_err_to_name(err));
+        return;
+    }
+    status.saves++;
+    if (db > 0) status.db_bytes = db;
+}
+
+// --- [assist 태스크] ---
+// 첫 fix 는 바로 알아야 하므로 간격 없이 구독하고, 그 뒤로는 저장 주기마다만 깨어남
+static void gps_assist_task(void *arg) {
+    GPS_Data gps;
+    uint32_t events;
+    int64_t last_save_ms = 0;
+
+    gps_events_subscribe(NULL, GPS_EVENT_FIX, 0);
+    while (1) {
+        xTaskNotifyWait(0, UINT32_MAX, &events, portMAX_DELAY);
+        if (!gps_snapshot_read(&gps) || !gps.valid || gps.year == 0) continue;
+
+        int64_t now_ms = esp_timer_get_time() / 1000;
+        if (status.ttff_ms == 0) {
+            status.ttff_ms = (uint32_t)now_ms;
+            ESP_LOGI(TAG, "첫 fix: 부팅 후 %.1f 초 (지난 부팅 %.1f 초 / 주입: 위치 %s, 시각 %s, 궤도 %lu 바이트)",
+                     status.ttff_ms / 1000.0, status.prev_ttff_ms / 1000.0,
+                     status.pos_injected ? "O" : "X", status.time_injected ? "O" : "X",
+                     (unsigned long)status.db_injected);
+            gps_events_subscribe(NULL, GPS_EVENT_FIX, SAVE_MS);
+        } else if (now_ms - last_save_ms < SAVE_MS / 2) {
+            continue; // 다시 구독한 직후의 알림
+        }
+        save(&gps);
+        last_save_ms = now_ms;
+    }
+}
+
+esp_err_t gps_assist_init(uart_port_t port, const gps_config_result_t *cfg) {
+    gps_port = port;
+    receiver = cfg->receiver;
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "NVS 열기 실패: %s (웜 스타트 없이 동작)", esp_err_to_name(err));
+        return err;
+    }
+
+    size_t size = sizeof(saved);
+    if (nvs_get_blob(nvs, NVS_KEY_FIX, &saved, &size) != ESP_OK || size != sizeof(saved) ||
+        saved.version != SAVED_VERSION) {
+        memset(&saved, 0, sizeof(saved));
+    }
+    size_t db = 0;
+    if (receiver == GPS_RECEIVER_UBLOX) {
+        db = sizeof(db_buf);
+        if (nvs_get_blob(nvs, NVS_KEY_DB, db_buf, &db) != ESP_OK) db = 0;
+    }
+    nvs_close(nvs);
+
+    status.prev_ttff_ms = saved.ttff_ms;
+    if (saved.version == SAVED_VERSION) {
+        if (receiver == GPS_RECEIVER_MTK) inject_mtk();
+        else if (receiver == GPS_RECEIVER_UBLOX) inject_ublox();
+    }
+    if (db > 0) inject_db(db_buf, db);
+
+    if (saved.version == SAVED_VERSION || db > 0) {
+        ESP_LOGI(TAG, "웜 스타트 주입: 위치 %s, 시각 %s, 궤도 %lu 바이트",
+                 status.pos_injected ? "O" : "X", status.time_injected ? "O" : "X",
+                 (unsigned long)status.db_injected);
+    } else {
+        ESP_LOGI(TAG, "저장된 위치 없음 (콜드 스타트)");
+    }
+
+    xTaskCreate(gps_assist_task, "gps_assist", 3072, NULL, 2, NULL);
+    return ESP_OK;
+}
+
+void gps_assist_get_status(gps_assist_status_t *out) {
+    *out = status;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/uart.h"
+#include "gps_config.h"
+#include "ubx.h"
+
+// --- [웜 스타트 (마지막 위치/시간/궤도 정보 저장 후 부팅 때 주입)] ---
+// 수신기는 전원이 꺼지면 어디인지, 몇 시인지, 위성 궤도가 어떤지 모르는 채로 시작해서
+// 하늘 전체를 뒤지느라 첫 fix 까지 수십 초~수 분이 걸림 (콜드 스타트).
+// 마지막으로 알던 값을 NVS 에 저장해 두었다가 다음 부팅 때 수신기에 알려 줌:
+//   MediaTek : PMTK740 (UTC 시각), PMTK741 (위치 + 시각)
+//   u-blox   : UBX-MGA-INI-TIME_UTC, UBX-MGA-INI-POS_LLH,
+//              UBX-MGA-DBD (수신기의 궤도력/알마낙 데이터베이스를 통째로 받아 두었다가 그대로 돌려줌, M8 이상)
+// 시각은 시스템 시계가 살아 있을 때만 (소프트 리셋/딥슬립 뒤). 전원을 껐다 켜면 시각을 모르므로 위치만.
+// 부팅 후 첫 fix 까지 걸린 시간(TTFF)을 로그로 남기고, 다음 부팅 때 비교할 수 있게 같이 저장.
+
+#define UBX_CLASS_MGA     0x13
+#define UBX_MGA_INI       0x40
+#define UBX_MGA_DBD       0x80
+
+#define GPS_ASSIST_DB_MAX 6144 // 저장할 궤도 데이터베이스 최대 크기 (UBX 프레임을 이어 붙인 형태)
+
+typedef struct {
+    bool pos_injected;      // 이번 부팅에 위치를 넣었음
+    bool time_injected;     // 이번 부팅에 시각을 넣었음
+    uint32_t db_injected;   // 이번 부팅에 넣은 데이터베이스 바이트 수
+    uint32_t ttff_ms;       // 부팅 후 첫 fix 까지 (아직이면 0)
+    uint32_t prev_ttff_ms;  // 지난 부팅의 TTFF (모르면 0)
+    uint32_t saves;         // NVS 에 저장한 횟수
+    uint32_t db_bytes;      // 마지막으로 받은 데이터베이스 크기
+} gps_assist_status_t;
+
+// gps_configure() 다음, 수신 루프 전에 호출 (app_main, nvs_flash_init 뒤).
+// 저장된 값이 있으면 수신기에 넣고, fix 를 지켜보다 주기적으로 저장하는 태스크를 시작
+esp_err_t gps_assist_init(uart_port_t port, const gps_config_result_t *cfg);
+
+// 파서 태스크 전용: 수신한 UBX 프레임마다 호출 (데이터베이스를 받는 중이면 모아 둠)
+void gps_assist_on_ubx(const ubx_decoder_t *d);
+
+void gps_assist_get_status(gps_assist_status_t *out);
@@ -0,0 +1,130 @@
+#include <stdlib.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "gps_clock.h"
+
+static const char *TAG = "GPS_CLOCK";
+
+#define CLOCK_STEP_US    100000 // 시스템 시계가 이보다 많이 틀리면 한 번에 맞춤
+#define CLOCK_SLEW_US    200    // 이보다 작은 차이는 무시 (adjtime 을 너무 자주 부르지 않음)
+
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED; // model 과 PPS 기록 보호
+static gps_time_t model;
+
+// ISR 이 쓰는 값 (lock 으로 보호, 64비트라 한 번에 쓰이지 않음)
+static int64_t isr_pps_us;
+static uint32_t isr_pps_count;
+static uint32_t seen_pps_count;
+
+static uint32_t disciplined_samples; // 시스템 시계를 마지막으로 확인한 시점의 model.samples
+static int64_t last_discipline_us;
+static uint32_t clock_steps;
+
+static void IRAM_ATTR pps_isr(void *arg) {
+    int64_t now = esp_timer_get_time(); // 최대한 먼저 기록 (이후 코드는 지연에 영향 없음)
+    portENTER_CRITICAL_ISR(&lock);
+    isr_pps_us = now;
+    isr_pps_count++;
+    portEXIT_CRITICAL_ISR(&lock);
+}
+
+#if CONFIG_GPS_SET_SYSTEM_TIME
+// --- [시스템 시계 보정] ---
+// 크게 틀리면 settimeofday() 로 한 번에, 작게 틀리면 adjtime() 으로 천천히 (시간이 거꾸로 가지 않음)
+static void discipline_system_clock(int64_t utc_us) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t delta = utc_us - ((int64_t)tv.tv_sec * 1000000 + tv.tv_usec);
+
+    if (llabs(delta) > CLOCK_STEP_US) {
+        struct timeval set = { .tv_sec = utc_us / 1000000, .tv_usec = utc_us % 1000000 };
+        settimeofday(&set, NULL);
+        clock_steps++;
+        ESP_LOGI(TAG, "시스템 시계 맞춤 (%+lld ms)", (long long)(delta / 1000));
+    } else if (llabs(delta) > CLOCK_SLEW_US) {
+        struct timeval adj = { .tv_sec = delta / 1000000, .tv_usec = delta % 1000000 };
+        adjtime(&adj, NULL);
+    }
+}
+#endif
+
+void gps_clock_on_fix(const GPS_Data *gps) {
+    int64_t now = esp_timer_get_time(); // 문장을 받은 시각 (파싱 직후)
+    if (gps->year < 2000 || gps->month == 0 || gps->day == 0) return;
+
+    int64_t utc_ms = (int64_t)gps_days_from_civil(gps->year, gps->month, gps->day) * 86400000 + gps->utc_ms;
+
+    portENTER_CRITICAL(&lock);
+    if (isr_pps_count != seen_pps_count) {
+        seen_pps_count = isr_pps_count;
+        gps_time_pps(&model, isr_pps_us);
+    }
+    gps_time_utc(&model, utc_ms * 1000, now);
+    uint32_t samples = model.samples;
+    portEXIT_CRITICAL(&lock);
+
+#if CONFIG_GPS_SET_SYSTEM_TIME
+    // PPS 가 새로 짝지어졌을 때, PPS 가 없으면 1초에 한 번만 확인
+    if (samples != disciplined_samples || now - last_discipline_us >= 1000000) {
+        int64_t utc_now;
+        if (gps_clock_now(&utc_now) != GPS_TIME_NONE) discipline_system_clock(utc_now);
+        disciplined_samples = samples;
+        last_discipline_us = now;
+    }
+#else
+    (void)samples;
+#endif
+}
+
+gps_time_state_t gps_clock_now(int64_t *utc_us) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&lock);
+    gps_time_state_t state = gps_time_to_utc(&model, now, utc_us);
+    portEXIT_CRITICAL(&lock);
+    return state;
+}
+
+void gps_clock_get_status(gps_clock_status_t *out) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&lock);
+    out->state = gps_time_to_utc(&model, now, NULL);
+    out->drift_ppb = model.drift_ppb;
+    out->last_error_us = model.last_error_us;
+    out->jitter_us = model.jitter_us;
+    out->pps_edges = model.pps_edges;
+    out->samples = model.samples;
+    out->rejected = model.rejected;
+    portEXIT_CRITICAL(&lock);
+    out->clock_steps = clock_steps;
+}
+
+esp_err_t gps_clock_init(int pps_gpio) {
+    gps_time_init(&model);
+    if (pps_gpio < 0) {
+        ESP_LOGI(TAG, "PPS 핀 없음: NMEA 수신 시각으로만 맞춤");
+        return ESP_OK;
+    }
+
+    const gpio_config_t io = {
+        .pin_bit_mask = 1ULL << pps_gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE, // 수신기가 꺼져 있을 때 떠 있지 않도록
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+    esp_err_t err = gpio_config(&io);
+    if (err != ESP_OK) return err;
+
+    // 다른 코드가 이미 설치했으면 ESP_ERR_INVALID_STATE (그대로 사용)
+    err = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err;
+    err = gpio_isr_handler_add(pps_gpio, pps_isr, NULL);
+    if (err != ESP_OK) return err;
+
+    ESP_LOGI(TAG, "PPS 입력: GPIO %d", pps_gpio);
+    return ESP_OK;
+}
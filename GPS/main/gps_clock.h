@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "gps_time.h"
+#include "nmea_parser.h"
+
+// --- [GPS 시간 서비스] ---
+// gps_time.c 의 계산을 ESP32 에 연결합니다.
+//  - PPS 핀 상승 에지에서 esp_timer_get_time() 을 기록 (GPIO 인터럽트)
+//  - 파서 태스크가 RMC/ZDA/NAV-PVT 시각을 넘기면 PPS 와 짝지어 기준점 갱신
+//  - (CONFIG_GPS_SET_SYSTEM_TIME) 시스템 시계를 처음에 한 번 맞추고, 이후에는 adjtime() 으로 조금씩 보정
+// 다른 태스크는 RTC 를 따로 읽을 필요 없이 gps_clock_now() 나 gettimeofday() 로 UTC 를 얻으면 됨.
+
+typedef struct {
+    gps_time_state_t state;
+    int32_t drift_ppb;      // 로컬 타이머 주파수 오차 추정
+    int32_t last_error_us;  // 마지막 PPS 의 예측 오차
+    uint32_t jitter_us;     // 예측 오차 평균
+    uint32_t pps_edges;     // 들어온 PPS 수
+    uint32_t samples;       // 시각과 짝지어진 PPS 수
+    uint32_t rejected;      // 예측과 너무 달라 버린 PPS 수
+    uint32_t clock_steps;   // 시스템 시계를 한 번에 맞춘 횟수
+} gps_clock_status_t;
+
+// pps_gpio < 0 이면 PPS 없이 NMEA 수신 시각으로만 맞춤 (수십 ms 오차)
+esp_err_t gps_clock_init(int pps_gpio);
+
+// 파서 태스크에서 GPS_UPDATED_FIX / GPS_UPDATED_TIME 마다 호출
+void gps_clock_on_fix(const GPS_Data *gps);
+
+// 현재 UTC (1970-01-01 부터 us). 어느 태스크에서나 호출 가능. 아직 모르면 GPS_TIME_NONE
+gps_time_state_t gps_clock_now(int64_t *utc_us);
+
+void gps_clock_get_status(gps_clock_status_t *out);
@@ -0,0 +1,313 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "gps_config.h"
+#include "nmea_framer.h"
+#include "nmea_parser.h"
+#include "ubx.h"
+#include "ubx_nav.h"
+
+static const char *TAG = "GPS_CONFIG";
+
+#define PROBE_WINDOW_MS   1200  // 보레이트 하나당 듣는 시간 (1Hz 출력이면 문장 여러 개가 들어옴)
+#define PROBE_MIN_LINES   2     // 체크섬 맞는 줄이 이만큼 들어오면 그 보레이트로 확정
+#define ACK_TIMEOUT_MS    1000  // 명령 하나당 ACK 기다리는 시간
+#define CMD_RETRIES       3
+#define EPOCH_BYTES       300   // 1회 측위당 출력량 추정 (RMC+GGA+GSA, GSV 는 1초에 한 번)
+#define PMTK314_MAX_DIV   5     // PMTK314 출력 주기 값의 최대 ("측위 5번마다 1번")
+
+// 흔히 쓰는 순서대로 시도 (공장 출하값 9600 이 가장 많음)
+static const uint32_t probe_bauds[] = { 9600, 115200, 38400, 57600, 19200, 4800 };
+
+// --- [설정 중 응답 수집] ---
+typedef struct {
+    nmea_framer_t framer;
+    ubx_decoder_t ubx;
+    int nmea_lines;         // 체크섬 맞은 NMEA 줄 수
+    int want_pmtk;          // 기다리는 $PMTK001 의 명령 번호
+    bool pmtk_seen;
+    int pmtk_flag;          // 0=잘못된 명령, 1=미지원, 2=실패, 3=성공
+    uint8_t want_cls, want_id; // 기다리는 UBX ACK 대상
+    int ubx_ack;            // -1=아직 없음, 0=NAK, 1=ACK
+} gps_probe_t;
+
+static gps_probe_t probe; // 버퍼가 커서 스택 대신 static
+
+static void probe_on_line(char *line, size_t len, void *ctx) {
+    gps_probe_t *p = ctx;
+    p->nmea_lines++;
+
+    // $PMTK001,<명령>,<결과>
+    if (strncmp(line, "$PMTK001,", 9) == 0) {
+        nmea_fields_t f;
+        nmea_split_fields(line, &f);
+        if (atoi(nmea_field_ptr(&f, 1)) == p->want_pmtk) {
+            p->pmtk_flag = atoi(nmea_field_ptr(&f, 2));
+            p->pmtk_seen = true;
+        }
+    }
+}
+
+static void probe_on_ubx(gps_probe_t *p) {
+    ubx_decoder_t *d = &p->ubx;
+
+    if (d->cls == UBX_CLASS_ACK && d->len == 2 &&
+        d->payload[0] == p->want_cls && d->payload[1] == p->want_id) {
+        p->ubx_ack = (d->id == UBX_ACK_ACK) ? 1 : 0;
+    } else if (d->cls == p->want_cls && d->id == p->want_id) {
+        p->ubx_ack = 1; // 폴링 요청에 대한 응답 메시지도 "받아들였다"로 봄
+    }
+}
+
+static void probe_reset(gps_probe_t *p) {
+    nmea_framer_init(&p->framer, probe_on_line, p);
+    ubx_decoder_init(&p->ubx);
+    p->nmea_lines = 0;
+    p->pmtk_seen = false;
+    p->ubx_ack = -1;
+}
+
+static bool lines_done(const gps_probe_t *p) { return p->nmea_lines >= PROBE_MIN_LINES || p->ubx.frames > 0; }
+static bool pmtk_done(const gps_probe_t *p) { return p->pmtk_seen; }
+static bool ubx_done(const gps_probe_t *p) { return p->ubx_ack >= 0; }
+
+// 수신 데이터를 NMEA 프레이머와 UBX 조립기 양쪽에 넣음.
+// done() 이 참이 되면 true, 시간이 다 되면 false
+static bool pump(uart_port_t port, gps_probe_t *p, int timeout_ms, bool (*done)(const gps_probe_t *)) {
+    uint8_t buf[128];
+    TickType_t start = xTaskGetTickCount();
+
+    while (xTaskGetTickCount() - start < pdMS_TO_TICKS(timeout_ms)) {
+        int n = uart_read_bytes(port, buf, sizeof(buf), pdMS_TO_TICKS(20));
+        for (int i = 0; i < n; i++) {
+            if (ubx_decoder_push(&p->ubx, buf[i])) probe_on_ubx(p);
+        }
+        if (n > 0) nmea_framer_feed(&p->framer, (const char *)buf, n);
+        if (done(p)) return true;
+    }
+    return false;
+}
+
+// --- [PMTK 명령] ---
+static void write_pmtk(uart_port_t port, const char *body) {
+    char line[96];
+    uint8_t cs = 0;
+    for (const char *c = body; *c; c++) cs ^= (uint8_t)*c;
+    int n = snprintf(line, sizeof(line), "$%s*%02X\r\n", body, cs);
+    uart_write_bytes(port, line, n);
+}
+
+// body 예: "PMTK220,100" -> $PMTK001,220,3 이 오면 성공
+static bool pmtk_command(uart_port_t port, gps_probe_t *p, const char *body, int tries) {
+    p->want_pmtk = atoi(body + 4);
+    for (int i = 0; i < tries; i++) {
+        p->pmtk_seen = false;
+        write_pmtk(port, body);
+        if (pump(port, p, ACK_TIMEOUT_MS, pmtk_done)) {
+            if (p->pmtk_flag == 3) return true;
+            ESP_LOGW(TAG, "$%s 거부됨 (flag=%d)", body, p->pmtk_flag);
+            return false;
+        }
+    }
+    ESP_LOGW(TAG, "$%s 응답 없음", body);
+    return false;
+}
+
+// --- [UBX 명령] ---
+// ACK-ACK 가 오면 true, ACK-NAK 이거나 응답이 없으면 false
+static bool ubx_command(uart_port_t port, gps_probe_t *p, uint8_t cls, uint8_t id,
+                        const void *payload, uint16_t len, int tries) {
+    uint8_t frame[64];
+    size_t n = ubx_build(frame, sizeof(frame), cls, id, payload, len);
+    if (n == 0) return false;
+
+    p->want_cls = cls;
+    p->want_id = id;
+    for (int i = 0; i < tries; i++) {
+        p->ubx_ack = -1;
+        uart_write_bytes(port, frame, n);
+        if (pump(port, p, ACK_TIMEOUT_MS, ubx_done)) return p->ubx_ack == 1;
+    }
+    ESP_LOGW(TAG, "UBX %02X-%02X 응답 없음", cls, id);
+    return false;
+}
+
+// 아무 것도 바꾸지 않는 CFG-RATE 폴링으로 UBX 통신 확인
+static bool ubx_ping(uart_port_t port, gps_probe_t *p, int tries) {
+    return ubx_command(port, p, UBX_CLASS_CFG, UBX_CFG_RATE, NULL, 0, tries);
+}
+
+// --- [1) 보레이트 찾기] ---
+static uint32_t detect_baud(uart_port_t port, gps_probe_t *p) {
+    for (size_t i = 0; i < sizeof(probe_bauds) / sizeof(probe_bauds[0]); i++) {
+        uart_set_baudrate(port, probe_bauds[i]);
+        uart_flush_input(port);
+        probe_reset(p);
+        if (pump(port, p, PROBE_WINDOW_MS, lines_done)) {
+            ESP_LOGI(TAG, "보레이트 확인: %lu (NMEA %d줄, UBX %lu개)",
+                     (unsigned long)probe_bauds[i], p->nmea_lines, (unsigned long)p->ubx.frames);
+            return probe_bauds[i];
+        }
+    }
+    return 0;
+}
+
+// --- [2) 수신기 종류 확인] ---
+static gps_receiver_t detect_receiver(uart_port_t port, gps_probe_t *p) {
+#if CONFIG_GPS_RECEIVER_MTK
+    return GPS_RECEIVER_MTK;
+#elif CONFIG_GPS_RECEIVER_UBLOX
+    return GPS_RECEIVER_UBLOX;
+#elif CONFIG_GPS_RECEIVER_NONE
+    return GPS_RECEIVER_UNKNOWN;
+#else
+    // PMTK000 은 "테스트" 명령 (MediaTek 이면 $PMTK001,0,3 으로 응답)
+    if (pmtk_command(port, p, "PMTK000", 1)) return GPS_RECEIVER_MTK;
+    if (ubx_ping(port, p, 1)) return GPS_RECEIVER_UBLOX;
+    return GPS_RECEIVER_UNKNOWN;
+#endif
+}
+
+// --- [3) 보레이트 변경] ---
+// 수신기에 새 보레이트를 보낸 뒤 ESP 쪽도 바꾸고, 새 속도에서 명령이 통하는지 확인.
+// 실패하면 원래 속도로 되돌림
+static bool switch_baud(uart_port_t port, gps_probe_t *p, gps_receiver_t rx, uint32_t from, uint32_t to) {
+    if (rx == GPS_RECEIVER_MTK) {
+        char body[32];
+        snprintf(body, sizeof(body), "PMTK251,%lu", (unsigned long)to);
+        write_pmtk(port, body); // 보레이트 변경은 ACK 없이 바로 바뀜
+    } else {
+        // CFG-PRT: UART1, 8N1, 입출력 모두 UBX+NMEA
+        uint8_t prt[20] = {0};
+        prt[0] = 1;                         // portID = UART1
+        prt[4] = 0xC0; prt[5] = 0x08;       // mode = 8N1
+        prt[8] = to & 0xFF; prt[9] = (to >> 8) & 0xFF;
+        prt[10] = (to >> 16) & 0xFF; prt[11] = (to >> 24) & 0xFF;
+        prt[12] = 0x03;                     // inProtoMask = UBX | NMEA
+        prt[14] = 0x03;                     // outProtoMask = UBX | NMEA
+        uint8_t frame[32];
+        size_t n = ubx_build(frame, sizeof(frame), UBX_CLASS_CFG, UBX_CFG_PRT, prt, sizeof(prt));
+        uart_write_bytes(port, frame, n); // ACK 는 예전 속도로 오다가 끊기므로 기다리지 않음
+    }
+    uart_wait_tx_done(port, pdMS_TO_TICKS(200));
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    uart_set_baudrate(port, to);
+    uart_flush_input(port);
+    probe_reset(p);
+
+    bool ok = (rx == GPS_RECEIVER_MTK) ? pmtk_command(port, p, "PMTK000", CMD_RETRIES)
+                                       : ubx_ping(port, p, CMD_RETRIES);
+    if (!ok) {
+        ESP_LOGW(TAG, "%lu 보레이트 확인 실패 -> %lu 로 되돌림", (unsigned long)to, (unsigned long)from);
+        uart_set_baudrate(port, from);
+        uart_flush_input(port);
+    }
+    return ok;
+}
+
+// --- [4) 쓰지 않는 문장 끄기] ---
+// 파서가 쓰는 RMC/GGA/GSA 는 매번, GSV 는 1초에 한 번 (측위 rate_hz 번마다). GLL/VTG 등은 RMC 와 겹치므로 끔
+static bool set_sentences(uart_port_t port, gps_probe_t *p, gps_receiver_t rx, int rate_hz) {
+    if (rx == GPS_RECEIVER_MTK) {
+        // 순서: GLL,RMC,VTG,GGA,GSA,GSV,... 값 = "측위 N번마다 1번 출력".
+        // PMTK314 는 N 이 5 까지라 5 Hz 를 넘으면 1초에 한 번까지 줄일 수 없음 (10 Hz 면 GSV 2 Hz)
+        char body[64];
+        int gsv_div = rate_hz > PMTK314_MAX_DIV ? PMTK314_MAX_DIV : rate_hz;
+        if (gsv_div < rate_hz) {
+            ESP_LOGI(TAG, "MTK: GSV 는 측위 %d번마다 (%d.%d Hz, PMTK314 한계)", gsv_div, rate_hz / gsv_div,
+                     rate_hz * 10 / gsv_div % 10);
+        }
+        snprintf(body, sizeof(body), "PMTK314,0,1,0,1,1,%d,0,0,0,0,0,0,0,0,0,0,0,0,0", gsv_div);
+        return pmtk_command(port, p, body, CMD_RETRIES);
+    }
+
+    // UBX CFG-MSG (현재 포트): { class, id, 출력 주기(측위 N번마다 1번, 0=끔) }
+    // NAV-PVT 를 쓰면 위치는 UBX 로 받으므로 NMEA 는 GSV 만 남김
+#if CONFIG_GPS_UBX_NAV_PVT
+    const uint8_t fix_rate = 0, pvt_rate = 1;
+#else
+    const uint8_t fix_rate = 1, pvt_rate = 0;
+#endif
+    const uint8_t msgs[][3] = {
+        { 0xF0, 0x00, fix_rate },        // GGA
+        { 0xF0, 0x01, 0 },               // GLL
+        { 0xF0, 0x02, fix_rate },        // GSA
+        { 0xF0, 0x03, (uint8_t)rate_hz }, // GSV
+        { 0xF0, 0x04, fix_rate },        // RMC
+        { 0xF0, 0x05, 0 },               // VTG
+        { UBX_CLASS_NAV, UBX_NAV_PVT, pvt_rate },
+    };
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(msgs) / sizeof(msgs[0]); i++) {
+        ok &= ubx_command(port, p, UBX_CLASS_CFG, UBX_CFG_MSG, msgs[i], 3, CMD_RETRIES);
+    }
+    return ok;
+}
+
+// --- [5) 측위 주기] ---
+static bool set_rate(uart_port_t port, gps_probe_t *p, gps_receiver_t rx, int rate_hz) {
+    uint16_t period_ms = 1000 / rate_hz;
+
+    if (rx == GPS_RECEIVER_MTK) {
+        char body[32];
+        snprintf(body, sizeof(body), "PMTK220,%u", period_ms);
+        return pmtk_command(port, p, body, CMD_RETRIES);
+    }
+
+    // CFG-RATE: measRate(ms), navRate=1, timeRef=1(GPS 시간)
+    uint8_t rate[6] = { period_ms & 0xFF, period_ms >> 8, 1, 0, 1, 0 };
+    return ubx_command(port, p, UBX_CLASS_CFG, UBX_CFG_RATE, rate, sizeof(rate), CMD_RETRIES);
+}
+
+const char *gps_receiver_name(gps_receiver_t rx) {
+    switch (rx) {
+        case GPS_RECEIVER_MTK:   return "MediaTek";
+        case GPS_RECEIVER_UBLOX: return "u-blox";
+        default:                 return "unknown";
+    }
+}
+
+esp_err_t gps_configure(uart_port_t port, gps_config_result_t *out) {
+    gps_probe_t *p = &probe;
+
+    memset(out, 0, sizeof(*out));
+
+    uint32_t baud = detect_baud(port, p);
+    if (baud == 0) {
+        ESP_LOGE(TAG, "GPS 응답 없음 (배선/전원 확인)");
+        uart_set_baudrate(port, probe_bauds[0]);
+        return ESP_ERR_NOT_FOUND;
+    }
+    out->baud = baud;
+
+    out->receiver = detect_receiver(port, p);
+    ESP_LOGI(TAG, "수신기: %s", gps_receiver_name(out->receiver));
+    if (out->receiver == GPS_RECEIVER_UNKNOWN) return ESP_ERR_NOT_SUPPORTED;
+
+    if (baud != CONFIG_GPS_TARGET_BAUD &&
+        switch_baud(port, p, out->receiver, baud, CONFIG_GPS_TARGET_BAUD)) {
+        out->baud = CONFIG_GPS_TARGET_BAUD;
+    }
+
+    // 보레이트가 낮으면 출력이 밀리지 않을 만큼만 주기를 올림
+    int rate_hz = CONFIG_GPS_RATE_HZ;
+    int max_hz = out->baud / 10 / EPOCH_BYTES;
+    if (rate_hz > max_hz) rate_hz = max_hz > 0 ? max_hz : 1;
+
+    out->sentences_set = set_sentences(port, p, out->receiver, rate_hz);
+    if (set_rate(port, p, out->receiver, rate_hz)) out->rate_hz = rate_hz;
+
+    ESP_LOGI(TAG, "설정 완료: %lu baud, %d Hz, 문장 설정 %s",
+             (unsigned long)out->baud, out->rate_hz, out->sentences_set ? "OK" : "실패");
+    return (out->rate_hz > 0 && out->sentences_set) ? ESP_OK : ESP_FAIL;
+}
+
+bool gps_config_pmtk(uart_port_t port, const char *body) {
+    probe_reset(&probe);
+    return pmtk_command(port, &probe, body, CMD_RETRIES);
+}
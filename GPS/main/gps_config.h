@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/uart.h"
+
+// --- [GPS 수신기 초기 설정] ---
+// 1) 현재 보레이트를 찾고 (체크섬이 맞는 NMEA 문장이 들어오는 속도)
+// 2) 수신기 종류(MediaTek / u-blox)를 확인한 뒤
+// 3) 보레이트 변경, 쓰지 않는 문장 끄기, 측위 주기 변경을 보내고 ACK 로 확인합니다.
+// UART 드라이버가 설치된 뒤, 수신 루프를 시작하기 전에 호출합니다.
+
+typedef enum {
+    GPS_RECEIVER_UNKNOWN = 0,
+    GPS_RECEIVER_MTK,       // PMTK 명령 (MediaTek / 대부분의 저가형 모듈)
+    GPS_RECEIVER_UBLOX,     // UBX 명령 (NEO-6M/7M/8M 등)
+} gps_receiver_t;
+
+typedef struct {
+    gps_receiver_t receiver;
+    uint32_t baud;          // 최종 보레이트
+    int rate_hz;            // 최종 측위 주기 (확인 못 했으면 0)
+    bool sentences_set;     // 문장 출력 설정이 ACK 로 확인됨
+} gps_config_result_t;
+
+// 실패해도 UART 는 마지막으로 통신이 확인된 보레이트로 남겨 둠
+esp_err_t gps_configure(uart_port_t port, gps_config_result_t *out);
+
+const char *gps_receiver_name(gps_receiver_t rx);
+
+// PMTK 명령 하나를 보내고 $PMTK001 성공 응답을 기다림 (예: "PMTK740,2026,01,17,03,25,10").
+// gps_configure() 와 같은 조건: 수신 루프를 시작하기 전에만 호출
+bool gps_config_pmtk(uart_port_t port, const char *body);
@@ -0,0 +1,99 @@
+#include <string.h>
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "gps_events.h"
+
+typedef struct {
+    TaskHandle_t task;          // NULL = 빈 칸
+    uint32_t events;
+    uint32_t interval_ms;
+    int64_t next_due_ms[3];     // 이벤트 종류별 다음에 알려도 되는 시각
+} subscriber_t;
+
+// 알림을 보내는 동안에도 잡고 있어서, unsubscribe 가 끝난 뒤에는 그 태스크로 알림이 가지 않음
+// (구독을 끊고 바로 태스크를 지워도 안전)
+static SemaphoreHandle_t lock;
+static StaticSemaphore_t lock_buf;
+static subscriber_t subs[GPS_MAX_SUBSCRIBERS];
+static uint32_t last_time_sec = UINT32_MAX;
+
+void gps_events_init(void) {
+    if (lock == NULL) lock = xSemaphoreCreateMutexStatic(&lock_buf);
+}
+
+esp_err_t gps_events_subscribe(TaskHandle_t task, uint32_t events, uint32_t min_interval_ms) {
+    if (task == NULL) task = xTaskGetCurrentTaskHandle();
+    if ((events & ~GPS_EVENT_ALL) != 0 || events == 0) return ESP_ERR_INVALID_ARG;
+
+    if (lock == NULL) return ESP_ERR_INVALID_STATE;
+
+    esp_err_t err = ESP_ERR_NO_MEM;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    subscriber_t *slot = NULL;
+    for (int i = 0; i < GPS_MAX_SUBSCRIBERS; i++) {
+        if (subs[i].task == task) {
+            slot = &subs[i];
+            break;
+        }
+        if (subs[i].task == NULL && slot == NULL) slot = &subs[i];
+    }
+    if (slot != NULL) {
+        memset(slot, 0, sizeof(*slot));
+        slot->task = task;
+        slot->events = events;
+        slot->interval_ms = min_interval_ms;
+        err = ESP_OK;
+    }
+    xSemaphoreGive(lock);
+    return err;
+}
+
+void gps_events_unsubscribe(TaskHandle_t task) {
+    if (task == NULL) task = xTaskGetCurrentTaskHandle();
+    if (lock == NULL) return;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < GPS_MAX_SUBSCRIBERS; i++) {
+        if (subs[i].task == task) subs[i].task = NULL;
+    }
+    xSemaphoreGive(lock);
+}
+
+// 간격 제한: 정해진 시각표(next_due)를 따라가므로 10Hz 에서 1000ms 를 주면 정확히 1Hz.
+// 수신 간격이 조금 흔들려도 빠지지 않도록 간격의 1/8 만큼 일찍 와도 허용
+static bool due(subscriber_t *s, int kind, int64_t now_ms) {
+    if (s->interval_ms == 0) return true;
+    int64_t *next = &s->next_due_ms[kind];
+    if (now_ms + s->interval_ms / 8 < *next) return false;
+
+    *next += s->interval_ms;
+    if (*next <= now_ms) *next = now_ms + s->interval_ms; // 오래 쉬었으면 지금부터 다시
+    return true;
+}
+
+void gps_events_publish(uint32_t updated, const GPS_Data *gps) {
+    uint32_t events = 0;
+    if (updated & GPS_UPDATED_FIX) events |= GPS_EVENT_FIX;
+    if (updated & GPS_UPDATED_SKY) events |= GPS_EVENT_SATS;
+    if ((updated & (GPS_UPDATED_FIX | GPS_UPDATED_TIME)) && gps->utc_ms / 1000 != last_time_sec) {
+        last_time_sec = gps->utc_ms / 1000;
+        events |= GPS_EVENT_TIME;
+    }
+    if (events == 0 || lock == NULL) return;
+
+    int64_t now_ms = esp_timer_get_time() / 1000;
+
+    // 구독/해지와만 겹칠 수 있으므로 거의 기다리지 않음
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < GPS_MAX_SUBSCRIBERS; i++) {
+        subscriber_t *s = &subs[i];
+        if (s->task == NULL) continue;
+
+        uint32_t send = 0;
+        for (int k = 0; k < 3; k++) {
+            uint32_t ev = 1u << k;
+            if ((events & s->events & ev) && due(s, k, now_ms)) send |= ev;
+        }
+        if (send) xTaskNotify(s->task, send, eSetBits);
+    }
+    xSemaphoreGive(lock);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "nmea_parser.h"
+
+// --- [GPS 이벤트 구독] ---
+// 파서 태스크가 갱신될 때마다 구독한 태스크에 태스크 알림(비트)을 보냅니다.
+// 데이터는 알림에 싣지 않고, 깨어난 태스크가 종류에 맞는 스냅샷을 읽음:
+//   GPS_EVENT_FIX  -> gps_snapshot_read()
+//   GPS_EVENT_SATS -> gps_snapshot_read_sats()
+//   GPS_EVENT_TIME -> gps_clock_now()
+// (구독자가 여럿이어도 큐로 구조체를 복사하지 않고, 각자 2초마다 폴링할 필요도 없음)
+//
+// 구독자는 xTaskNotifyWait(0, UINT32_MAX, &bits, timeout) 으로 기다리고 bits 로 종류를 구분.
+// 태스크 알림 0번을 비트 용도로 쓰므로 같은 태스크에서 ulTaskNotifyTake 를 섞어 쓰지 말 것.
+
+#define GPS_EVENT_FIX   (1u << 0) // 위치/속도 갱신
+#define GPS_EVENT_SATS  (1u << 1) // 위성 목록 갱신 (GSV 묶음 완료)
+#define GPS_EVENT_TIME  (1u << 2) // UTC 초가 바뀜
+#define GPS_EVENT_ALL   (GPS_EVENT_FIX | GPS_EVENT_SATS | GPS_EVENT_TIME)
+
+#define GPS_MAX_SUBSCRIBERS 8
+
+// 다른 태스크를 만들기 전에 한 번 호출 (app_main)
+void gps_events_init(void);
+
+// task 가 NULL 이면 호출한 태스크. 같은 태스크가 다시 구독하면 설정을 바꿈.
+// min_interval_ms: 이 간격보다 자주 알리지 않음 (0 = 갱신될 때마다, 10Hz 면 초당 10번)
+esp_err_t gps_events_subscribe(TaskHandle_t task, uint32_t events, uint32_t min_interval_ms);
+void gps_events_unsubscribe(TaskHandle_t task);
+
+// 파서 태스크 전용: parse_nmea()/ubx_apply_frame() 결과를 구독자에게 알림
+void gps_events_publish(uint32_t updated, const GPS_Data *gps);
@@ -0,0 +1,44 @@
+#include <string.h>
+#include "gps_merge.h"
+
+void gps_merge_init(gps_merge_t *m) {
+    memset(m, 0, sizeof(*m));
+    m->primary = -1;
+}
+
+// fix 등급: 3D/2D > DGPS. 클수록 좋음 (지금 fix 가 무효이거나 끊겼으면 -1)
+static int fix_rank(const gps_merge_t *m, const GPS_Data *g, int rx, int64_t now_ms) {
+    if (!g->valid || m->last_fix_ms[rx] == 0 || now_ms - m->last_fix_ms[rx] > GPS_MERGE_STALE_MS) return -1;
+    return (g->fix_type >= 3 ? 2 : 0) + (g->fix_quality >= 2 ? 1 : 0);
+}
+
+// 등급이 같으면 HDOP 가 작은 쪽 (처음 고를 때만)
+static bool better(const gps_merge_t *m, const GPS_Data *const gps[], int a, int b, int64_t now_ms) {
+    int ra = fix_rank(m, gps[a], a, now_ms), rb = fix_rank(m, gps[b], b, now_ms);
+    if (ra != rb) return ra > rb;
+    return gps[a]->hdop_x100 < gps[b]->hdop_x100;
+}
+
+bool gps_merge_update(gps_merge_t *m, int rx, uint32_t updated, const GPS_Data *const gps[], int n, int64_t now_ms) {
+    if (rx < 0 || rx >= n || n > GPS_MAX_RECEIVERS) return false;
+    if ((updated & GPS_UPDATED_FIX) && gps[rx]->valid) m->last_fix_ms[rx] = now_ms;
+
+    int cur = m->primary;
+    int best = cur;
+    if (cur < 0 || fix_rank(m, gps[cur], cur, now_ms) < 0) {
+        // 주 수신기가 없거나 끊김: 가장 좋은 것으로
+        best = -1;
+        for (int i = 0; i < n; i++) {
+            if (fix_rank(m, gps[i], i, now_ms) >= 0 && (best < 0 || better(m, gps, i, best, now_ms))) best = i;
+        }
+        if (best < 0) best = cur >= 0 ? cur : rx; // 아무도 fix 가 없으면 그대로 (시각/위성 정보는 계속 나감)
+    } else if (rx != cur && fix_rank(m, gps[rx], rx, now_ms) > fix_rank(m, gps[cur], cur, now_ms)) {
+        best = rx; // 등급이 확실히 더 좋을 때만 바꿈
+    }
+
+    if (best != cur) {
+        if (cur >= 0) m->switches++;
+        m->primary = best;
+    }
+    return rx == m->primary;
+}
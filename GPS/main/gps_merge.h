@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nmea_parser.h"
+
+// --- [수신기 여러 대의 출력 합치기] ---
+// 수신기마다 따로 파싱한 결과(GPS_Data) 중 하나를 "주 수신기"로 골라 그 결과만 내보냅니다.
+// 나머지는 예비: 주 수신기가 무효 fix 를 내거나 GPS_MERGE_STALE_MS 동안 조용하면 바로 넘어감.
+// 좋은 쪽이 조금씩 바뀔 때마다 출력이 왔다 갔다 하지 않도록, 이미 주 수신기가 있으면
+// fix 등급(3D > DGPS)이 확실히 더 좋을 때만 바꾸고 HDOP 같은 작은 차이로는 바꾸지 않음.
+// 두 수신기 위치를 섞어 평균 내지 않음 (서로 다른 안테나 위치가 섞이면 오히려 튐).
+// ESP-IDF 의존성 없음
+
+#define GPS_MAX_RECEIVERS  4
+#define GPS_MERGE_STALE_MS 1500 // 이 시간 동안 유효한 fix 가 없으면 그 수신기는 쓸 수 없음
+
+typedef struct {
+    int primary;                            // 지금 내보내는 수신기 (-1 = 없음)
+    int64_t last_fix_ms[GPS_MAX_RECEIVERS]; // 수신기별 마지막 유효 fix 시각 (0 = 아직 없음)
+    uint32_t switches;                      // 주 수신기가 바뀐 횟수
+} gps_merge_t;
+
+void gps_merge_init(gps_merge_t *m);
+
+// 수신기 rx 가 갱신됐을 때 호출 (now_ms: 단조 증가 시각).
+// gps[] 는 모든 수신기의 현재 결과 (n 개). 이 갱신을 내보내야 하면 true
+bool gps_merge_update(gps_merge_t *m, int rx, uint32_t updated, const GPS_Data *const gps[], int n, int64_t now_ms);
@@ -0,0 +1,61 @@
+#include <string.h>
+#include <stdatomic.h>
+#include "gps_snapshot.h"
+
+// 버퍼 2개 + 발행 횟수. 최신 데이터는 buf[seq & 1]
+typedef struct {
+    void *buf[2];
+    size_t size;
+    atomic_uint seq;
+} snap_t;
+
+static GPS_Data fix_buf[2];
+static gps_sat_table_t sat_buf[2];
+static snap_t fix_snap = { .buf = { &fix_buf[0], &fix_buf[1] }, .size = sizeof(GPS_Data) };
+static snap_t sat_snap = { .buf = { &sat_buf[0], &sat_buf[1] }, .size = sizeof(gps_sat_table_t) };
+
+static void snap_publish(snap_t *s, const void *src) {
+    unsigned seq = atomic_load_explicit(&s->seq, memory_order_relaxed);
+
+    // 지금 읽히는 쪽(seq & 1)이 아닌 버퍼에 씀
+    memcpy(s->buf[(seq + 1) & 1], src, s->size);
+
+    // 데이터를 다 쓴 다음에 seq 가 보이도록 (다른 코어에서 읽을 때 순서 보장)
+    atomic_store_explicit(&s->seq, seq + 1, memory_order_release);
+}
+
+static bool snap_read(snap_t *s, void *out) {
+    while (1) {
+        unsigned before = atomic_load_explicit(&s->seq, memory_order_acquire);
+        if (before == 0) return false;
+
+        memcpy(out, s->buf[before & 1], s->size);
+
+        atomic_thread_fence(memory_order_acquire);
+        unsigned after = atomic_load_explicit(&s->seq, memory_order_relaxed);
+
+        // 복사하는 동안 발행이 끝난 적이 없어야 함. 한 번 끝났으면 다음 발행이 이미 읽던 버퍼에
+        // 쓰고 있을 수 있음 (seq 는 그 발행이 끝나야 올라가므로 차이가 1 이어도 찢어졌을 수 있음) -> 다시 읽음
+        if (after == before) return true;
+    }
+}
+
+void gps_snapshot_publish(const GPS_Data *src) {
+    snap_publish(&fix_snap, src);
+}
+
+bool gps_snapshot_read(GPS_Data *out) {
+    return snap_read(&fix_snap, out);
+}
+
+uint32_t gps_snapshot_seq(void) {
+    return atomic_load_explicit(&fix_snap.seq, memory_order_acquire);
+}
+
+void gps_snapshot_publish_sats(const gps_sat_table_t *src) {
+    snap_publish(&sat_snap, src);
+}
+
+bool gps_snapshot_read_sats(gps_sat_table_t *out) {
+    return snap_read(&sat_snap, out);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nmea_parser.h"
+
+// --- [GPS 데이터 발행 (잠금 없는 스냅샷)] ---
+// 파서(쓰는 쪽 1개)가 my_gps 를 다 채운 뒤 통째로 발행하고,
+// 읽는 쪽은 항상 "한 시점의 완성된" 복사본만 받습니다.
+// (위도는 이번 fix, 경도는 지난 fix 인 식의 찢어진 값이 나오지 않음)
+//
+// 버퍼 2개를 번갈아 쓰는 시퀀스 잠금 방식:
+//  - 쓰는 쪽은 읽히고 있지 않은 버퍼에 쓰고 seq 를 올림 -> 절대 기다리지 않음
+//  - 읽는 쪽은 복사 전후의 seq 를 비교해서, 복사 도중 발행이 하나라도 끝났으면 다시 읽음
+//    (쓰는 쪽은 10 Hz, 복사는 수 us 라서 다시 읽는 일은 드묾)
+
+// 파서 태스크에서만 호출
+void gps_snapshot_publish(const GPS_Data *src);
+
+// 최신 스냅샷 복사. 아직 한 번도 발행되지 않았으면 false
+bool gps_snapshot_read(GPS_Data *out);
+
+// 지금까지 발행된 횟수 (값이 바뀌었는지 확인용)
+uint32_t gps_snapshot_seq(void);
+
+// --- [위성 목록 발행] ---
+// 위성 목록은 GSV 묶음이 끝날 때만 바뀌므로 fix 와 따로 발행 (fix 마다 목록까지 복사하지 않음)
+void gps_snapshot_publish_sats(const gps_sat_table_t *src);
+bool gps_snapshot_read_sats(gps_sat_table_t *out);
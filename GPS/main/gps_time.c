@@ -0,0 +1,136 @@
+#include <string.h>
+#include <stdlib.h>
+#include "gps_time.h"
+
+#define US_PER_SEC 1000000
+
+void gps_time_init(gps_time_t *t) {
+    memset(t, 0, sizeof(*t));
+    t->last_utc_us = -1;
+}
+
+void gps_time_pps(gps_time_t *t, int64_t local_us) {
+    t->pps_local_us[1] = t->pps_local_us[0];
+    t->pps_local_us[0] = local_us;
+    if (t->pps_pending < 2) t->pps_pending++;
+    t->pps_edges++;
+}
+
+// 경과 시간에 드리프트 보정을 더한 값
+static int64_t elapsed_utc(const gps_time_t *t, int64_t local_us) {
+    int64_t d = local_us - t->anchor_local_us;
+    return d + d * t->drift_ppb / 1000000000;
+}
+
+static void set_anchor(gps_time_t *t, int64_t local_us, int64_t utc_us, bool pps) {
+    t->anchor_local_us = local_us;
+    t->anchor_utc_us = utc_us;
+    t->pps_locked = pps;
+    t->has_anchor = true;
+}
+
+// PPS(local_us) 가 UTC 정각 utc_us 라는 측정값 하나 반영
+static void pps_sample(gps_time_t *t, int64_t local_us, int64_t utc_us) {
+    if (!t->has_anchor || !t->pps_locked) {
+        // 처음이거나 COARSE 에서 올라옴: 기준점만 잡고 드리프트는 다음 PPS 부터 측정
+        set_anchor(t, local_us, utc_us, true);
+        t->relocks++;
+        t->samples++;
+        return;
+    }
+
+    int64_t dt = local_us - t->anchor_local_us;
+    int64_t err = utc_us - (t->anchor_utc_us + elapsed_utc(t, local_us));
+
+    if (llabs(err) > GPS_TIME_REJECT_US) {
+        // 노이즈이거나 수신기 시각이 바뀜. 같은 크기로 계속 틀리면 기준이 틀린 것이므로 새로 잡음
+        if (t->bad_streak > 0 && llabs(err - t->bad_error_us) > GPS_TIME_REJECT_US) t->bad_streak = 0;
+        t->bad_error_us = err;
+        t->rejected++;
+        if (++t->bad_streak >= GPS_TIME_RELOCK_COUNT) {
+            set_anchor(t, local_us, utc_us, true);
+            t->relocks++;
+            t->bad_streak = 0;
+        }
+        return;
+    }
+    t->bad_streak = 0;
+
+    // 이번 구간에서 남은 오차만큼 드리프트를 조금씩 보정 (ISR 지연 흔들림을 평균으로 없앰)
+    if (dt > 0) {
+        int64_t err_ppb = err * 1000000000 / dt;
+        t->drift_ppb += (int32_t)(err_ppb / GPS_TIME_DRIFT_GAIN);
+    }
+    t->last_error_us = (int32_t)err;
+    t->jitter_us = (uint32_t)((int32_t)t->jitter_us + ((int32_t)llabs(err) - (int32_t)t->jitter_us) / 8);
+    t->samples++;
+
+    // 오프셋은 매초 PPS 로 새로 잡음 (드리프트 예측 오차가 쌓이지 않음)
+    set_anchor(t, local_us, utc_us, true);
+}
+
+// 정각 문장(utc_us, 받은 시각 local_us)과 짝지을 PPS 고르기. 없으면 -1
+static int pick_pps(const gps_time_t *t, int64_t utc_us, int64_t local_us) {
+    if (t->has_anchor && t->pps_locked) {
+        // 이미 맞춰져 있으면 예측한 UTC 가 문장 시각에 가장 가까운 PPS (1초 늦게 온 문장도 맞게 짝지음)
+        int best = -1;
+        int64_t best_err = 0;
+        for (int i = 0; i < t->pps_pending; i++) {
+            int64_t err = llabs(utc_us - (t->anchor_utc_us + elapsed_utc(t, t->pps_local_us[i])));
+            if (best < 0 || err < best_err) {
+                best = i;
+                best_err = err;
+            }
+        }
+        return best;
+    }
+    // 처음: 문장 직전의 PPS
+    int64_t since_pps = local_us - t->pps_local_us[0];
+    return since_pps >= 0 && since_pps < GPS_TIME_PAIR_WINDOW_US ? 0 : -1;
+}
+
+void gps_time_utc(gps_time_t *t, int64_t utc_us, int64_t local_us) {
+    if (utc_us == t->last_utc_us) return; // 같은 에포크의 다른 문장
+    t->last_utc_us = utc_us;
+
+    if (utc_us % US_PER_SEC == 0 && t->pps_pending > 0) {
+        int pick = pick_pps(t, utc_us, local_us);
+        if (pick >= 0) {
+            int64_t pps = t->pps_local_us[pick];
+            t->pps_pending = pick; // 고른 것과 그보다 오래된 PPS 는 버리고, 더 최근 것은 다음 문장용으로 남김
+            pps_sample(t, pps, utc_us);
+            return;
+        }
+    }
+
+    // PPS 가 없거나 너무 오래 끊겼으면 문장 수신 시각으로 맞춤 (수신 지연만큼 늦음)
+    int64_t predicted;
+    gps_time_state_t state = gps_time_to_utc(t, local_us, &predicted);
+    if (state == GPS_TIME_NONE ||
+        (state == GPS_TIME_HOLDOVER && local_us - t->anchor_local_us > GPS_TIME_HOLDOVER_MAX_US)) {
+        set_anchor(t, local_us, utc_us, false);
+    } else if (state == GPS_TIME_COARSE) {
+        // 문장은 항상 늦게 도착하므로, 지금 기준보다 덜 늦은 문장이 오면 그걸로 바꿈 (최소 지연 필터).
+        // 로컬 타이머 드리프트가 쌓이지 않도록 기준이 오래되면 그냥 새로 잡음
+        if (utc_us > predicted || local_us - t->anchor_local_us > GPS_TIME_COARSE_AGE_US) {
+            set_anchor(t, local_us, utc_us, false);
+        }
+    }
+}
+
+gps_time_state_t gps_time_to_utc(const gps_time_t *t, int64_t local_us, int64_t *utc_us) {
+    if (!t->has_anchor) return GPS_TIME_NONE;
+    if (utc_us) *utc_us = t->anchor_utc_us + elapsed_utc(t, local_us);
+
+    if (!t->pps_locked) return GPS_TIME_COARSE;
+    return local_us - t->anchor_local_us > GPS_TIME_HOLDOVER_US ? GPS_TIME_HOLDOVER : GPS_TIME_LOCKED;
+}
+
+const char *gps_time_state_name(gps_time_state_t state) {
+    switch (state) {
+        case GPS_TIME_COARSE:   return "COARSE";
+        case GPS_TIME_LOCKED:   return "LOCKED";
+        case GPS_TIME_HOLDOVER: return "HOLDOVER";
+        default:                return "NONE";
+    }
+}
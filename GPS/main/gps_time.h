@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- [GPS 시간 맞추기 (PPS + NMEA 시각)] ---
+// 수신기의 PPS 핀은 매 UTC 정각(초)마다 한 번 펄스를 냄. 펄스 자체에는 "몇 시 몇 초"가 없으므로,
+// 펄스 직후에 들어오는 RMC/ZDA 의 정각 시각과 짝을 지어 "로컬 타이머 값 <-> UTC" 기준점을 만듭니다.
+//  - 오프셋: 마지막 PPS 의 기준점 (매초 새로 잡으므로 ISR 지연(수 us)만큼의 오차)
+//  - 드리프트: 로컬 타이머가 UTC 보다 빠르거나 느린 정도 (ppb), 매초 측정값을 저역 필터로 다듬음
+//  - 현재 UTC = 기준 UTC + 경과 시간 x (1 + 드리프트)
+// PPS 가 없으면 문장을 받은 시각으로 대신 맞춤 (COARSE, 수십 ms 오차).
+//
+// 시간 단위는 모두 us. local_us 는 단조 증가하는 로컬 타이머 (ESP32 에서는 esp_timer_get_time()),
+// utc_us 는 1970-01-01 00:00 UTC 부터의 us.
+// ESP-IDF 의존성 없음: PC 에서 가짜 PPS/NMEA 로 시험 가능 (tools/gps_time_sim.c)
+
+#define GPS_TIME_PAIR_WINDOW_US  900000  // 처음 잡을 때: PPS 후 이 시간 안에 들어온 정각 문장만 그 PPS 와 짝지음
+#define GPS_TIME_REJECT_US       1000    // 예측과 이보다 많이 다른 PPS 는 버림 (짝이 잘못 지어진 경우 등)
+#define GPS_TIME_RELOCK_COUNT    3       // 연속으로 이만큼 버려지면 예측이 틀린 것으로 보고 새로 잡음
+#define GPS_TIME_HOLDOVER_US     1500000 // 이 시간 동안 PPS 짝이 없으면 HOLDOVER (드리프트로만 계산)
+#define GPS_TIME_HOLDOVER_MAX_US 600000000 // HOLDOVER 가 이보다 길어지면 NMEA 수신 시각(COARSE)으로 돌아감
+#define GPS_TIME_DRIFT_GAIN      8       // 드리프트 필터: 새 측정값을 1/8 만 반영
+#define GPS_TIME_COARSE_AGE_US   10000000 // COARSE: 이 시간 동안은 수신 지연이 가장 짧았던 문장을 기준으로 유지
+
+typedef enum {
+    GPS_TIME_NONE = 0,  // 아직 시각 모름
+    GPS_TIME_COARSE,    // NMEA 수신 시각으로만 맞춤 (PPS 없음)
+    GPS_TIME_LOCKED,    // PPS 로 맞춤 (1초 이내에 갱신됨)
+    GPS_TIME_HOLDOVER,  // PPS 가 끊김, 마지막 드리프트로 계속 계산 중
+} gps_time_state_t;
+
+typedef struct {
+    // 기준점: 로컬 타이머가 anchor_local_us 일 때 UTC 는 anchor_utc_us
+    int64_t anchor_local_us;
+    int64_t anchor_utc_us;
+    int32_t drift_ppb;          // 로컬 타이머가 느린 정도 (+ 면 로컬 1초 동안 UTC 는 1초보다 더 흐름)
+    bool pps_locked;            // 기준점이 PPS 로 잡혔음 (false 면 COARSE)
+    bool has_anchor;
+
+    // 아직 짝을 못 찾은 PPS (최근 2개). 문장이 늦어서 다음 PPS 뒤에 도착해도 맞는 쪽과 짝지을 수 있게
+    int64_t pps_local_us[2];    // [0] = 가장 최근
+    int pps_pending;            // 유효한 개수 (0~2)
+    int64_t last_utc_us;        // 마지막으로 처리한 문장 시각 (같은 에포크의 RMC/GGA 중복 무시)
+
+    // 통계
+    uint32_t pps_edges;
+    uint32_t samples;           // 짝이 맞아 반영된 PPS 수
+    uint32_t rejected;          // 예측과 너무 달라 버린 PPS 수
+    uint32_t relocks;           // 새로 잡은 횟수 (처음 포함)
+    int32_t last_error_us;      // 마지막 PPS 에서 예측과 실제의 차이
+    uint32_t jitter_us;         // |오차| 의 이동 평균
+    int bad_streak;             // 연속으로 버린 PPS 수
+    int64_t bad_error_us;       // 마지막으로 버린 PPS 의 오차
+} gps_time_t;
+
+void gps_time_init(gps_time_t *t);
+
+// PPS 상승 에지를 잡은 로컬 시각 (ISR 에서 기록한 값)
+void gps_time_pps(gps_time_t *t, int64_t local_us);
+
+// 문장에 담긴 UTC 시각(utc_us)과 그 문장을 받은 로컬 시각(local_us).
+// 정각(ms == 0) 문장이면 직전 PPS 와 짝지어 기준점을 갱신
+void gps_time_utc(gps_time_t *t, int64_t utc_us, int64_t local_us);
+
+// 로컬 시각 -> UTC. 상태(정확도 수준)를 돌려줌 (NONE 이면 *utc_us 는 그대로)
+gps_time_state_t gps_time_to_utc(const gps_time_t *t, int64_t local_us, int64_t *utc_us);
+
+const char *gps_time_state_name(gps_time_state_t state);
@@ -1,148 +1,255 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
+#include <errno.h>
+#include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "driver/uart.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs_flash.h"
+#include "nmea_framer.h"
+#include "nmea_parser.h"
+#include "gps_snapshot.h"
+#include "gps_config.h"
+#include "ubx_nav.h"
+#include "track_log.h"
+#include "gps_clock.h"
+#include "gps_events.h"
+#include "geofence.h"
+#include "gps_assist.h"
+#include "gps_merge.h"
+#include "nmea_ring.h"
+#include "nmea_server.h"
+#include "wifi_sta.h"
 
 static const char *TAG = "GPS_STATUS";
 
-// --- [핀 설정] ---
-#define TXD_PIN (GPIO_NUM_17)
-#define RXD_PIN (GPIO_NUM_16)
-
 // --- [UART 설정] ---
-#define UART_PORT_NUM      UART_NUM_1
-#define UART_BAUD_RATE     9600
+#define UART_BAUD_RATE     9600 // 시작 속도 (gps_configure() 가 실제 속도를 찾아서 바꿈)
 #define RX_BUF_SIZE        2048 // 버퍼를 조금 늘렸습니다
+#define UART_QUEUE_LEN     20   // UART 이벤트 큐 길이
+
+// UBX 프레임도 받을지 (NAV-PVT 위치, 웜 스타트용 궤도 데이터베이스)
+#define GPS_UBX_RX (CONFIG_GPS_UBX_NAV_PVT || CONFIG_GPS_ASSIST)
 
-// --- [데이터 저장용 구조체] ---
+// --- [수신기] ---
+// 수신기(UART) 하나당 하나. 프레이머/파서/결과를 각자 가지므로 한 태스크가 여러 대를 번갈아 처리해도 섞이지 않음.
+// 결과는 gps_merge 가 고른 주 수신기 것만 my_gps / my_sats 로 복사해서 내보냄
 typedef struct {
-    double latitude;    // 위도
-    double longitude;   // 경도
-    int hour, minute, second; // 시간
-    int sat_count;      // 연결된 위성 개수 (중요!)
-    int max_snr;        // 가장 강한 신호 세기 (감도)
-    int fix_quality;    // 0=없음, 1=GPS, 2=DGPS
-} GPS_Data;
-
-GPS_Data my_gps;
-
-// --- [도분 -> 도 변환 함수] ---
-double convert_nmea_to_decimal(double nmea_val) {
-    int degrees = (int)(nmea_val / 100);
-    double minutes = nmea_val - (degrees * 100);
-    return degrees + (minutes / 60.0);
-}
+    uart_port_t port;
+    int tx_pin, rx_pin;
+    QueueHandle_t queue;        // UART 드라이버가 보내는 이벤트(데이터 도착, 버퍼 넘침 등)
+    nmea_framer_t framer;       // 수신 바이트 -> NMEA 한 줄 단위로 자르기
+#if GPS_UBX_RX
+    ubx_decoder_t ubx;          // 수신 바이트 -> UBX 프레임 (NAV-PVT, MGA-DBD)
+#endif
+    nmea_parser_t parser;
+    GPS_Data gps;               // 이 수신기의 파싱 결과
+    gps_sat_table_t sats;
+    gps_config_result_t cfg;
+} gps_rx_t;
 
-// --- [토큰 추출 함수] ---
-// 콤마(,) 사이의 빈 값(Empty Field)도 정확히 처리하기 위한 함수
-char* get_token(char *source, int token_index, char *dest, int dest_size) {
-    int comma_count = 0;
-    int i = 0, j = 0;
-    
-    // 해당 인덱스의 콤마 위치 찾기
-    while (comma_count < token_index && source[i] != '\0') {
-        if (source[i] == ',') comma_count++;
-        i++;
-    }
+static gps_rx_t receivers[] = {
+    { .port = UART_NUM_1, .tx_pin = GPIO_NUM_17, .rx_pin = GPIO_NUM_16 },
+#if CONFIG_GPS_SECOND_RECEIVER
+    { .port = CONFIG_GPS_RX2_UART_NUM, .tx_pin = CONFIG_GPS_RX2_TX_GPIO, .rx_pin = CONFIG_GPS_RX2_RX_GPIO },
+#endif
+};
+#define NUM_RECEIVERS ((int)(sizeof(receivers) / sizeof(receivers[0])))
 
-    // 데이터 복사
-    while (source[i] != ',' && source[i] != '*' && source[i] != '\0' && j < dest_size - 1) {
-        dest[j++] = source[i++];
-    }
-    dest[j] = '\0';
-    return dest;
-}
+static gps_merge_t merge;
 
-// --- [파싱 함수] ---
-void parse_nmea(char *nmea_sentence) {
-    char buffer[32]; // 임시 저장 공간
-
-    // 1. $GPRMC: 시간, 위도, 경도
-    if (strstr(nmea_sentence, "$GPRMC")) {
-        // 시간 (Index 1)
-        get_token(nmea_sentence, 1, buffer, sizeof(buffer));
-        if (strlen(buffer) > 0) {
-            float time_raw = atof(buffer);
-            my_gps.hour = (int)(time_raw / 10000);
-            my_gps.minute = (int)((time_raw - (my_gps.hour * 10000)) / 100);
-            my_gps.second = (int)(time_raw - (my_gps.hour * 10000) - (my_gps.minute * 100));
-            my_gps.hour = (my_gps.hour + 9) % 24; // 한국 시간
-        }
+#if CONFIG_GPS_NMEA_SERVER
+// --- [NMEA TCP 서버] ---
+// 주 수신기의 원본 문장을 링에 한 번만 넣고, 서버 태스크가 접속한 클라이언트들에게 그대로 보냄.
+// 링에 쓰는 건 UART 수신 루프(app_main) 하나뿐이므로 잠금 없음 (느린 클라이언트 때문에 기다리는 일도 없음)
+#define NMEA_RING_SIZE     16384 // 115200 baud 로 1초 남짓 (클라이언트가 이보다 많이 밀리면 건너뜀)
+#define NMEA_SERVER_POLL_MS 20   // 새 문장을 클라이언트로 보내기까지 최대 지연
 
-        // 위도 (Index 3)
-        get_token(nmea_sentence, 3, buffer, sizeof(buffer));
-        if (strlen(buffer) > 0) my_gps.latitude = convert_nmea_to_decimal(atof(buffer));
+static uint8_t nmea_ring_buf[NMEA_RING_SIZE];
+static nmea_ring_t nmea_ring;
+static nmea_server_t nmea_server;
+#endif
 
-        // 경도 (Index 5)
-        get_token(nmea_sentence, 5, buffer, sizeof(buffer));
-        if (strlen(buffer) > 0) my_gps.longitude = convert_nmea_to_decimal(atof(buffer));
-    }
-    
-    // 2. $GPGGA: 위성 개수, 고정 품질
-    else if (strstr(nmea_sentence, "$GPGGA")) {
-        // Fix Quality (Index 6): 0=Invalid, 1=GPS fix, 2=DGPS fix
-        get_token(nmea_sentence, 6, buffer, sizeof(buffer));
-        my_gps.fix_quality = atoi(buffer);
-
-        // 위성 개수 (Index 7) - 이게 중요!
-        get_token(nmea_sentence, 7, buffer, sizeof(buffer));
-        my_gps.sat_count = atoi(buffer);
-    }
+#define DISPLAY_PERIOD_MS  2000 // 출력 최소 간격
 
-    // 3. $GPGSV: 신호 세기 (SNR)
-    else if (strstr(nmea_sentence, "$GPGSV")) {
-        // GSV 문장은 위성 4개씩 정보를 담고 있음.
-        // SNR 위치: 7, 11, 15, 19 번째 인덱스
-        int snr_indices[] = {7, 11, 15, 19};
-        
-        // GSV 메시지가 여러 줄로 오므로, 매번 0으로 초기화하지 않고 최댓값을 갱신함
-        // (단, 1번 메시지가 올 때만 초기화하는 로직을 추가하면 더 정확하지만, 여기선 간단히 유지)
-        
-        for (int k = 0; k < 4; k++) {
-            get_token(nmea_sentence, snr_indices[k], buffer, sizeof(buffer));
-            int snr = atoi(buffer);
-            if (snr > my_gps.max_snr) {
-                my_gps.max_snr = snr; // 가장 센 신호 기록
-            }
-        }
-    }
+// --- [좌표 출력용 변환] ---
+// 1e-7 도 정수 -> "37.5665350" 형태 문자열 (출력할 때만 변환, 계산은 정수로)
+static void format_coord(char *out, size_t size, int32_t e7) {
+    uint32_t abs_val = e7 < 0 ? -(uint32_t)e7 : (uint32_t)e7;
+    snprintf(out, size, "%s%lu.%07lu", e7 < 0 ? "-" : "",
+             (unsigned long)(abs_val / GPS_COORD_SCALE), (unsigned long)(abs_val % GPS_COORD_SCALE));
 }
 
 // --- [출력 태스크] ---
-// 너무 자주 출력되면 정신없으니 2초마다 종합해서 보여줌
+// fix 이벤트를 2초 간격으로 구독해서, 깨어나면 스냅샷 복사본만 읽음 (파서와 잠금 없음).
+// 너무 자주 출력되면 정신없으니 간격 제한은 구독할 때 정함
 void display_task(void *pvParameters) {
+    GPS_Data gps;
+    static gps_sat_table_t sats; // 약 800 바이트라 스택 대신 정적 영역에
+    uint32_t events;
+
+    gps_events_subscribe(NULL, GPS_EVENT_FIX, DISPLAY_PERIOD_MS);
     while (1) {
-        if (my_gps.sat_count > 0) {
+        // 새 fix 알림을 기다림. 위성을 못 잡아 알림이 없어도 2초 남짓마다 상태는 출력
+        // (알림 간격과 같으면 알림 직전에 시간 초과로 한 번 더 출력될 수 있어서 조금 길게)
+        xTaskNotifyWait(0, UINT32_MAX, &events, pdMS_TO_TICKS(DISPLAY_PERIOD_MS + 500));
+
+        if (gps_snapshot_read(&gps) && gps.sat_count > 0) {
             ESP_LOGI(TAG, "========================================");
             ESP_LOGI(TAG, " 🛰️  위성 상태 모니터링");
             ESP_LOGI(TAG, "========================================");
-            ESP_LOGI(TAG, " [시 간] %02d시 %02d분 %02d초 (KST)", my_gps.hour, my_gps.minute, my_gps.second);
-            ESP_LOGI(TAG, " [위 치] 위도: %.6f / 경도: %.6f", my_gps.latitude, my_gps.longitude);
-            ESP_LOGI(TAG, " [개 수] 연결된 위성: %d개", my_gps.sat_count);
+            char lat[16], lon[16];
+            format_coord(lat, sizeof(lat), gps.latitude);
+            format_coord(lon, sizeof(lon), gps.longitude);
+
+            // 시간은 GPS 로 맞춘 시계에서 (TZ 로 한국 시간 변환)
+            int64_t utc_us;
+            gps_clock_status_t clk;
+            gps_clock_get_status(&clk);
+            if (gps_clock_now(&utc_us) != GPS_TIME_NONE) {
+                time_t sec = utc_us / 1000000;
+                struct tm tm;
+                localtime_r(&sec, &tm);
+                ESP_LOGI(TAG, " [시 간] %04d-%02d-%02d %02d:%02d:%02d.%03d (KST, %s)",
+                         tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                         (int)(utc_us / 1000 % 1000), gps_time_state_name(clk.state));
+            }
+            if (clk.samples > 0) {
+                ESP_LOGI(TAG, " [시 계] 드리프트 %+.2f ppm, PPS 오차 %ld us (평균 %lu us), 버림 %lu",
+                         clk.drift_ppb / 1000.0, (long)clk.last_error_us,
+                         (unsigned long)clk.jitter_us, (unsigned long)clk.rejected);
+            }
+#if CONFIG_GPS_ASSIST
+            gps_assist_status_t assist;
+            gps_assist_get_status(&assist);
+            if (assist.ttff_ms > 0) {
+                ESP_LOGI(TAG, " [시 작] 첫 fix 까지 %.1f 초 (지난 부팅 %.1f 초, 웜 스타트 %s)",
+                         assist.ttff_ms / 1000.0, assist.prev_ttff_ms / 1000.0,
+                         assist.pos_injected || assist.db_injected ? "O" : "X");
+            }
+#endif
+            ESP_LOGI(TAG, " [위 치] 위도: %s / 경도: %s", lat, lon);
+            ESP_LOGI(TAG, " [개 수] 연결된 위성: %d개", gps.sat_count);
+            // 시스템별로 실제 신호를 잡고 있는(SNR > 0) 위성 수
+            int tracked[GNSS_COUNT] = {0};
+            if (gps_snapshot_read_sats(&sats)) {
+                for (int i = 0; i < sats.count; i++) {
+                    if (sats.sats[i].snr > 0) tracked[sats.sats[i].system]++;
+                }
+            }
+            for (int i = 0; i < GNSS_COUNT; i++) {
+                if (gps.sky[i].in_view == 0) continue;
+                ESP_LOGI(TAG, "   - %-8s 보이는 위성 %2d개, 추적 %2d개, 최고 %d dB",
+                         gnss_system_name(i), gps.sky[i].in_view, tracked[i], gps.sky[i].max_snr);
+            }
             
             // 신호 품질 평가
             char *quality = "나쁨 🔴";
-            if (my_gps.max_snr >= 40) quality = "최상 🟢";
-            else if (my_gps.max_snr >= 30) quality = "좋음 🟡";
-            else if (my_gps.max_snr >= 20) quality = "보통 🟠";
+            if (gps.max_snr >= 40) quality = "최상 🟢";
+            else if (gps.max_snr >= 30) quality = "좋음 🟡";
+            else if (gps.max_snr >= 20) quality = "보통 🟠";
 
-            ESP_LOGI(TAG, " [감 도] 최고 신호 세기: %d dB (%s)", my_gps.max_snr, quality);
+            ESP_LOGI(TAG, " [감 도] 최고 신호 세기: %d dB (%s)", gps.max_snr, quality);
+            for (int r = 0; r < NUM_RECEIVERS; r++) {
+                const nmea_framer_t *fr = &receivers[r].framer;
+                ESP_LOGI(TAG, " [수 신] #%d%s 정상: %lu / 체크섬 오류: %lu / 넘침: %lu", r,
+                         r == merge.primary ? "(사용 중)" : "", (unsigned long)fr->stats.accepted,
+                         (unsigned long)fr->stats.rejected, (unsigned long)fr->stats.overflowed);
+            }
+#if CONFIG_GPS_NMEA_SERVER
+            if (nmea_server.ring != NULL) { // 서버 태스크가 열기 전에는 표시 안 함
+                ESP_LOGI(TAG, " [서 버] %s, 클라이언트 %d명, 보낸 %llu 바이트, 건너뜀 %lu, 느려서 끊음 %lu",
+                         wifi_sta_connected() ? "Wi-Fi 연결됨" : "Wi-Fi 연결 안 됨", nmea_server_clients(&nmea_server),
+                         (unsigned long long)nmea_server.stats.bytes_sent, (unsigned long)nmea_server.stats.skips,
+                         (unsigned long)nmea_server.stats.dropped);
+            }
+#endif
+#if CONFIG_GPS_TRACK_LOG
+            track_log_stats_t trk;
+            track_log_get_stats(&trk);
+            ESP_LOGI(TAG, " [기 록] fix %lu개, %lu 바이트 (fix 당 %.1f), 페이지 %lu, 버림 %lu",
+                     (unsigned long)trk.fixes, (unsigned long)trk.bytes,
+                     trk.fixes ? (double)trk.bytes / trk.fixes : 0.0,
+                     (unsigned long)trk.pages, (unsigned long)trk.dropped);
+#endif
             ESP_LOGI(TAG, "========================================\n");
-            
-            // 다음 측정을 위해 SNR 리셋 (순간적인 값 변화를 보기 위해)
-            my_gps.max_snr = 0; 
         } else {
             ESP_LOGW(TAG, "위성 찾는 중... (하늘을 보여주세요!)");
         }
-        vTaskDelay(pdMS_TO_TICKS(2000)); // 2초마다 갱신
     }
 }
 
-void init_uart() {
+#if CONFIG_GPS_GEOFENCE
+// --- [지오펜스 태스크] ---
+// 구역 목록 (예시). 실제 사용 시 여기를 바꾸거나 파일/NVS 에서 읽어서 geofence_add_*() 로 추가
+typedef struct {
+    const char *name;
+    int32_t lat, lon;       // 원의 중심 (1e-7 도)
+    uint32_t radius_m;
+} zone_circle_t;
+
+static const zone_circle_t zone_circles[] = {
+    { "서울시청",   375665350, 1269779690, 150 },
+    { "서울역",     375546790, 1269706030, 250 },
+};
+
+static const geofence_point_t zone_gyeongbokgung[] = { // 경복궁 담장 (대략)
+    { 375825000, 1269740000 }, { 375825000, 1269800000 },
+    { 375760000, 1269800000 }, { 375760000, 1269740000 },
+};
+
+static void on_geofence(int fence, uint32_t tag, geofence_event_t ev, void *ctx) {
+    const char *name = tag < sizeof(zone_circles) / sizeof(zone_circles[0]) ? zone_circles[tag].name : "경복궁";
+    ESP_LOGI(TAG, " [구 역] %s %s", name, ev == GEOFENCE_ENTER ? "들어감" : "나옴");
+}
+
+// fix 마다 깨어나서 스냅샷 위치로 검사 (파서 태스크는 알림만 보내고 기다리지 않음)
+static void geofence_task(void *pvParameters) {
+    static geofence_t fences;
+    int num_circles = sizeof(zone_circles) / sizeof(zone_circles[0]);
+    int num_points = sizeof(zone_gyeongbokgung) / sizeof(zone_gyeongbokgung[0]);
+
+    if (!geofence_init(&fences, num_circles + 1, num_points, on_geofence, NULL)) {
+        ESP_LOGE(TAG, "지오펜스 메모리 부족");
+        vTaskDelete(NULL);
+    }
+    for (int i = 0; i < num_circles; i++) {
+        geofence_add_circle(&fences, zone_circles[i].lat, zone_circles[i].lon, zone_circles[i].radius_m, i);
+    }
+    geofence_add_polygon(&fences, zone_gyeongbokgung, num_points, num_circles);
+    geofence_build(&fences);
+
+    GPS_Data gps;
+    uint32_t events;
+    gps_events_subscribe(NULL, GPS_EVENT_FIX, 0);
+    while (1) {
+        xTaskNotifyWait(0, UINT32_MAX, &events, portMAX_DELAY);
+        if (gps_snapshot_read(&gps) && gps.valid) geofence_update(&fences, gps.latitude, gps.longitude);
+    }
+}
+#endif
+
+#if CONFIG_GPS_NMEA_SERVER
+static void nmea_server_task(void *pvParameters) {
+    // IP 를 받기 전에도 열 수 있음 (모든 주소에서 대기). 실패하면 잠시 뒤 다시
+    while (!nmea_server_open(&nmea_server, &nmea_ring, CONFIG_GPS_NMEA_SERVER_PORT)) {
+        ESP_LOGW(TAG, "NMEA 서버 포트 %d 열기 실패 (errno %d)", CONFIG_GPS_NMEA_SERVER_PORT, errno);
+        vTaskDelay(pdMS_TO_TICKS(5000));
+    }
+    ESP_LOGI(TAG, "NMEA 서버: 포트 %d", CONFIG_GPS_NMEA_SERVER_PORT);
+    while (1) {
+        nmea_server_poll(&nmea_server, NMEA_SERVER_POLL_MS);
+    }
+}
+#endif
+
+static void init_uart(gps_rx_t *rx) {
     const uart_config_t uart_config = {
         .baud_rate = UART_BAUD_RATE,
         .data_bits = UART_DATA_8_BITS,
@@ -151,35 +258,185 @@ void init_uart() {
         .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
         .source_clk = UART_SCLK_DEFAULT,
     };
-    uart_driver_install(UART_PORT_NUM, RX_BUF_SIZE * 2, 0, 0, NULL, 0);
-    uart_param_config(UART_PORT_NUM, &uart_config);
-    uart_set_pin(UART_PORT_NUM, TXD_PIN, RXD_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    // 이벤트 큐를 같이 만들어서, 데이터가 들어왔을 때만 깨어나도록 함
+    uart_driver_install(rx->port, RX_BUF_SIZE * 2, 0, UART_QUEUE_LEN, &rx->queue, 0);
+    uart_param_config(rx->port, &uart_config);
+    uart_set_pin(rx->port, rx->tx_pin, rx->rx_pin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+}
+
+// --- [갱신 알림] ---
+// 바뀐 내용이 있으면 스냅샷으로 발행하고, 구독한 태스크들을 깨움
+static void on_gps_update(uint32_t updated) {
+    if (updated == 0) return;
+
+    gps_snapshot_publish(&my_gps);
+    if (updated & GPS_UPDATED_SKY) gps_snapshot_publish_sats(&my_sats);
+#if CONFIG_GPS_TRACK_LOG
+    if (updated & GPS_UPDATED_FIX) track_log_fix(&my_gps);
+#endif
+    if (updated & (GPS_UPDATED_FIX | GPS_UPDATED_TIME)) gps_clock_on_fix(&my_gps);
+    gps_events_publish(updated, &my_gps); // 스냅샷/시계를 갱신한 다음에 알려야 최신 값을 읽음
+}
+
+// 수신기 하나가 갱신됨: 주 수신기 것이면 출력(my_gps)으로 복사해서 알림
+static void on_rx_update(gps_rx_t *rx, uint32_t updated) {
+    if (updated == 0) return;
+
+    const GPS_Data *all[NUM_RECEIVERS];
+    for (int i = 0; i < NUM_RECEIVERS; i++) all[i] = &receivers[i].gps;
+    int before = merge.primary;
+    if (!gps_merge_update(&merge, rx - receivers, updated, all, NUM_RECEIVERS, esp_timer_get_time() / 1000)) {
+        return;
+    }
+
+    // 주 수신기가 바뀌었으면 위성 목록도 새 수신기 것으로
+    if (merge.primary != before) {
+        if (before >= 0) ESP_LOGW(TAG, "수신기 #%d -> #%d 로 전환", before, merge.primary);
+        updated |= GPS_UPDATED_SKY;
+    }
+    my_gps = rx->gps;
+    if (updated & GPS_UPDATED_SKY) my_sats = rx->sats;
+    on_gps_update(updated);
+}
+
+// --- [줄 완성 콜백] ---
+// 프레이머 버퍼 안의 줄을 그대로 그 수신기의 파서에 넘김 (복사 없음)
+static void on_nmea_line(char *line, size_t len, void *ctx) {
+    gps_rx_t *rx = ctx;
+#if CONFIG_GPS_NMEA_SERVER
+    // 파서가 줄을 고치기 전에 (주 수신기가 아직 없으면 첫 번째 수신기 것)
+    int out = merge.primary >= 0 ? merge.primary : 0;
+    if (rx == &receivers[out]) nmea_ring_put_line(&nmea_ring, line, len);
+#endif
+    on_rx_update(rx, nmea_parse(&rx->parser, line));
+}
+
+// --- [UART 수신 처리] ---
+// 1바이트씩 uart_read_bytes()를 부르면 글자마다 드라이버 호출 + 링버퍼 잠금이 생김.
+// 이벤트가 올 때마다 쌓여 있는 바이트를 한 번에 프레이머 버퍼로 읽어 들임.
+static void read_uart_data(gps_rx_t *rx) {
+    size_t buffered = 0;
+    uart_get_buffered_data_len(rx->port, &buffered);
+
+    while (buffered > 0) {
+        size_t space;
+        char *dst = nmea_framer_write_ptr(&rx->framer, &space);
+        size_t want = buffered < space ? buffered : space;
+
+        int rxBytes = uart_read_bytes(rx->port, dst, want, 0);
+        if (rxBytes <= 0) break;
+
+#if GPS_UBX_RX
+        // 같은 바이트에서 UBX 프레임도 찾음 (프레이머가 줄 끝을 '\0' 으로 바꾸기 전에)
+        for (int i = 0; i < rxBytes; i++) {
+            if (!ubx_decoder_push(&rx->ubx, (uint8_t)dst[i])) continue;
+            on_rx_update(rx, ubx_apply_frame_to(&rx->gps, &rx->ubx));
+#if CONFIG_GPS_ASSIST
+            if (rx == &receivers[0]) gps_assist_on_ubx(&rx->ubx);
+#endif
+        }
+#endif
+
+        nmea_framer_commit(&rx->framer, rxBytes); // 완성된 줄은 여기서 nmea_parse 까지 호출됨
+        buffered -= rxBytes;
+    }
+}
+
+static void handle_uart_event(gps_rx_t *rx, const uart_event_t *event) {
+    switch (event->type) {
+        case UART_DATA:
+            read_uart_data(rx);
+            break;
+
+        // 처리가 밀려서 넘쳤을 때: 버퍼를 비우고 줄 경계부터 다시 시작.
+        // 이벤트 큐는 비우지 않음 (xQueueReset 은 큐 집합에 알림을 남겨서 집합이 넘칠 수 있음).
+        // 남은 이벤트는 평소처럼 하나씩 꺼내지고, 데이터 이벤트는 읽을 바이트가 없어서 그냥 지나감
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            ESP_LOGW(TAG, "UART%d 버퍼 넘침! 수신 버퍼를 비웁니다", (int)rx->port);
+            uart_flush_input(rx->port);
+            nmea_framer_reset(&rx->framer);
+#if GPS_UBX_RX
+            ubx_decoder_init(&rx->ubx);
+#endif
+            break;
+
+        default:
+            break;
+    }
 }
 
 void app_main(void) {
-    init_uart();
-    uint8_t *data = (uint8_t *) malloc(RX_BUF_SIZE + 1);
-    char line_buffer[256];
-    int line_pos = 0;
+    setenv("TZ", "KST-9", 1); // localtime() 이 한국 시간을 돌려주도록
+    tzset();
+    // NVS (웜 스타트 저장용). 형식이 바뀌었거나 공간이 없으면 지우고 다시
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        nvs_flash_init();
+    }
+    gps_events_init();
+    gps_clock_init(CONFIG_GPS_PPS_GPIO);
+    gps_merge_init(&merge);
+
+    for (int r = 0; r < NUM_RECEIVERS; r++) {
+        gps_rx_t *rx = &receivers[r];
+        init_uart(rx);
+
+        // 수신기 보레이트 확인 + 고속 모드 설정 (실패해도 확인된 속도로 계속 동작)
+        if (gps_configure(rx->port, &rx->cfg) != ESP_OK) {
+            ESP_LOGW(TAG, "GPS #%d 설정 일부 실패 (%s, %lu baud, %d Hz)", r,
+                     gps_receiver_name(rx->cfg.receiver), (unsigned long)rx->cfg.baud, rx->cfg.rate_hz);
+        }
+#if CONFIG_GPS_ASSIST
+        // 저장해 둔 위치/시각/궤도를 수신기에 넣어서 첫 fix 를 앞당김 (실패해도 콜드 스타트로 계속).
+        // 저장은 첫 번째 수신기 기준 (같은 자리에 있으므로 위치/시각은 다른 수신기와 같음)
+        if (r == 0) gps_assist_init(rx->port, &rx->cfg);
+#endif
+        nmea_framer_init(&rx->framer, on_nmea_line, rx);
+        nmea_parser_init(&rx->parser, &rx->gps, &rx->sats);
+#if GPS_UBX_RX
+        ubx_decoder_init(&rx->ubx);
+#endif
+    }
+
+    // 모든 수신기의 UART 이벤트 큐를 한 집합으로 묶어서, 어느 쪽이든 데이터가 오면 깨어남.
+    // 설정하는 동안 쌓인 데이터/이벤트는 버리고 새로 시작 (큐가 비어 있어야 집합에 넣을 수 있음)
+    QueueSetHandle_t uart_set = xQueueCreateSet(UART_QUEUE_LEN * NUM_RECEIVERS);
+    for (int r = 0; r < NUM_RECEIVERS; r++) {
+        uart_flush_input(receivers[r].port);
+        xQueueReset(receivers[r].queue);
+        xQueueAddToSet(receivers[r].queue, uart_set);
+    }
+
+#if CONFIG_GPS_TRACK_LOG
+    track_log_init(); // 파티션이 없으면 경고만 남기고 기록 없이 동작
+#endif
 
     // 출력용 태스크 별도 실행
     xTaskCreate(display_task, "display_task", 4096, NULL, 5, NULL);
+#if CONFIG_GPS_NMEA_SERVER
+    nmea_ring_init(&nmea_ring, nmea_ring_buf, sizeof(nmea_ring_buf));
+    if (wifi_sta_start(CONFIG_GPS_WIFI_SSID, CONFIG_GPS_WIFI_PASSWORD) == ESP_OK) {
+        // 보내기는 논블로킹이라 금방 끝나지만, 수신 루프(우선순위 1)보다 조금만 높게
+        xTaskCreate(nmea_server_task, "nmea_server", 4096, NULL, 2, NULL);
+    } else {
+        ESP_LOGE(TAG, "Wi-Fi 시작 실패: NMEA 서버 없이 계속");
+    }
+#endif
+#if CONFIG_GPS_GEOFENCE
+    xTaskCreate(geofence_task, "geofence_task", 3072, NULL, 6, NULL);
+#endif
 
+    uart_event_t event;
     while (1) {
-        int rxBytes = uart_read_bytes(UART_PORT_NUM, data, 1, 20 / portTICK_PERIOD_MS);
-        if (rxBytes > 0) {
-            if (data[0] == '\n' || data[0] == '\r') {
-                if (line_pos > 0) {
-                    line_buffer[line_pos] = '\0';
-                    parse_nmea(line_buffer);
-                    line_pos = 0;
-                }
-            } else {
-                if (line_pos < sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = (char)data[0];
-                }
-            }
+        // 어느 수신기든 데이터가 들어올 때까지 잠들어 있음 (폴링 없음)
+        QueueSetMemberHandle_t ready = xQueueSelectFromSet(uart_set, portMAX_DELAY);
+        for (int r = 0; r < NUM_RECEIVERS; r++) {
+            if (receivers[r].queue != ready) continue;
+            // 집합의 알림 하나 = 큐의 이벤트 하나 (큐를 따로 비우지 않으므로 항상 있음)
+            if (xQueueReceive(ready, &event, 0) == pdTRUE) handle_uart_event(&receivers[r], &event);
+            break;
         }
     }
-    free(data);
-}
\ No newline at end of file
+}
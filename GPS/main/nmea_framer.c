@@ -0,0 +1,118 @@
+#include <string.h>
+#include "nmea_framer.h"
+
+void nmea_framer_init(nmea_framer_t *fr, nmea_line_cb_t on_line, void *ctx) {
+    fr->on_line = on_line;
+    fr->ctx = ctx;
+    memset(&fr->stats, 0, sizeof(fr->stats));
+    nmea_framer_reset(fr);
+}
+
+void nmea_framer_reset(nmea_framer_t *fr) {
+    fr->len = 0;
+    fr->scan = 0;
+    fr->discarding = false;
+    fr->cs_state = NMEA_CS_START;
+}
+
+char *nmea_framer_write_ptr(nmea_framer_t *fr, size_t *space) {
+    *space = sizeof(fr->buf) - fr->len;
+    return fr->buf + fr->len;
+}
+
+// 16진수 한 글자 -> 값 (아니면 -1). 체크섬은 대문자로 오지만 소문자도 허용
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// '$' 뒤의 바이트 하나를 체크섬 상태에 반영
+static void checksum_step(nmea_framer_t *fr, char c) {
+    switch (fr->cs_state) {
+        case NMEA_CS_BODY:
+            if (c == '*') fr->cs_state = NMEA_CS_HEX;
+            else fr->cs_calc ^= (uint8_t)c;
+            break;
+        case NMEA_CS_HEX: {
+            int v = hex_value(c);
+            if (v < 0 || fr->cs_digits >= 2) {
+                fr->cs_state = NMEA_CS_BAD;
+            } else {
+                fr->cs_given = (uint8_t)((fr->cs_given << 4) | v);
+                fr->cs_digits++;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static bool checksum_ok(const nmea_framer_t *fr) {
+    return fr->cs_state == NMEA_CS_HEX && fr->cs_digits == 2 && fr->cs_given == fr->cs_calc;
+}
+
+void nmea_framer_commit(nmea_framer_t *fr, size_t n) {
+    size_t start = 0; // 현재 줄의 시작 위치
+    fr->len += n;
+
+    for (size_t i = fr->scan; i < fr->len; i++) {
+        char c = fr->buf[i];
+        if (c == '\n' || c == '\r') {
+            // '$' 가 없었던 줄(빈 줄, 잡음)이나 버리는 중인 줄은 넘기지 않음
+            if (!fr->discarding && fr->cs_state != NMEA_CS_START) {
+                if (checksum_ok(fr)) {
+                    fr->buf[i] = '\0';
+                    fr->stats.accepted++;
+                    fr->on_line(fr->buf + start, i - start, fr->ctx);
+                } else {
+                    fr->stats.rejected++;
+                }
+            }
+            fr->discarding = false;
+            fr->cs_state = NMEA_CS_START;
+            start = i + 1;
+        } else if (c == '$') {
+            // 끝나지 않은 문장 도중에 새 문장이 시작됨 -> 앞의 것은 깨진 문장
+            if (!fr->discarding && fr->cs_state != NMEA_CS_START) fr->stats.rejected++;
+            fr->discarding = false;
+            fr->cs_state = NMEA_CS_BODY;
+            fr->cs_calc = 0;
+            fr->cs_given = 0;
+            fr->cs_digits = 0;
+            start = i;
+        } else if (fr->discarding) {
+            continue;
+        } else if (fr->cs_state == NMEA_CS_START) {
+            start = i + 1; // '$' 이전의 잡음은 건너뜀
+        } else if (i - start >= NMEA_MAX_LINE - 1) {
+            fr->discarding = true;
+            fr->stats.overflowed++;
+        } else {
+            checksum_step(fr, c);
+        }
+    }
+
+    // 남은 미완성 줄을 버퍼 앞으로 당김 (버리는 중이면 그냥 비움)
+    if (fr->discarding) {
+        fr->len = 0;
+    } else if (start > 0) {
+        memmove(fr->buf, fr->buf + start, fr->len - start);
+        fr->len -= start;
+    }
+    fr->scan = fr->len;
+}
+
+void nmea_framer_feed(nmea_framer_t *fr, const char *data, size_t n) {
+    while (n > 0) {
+        size_t space;
+        char *dst = nmea_framer_write_ptr(fr, &space);
+        size_t chunk = n < space ? n : space;
+        memcpy(dst, data, chunk);
+        nmea_framer_commit(fr, chunk);
+        data += chunk;
+        n -= chunk;
+    }
+}
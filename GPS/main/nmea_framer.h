@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// --- [NMEA 줄 프레이머] ---
+// UART 에서 묶음(bulk)으로 읽은 바이트를 버퍼에 그대로 받아서
+// 줄바꿈(\r, \n) 단위로 잘라 콜백으로 넘겨줍니다.
+// 줄은 버퍼 안에서 '\0' 으로 끝을 막아 포인터만 넘기므로 복사가 없습니다.
+// 줄을 자르면서 바이트마다 XOR 체크섬도 같이 계산해서,
+// "*hh" 체크섬이 맞는 문장만 콜백으로 넘깁니다 (검증용으로 다시 훑지 않음).
+// '$' 는 문장 맨 앞에만 나오므로, '$' 를 만나면 거기서 새 문장을 시작합니다.
+// (UBX 바이너리 프레임이 섞여 들어와도 다음 NMEA 문장을 놓치지 않음)
+
+#define NMEA_MAX_LINE          256  // 한 줄 최대 길이 (표준은 82자, 여유 있게)
+#define NMEA_FRAMER_BUF_SIZE   512  // 읽기 버퍼 (미완성 줄 + 새로 들어온 바이트)
+
+// 완성된 한 줄을 받는 콜백 (line 은 '\0' 으로 끝나며 콜백 안에서 수정해도 됨)
+typedef void (*nmea_line_cb_t)(char *line, size_t len, void *ctx);
+
+// 체크섬 계산 상태 (한 줄 안에서)
+typedef enum {
+    NMEA_CS_START = 0,  // '$' 를 기다리는 중 (그 전 바이트는 무시)
+    NMEA_CS_BODY,       // '$' 와 '*' 사이: XOR 누적
+    NMEA_CS_HEX,        // '*' 뒤 16진수 2자리 읽는 중
+    NMEA_CS_BAD,        // 형식이 깨짐 -> 줄 끝에서 버림
+} nmea_cs_state_t;
+
+// 줄 단위 수신 통계
+typedef struct {
+    uint32_t accepted;      // 체크섬 통과해서 파서로 넘긴 줄
+    uint32_t rejected;      // '$' 로 시작했지만 체크섬 불일치 / 체크섬 없음 / 형식 오류
+    uint32_t overflowed;    // NMEA_MAX_LINE 보다 길어서 버린 줄
+} nmea_framer_stats_t;
+
+typedef struct {
+    char buf[NMEA_FRAMER_BUF_SIZE];
+    size_t len;             // buf 에 들어있는 바이트 수
+    size_t scan;            // 다음에 검사할 위치 (이미 본 바이트는 다시 보지 않음)
+    bool discarding;        // 너무 긴 줄은 다음 줄바꿈까지 버리는 중
+    nmea_cs_state_t cs_state;
+    uint8_t cs_calc;        // 계산한 체크섬 ('$' 와 '*' 사이 XOR)
+    uint8_t cs_given;       // 문장 끝에 붙어 온 체크섬
+    uint8_t cs_digits;      // '*' 뒤에서 읽은 16진수 자리 수
+    nmea_framer_stats_t stats;
+    nmea_line_cb_t on_line;
+    void *ctx;
+} nmea_framer_t;
+
+void nmea_framer_init(nmea_framer_t *fr, nmea_line_cb_t on_line, void *ctx);
+// 버퍼와 줄 상태만 비움 (통계는 유지)
+void nmea_framer_reset(nmea_framer_t *fr);
+
+// uart_read_bytes() 가 직접 써 넣을 위치와 남은 공간
+char *nmea_framer_write_ptr(nmea_framer_t *fr, size_t *space);
+// write_ptr 에 n 바이트를 채웠다고 알림 -> 완성된 줄마다 콜백 호출
+void nmea_framer_commit(nmea_framer_t *fr, size_t n);
+// 다른 버퍼에 있는 데이터를 밀어 넣을 때 (PC 테스트/재생용)
+void nmea_framer_feed(nmea_framer_t *fr, const char *data, size_t n);
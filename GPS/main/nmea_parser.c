@@ -0,0 +1,417 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nmea_parser.h"
+
+GPS_Data my_gps;
+gps_sat_table_t my_sats;
+
+// parse_nmea() 가 쓰는 기본 파서 (my_gps / my_sats 에 씀)
+static nmea_parser_t default_parser = { .gps = &my_gps, .sats = &my_sats };
+
+void nmea_parser_init(nmea_parser_t *p, GPS_Data *gps, gps_sat_table_t *sats) {
+    memset(p, 0, sizeof(*p));
+    p->gps = gps;
+    p->sats = sats;
+}
+
+// --- [도분 -> 도 변환 함수 (정수 연산)] ---
+// 예: "3733.9921" -> 37도 + 33.9921분 -> 37.5665350도 -> 375665350
+// 분(minute)을 1e-7 단위 정수로 읽은 뒤 60으로 나눠서 더함 (소수 7자리 넘는 부분은 버림)
+// 정수 부분은 5자리까지라 도가 999 까지 나올 수 있음: 180 도나 60 분을 넘으면 깨진 값이므로 false
+// (int32 로 1e-7 도를 곱하면 214 도부터 넘침)
+bool nmea_parse_coord(const char *p, int len, int32_t *out_e7) {
+    int32_t int_part = 0;   // 소수점 앞 (dddmm)
+    int32_t frac = 0;       // 소수점 뒤 (1e-7 분 단위)
+    int32_t scale = 1000000;
+    int i = 0;
+
+    for (; i < len && p[i] != '.'; i++) {
+        if (p[i] < '0' || p[i] > '9' || i >= 5) return false;
+        int_part = int_part * 10 + (p[i] - '0');
+    }
+    if (i < 3) return false; // 최소 "dmm"
+    if (i < len) i++;         // '.' 건너뛰기
+    for (; i < len; i++) {
+        if (p[i] < '0' || p[i] > '9') return false;
+        if (scale > 0) {
+            frac += (p[i] - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    int32_t degrees = int_part / 100;
+    if (degrees > 180 || int_part % 100 >= 60) return false;
+    int32_t minutes_e7 = (int_part % 100) * GPS_COORD_SCALE + frac;
+    *out_e7 = degrees * GPS_COORD_SCALE + (minutes_e7 + 30) / 60;
+    return true;
+}
+
+// --- [시간 변환 함수 (정수 연산)] ---
+// 예: "032510.25" -> 3시 25분 10.25초 -> 12310250 ms
+bool nmea_parse_time(const char *p, int len, uint32_t *out_ms) {
+    if (len < 6) return false;
+    for (int i = 0; i < 6; i++) {
+        if (p[i] < '0' || p[i] > '9') return false;
+    }
+    uint32_t hh = (p[0] - '0') * 10 + (p[1] - '0');
+    uint32_t mm = (p[2] - '0') * 10 + (p[3] - '0');
+    uint32_t ss = (p[4] - '0') * 10 + (p[5] - '0');
+    if (hh > 23 || mm > 59 || ss > 60) return false; // 60 = 윤초
+
+    uint32_t ms = 0;
+    uint32_t scale = 100;
+    if (len > 6) {
+        if (p[6] != '.') return false;
+        for (int i = 7; i < len; i++) {
+            if (p[i] < '0' || p[i] > '9') return false;
+            ms += (p[i] - '0') * scale;
+            scale /= 10;
+        }
+    }
+    *out_ms = ((hh * 60 + mm) * 60 + ss) * 1000 + ms;
+    return true;
+}
+
+// --- [필드 분리 함수] ---
+// 콤마 위치를 한 번에 전부 찾아 둠. 빈 값(Empty Field)은 길이 0 인 필드가 됨.
+// '*'(체크섬 시작) 이나 문장 끝에서 멈춤.
+int nmea_split_fields(const char *sentence, nmea_fields_t *f) {
+    int n = 0;
+    int i = 0;
+
+    f->base = sentence;
+    f->off[0] = 0;
+    for (;; i++) {
+        char c = sentence[i];
+        if (c == ',') {
+            if (n + 1 >= NMEA_MAX_FIELDS) break; // 필드가 너무 많으면 뒤는 무시
+            f->off[++n] = i + 1;
+        } else if (c == '*' || c == '\0') {
+            break;
+        }
+    }
+    f->off[n + 1] = i + 1;
+    f->count = n + 1;
+    return f->count;
+}
+
+// --- [고정소수점 숫자 변환] ---
+// 예: ("38.2", decimals=2) -> 3820,  ("-5", 1) -> -50
+bool nmea_parse_fixed(const char *p, int len, int decimals, int32_t *out) {
+    int32_t value = 0;
+    int frac_digits = -1; // 소수점을 만나기 전에는 -1
+    bool negative = false;
+    int i = 0;
+
+    if (len > 0 && p[0] == '-') {
+        negative = true;
+        i++;
+    }
+    if (i >= len) return false;
+    for (; i < len; i++) {
+        char c = p[i];
+        if (c == '.' && frac_digits < 0) {
+            frac_digits = 0;
+        } else if (c >= '0' && c <= '9') {
+            if (frac_digits >= decimals) continue; // 필요 이상 자리는 버림
+            if (frac_digits >= 0) frac_digits++;
+            value = value * 10 + (c - '0');
+        } else {
+            return false;
+        }
+    }
+    for (int d = frac_digits < 0 ? 0 : frac_digits; d < decimals; d++) value *= 10;
+    *out = negative ? -value : value;
+    return true;
+}
+
+const char *gnss_system_name(gnss_system_t sys) {
+    switch (sys) {
+        case GNSS_GPS:     return "GPS";
+        case GNSS_GLONASS: return "GLONASS";
+        case GNSS_GALILEO: return "Galileo";
+        case GNSS_BEIDOU:  return "BeiDou";
+        case GNSS_QZSS:    return "QZSS";
+        default:           return "GNSS";
+    }
+}
+
+// 필드 값 읽기: atoi 는 ',' 나 '*' 에서 변환을 멈추므로 복사 없이 원본에서 바로 읽음
+static int field_int(const nmea_fields_t *f, int i) {
+    return nmea_field_len(f, i) > 0 ? atoi(nmea_field_ptr(f, i)) : 0;
+}
+
+static bool field_fixed(const nmea_fields_t *f, int i, int decimals, int32_t *out) {
+    return nmea_parse_fixed(nmea_field_ptr(f, i), nmea_field_len(f, i), decimals, out);
+}
+
+static char field_char(const nmea_fields_t *f, int i) {
+    return nmea_field_len(f, i) > 0 ? *nmea_field_ptr(f, i) : '\0';
+}
+
+// 좌표 필드 + 방향 필드(N/S, E/W) -> 부호 있는 1e-7 도 (위도는 max_deg 90, 경도는 180 을 넘으면 버림)
+static bool field_coord(const nmea_fields_t *f, int i, int max_deg, int32_t *out_e7) {
+    int32_t v;
+    if (!nmea_parse_coord(nmea_field_ptr(f, i), nmea_field_len(f, i), &v)) return false;
+    if (v > max_deg * GPS_COORD_SCALE) return false;
+    char hemi = field_char(f, i + 1);
+    if (hemi == 'S' || hemi == 'W') v = -v;
+    *out_e7 = v;
+    return true;
+}
+
+static void field_time(nmea_parser_t *p, const nmea_fields_t *f, int i) {
+    nmea_parse_time(nmea_field_ptr(f, i), nmea_field_len(f, i), &p->gps->utc_ms);
+}
+
+// 노트(0.001 kn 단위) -> mm/s  (1 kn = 1852 m/h)
+static uint32_t knots_e3_to_mmps(int32_t knots_e3) {
+    return (uint32_t)((uint64_t)knots_e3 * 1852 / 3600);
+}
+
+static void field_dop(const nmea_fields_t *f, int i, uint16_t *out) {
+    int32_t v;
+    if (field_fixed(f, i, 2, &v) && v >= 0) *out = (uint16_t)v;
+}
+
+// --- [RMC: 시간, 위도, 경도, 속도, 방향, 날짜] ---
+// $xxRMC,hhmmss.ss,A,ddmm.mm,N,dddmm.mm,E,속도(kn),방향,ddmmyy,...
+static uint32_t parse_rmc(nmea_parser_t *p, const nmea_fields_t *f, gnss_system_t sys) {
+    GPS_Data *gps = p->gps;
+    int32_t v;
+
+    field_time(p, f, 1);
+    gps->valid = field_char(f, 2) == 'A';
+    field_coord(f, 3, 90, &gps->latitude);
+    field_coord(f, 5, 180, &gps->longitude);
+    if (field_fixed(f, 7, 3, &v) && v >= 0) gps->speed_mmps = knots_e3_to_mmps(v);
+    if (field_fixed(f, 8, 2, &v) && v >= 0) gps->course_cdeg = (uint16_t)v;
+
+    if (field_fixed(f, 9, 0, &v) && nmea_field_len(f, 9) == 6) {
+        gps->day = v / 10000;
+        gps->month = v / 100 % 100;
+        gps->year = 2000 + v % 100;
+    }
+    return GPS_UPDATED_FIX;
+}
+
+// --- [GGA: 고정 품질, 위성 개수, 고도] ---
+static uint32_t parse_gga(nmea_parser_t *p, const nmea_fields_t *f, gnss_system_t sys) {
+    GPS_Data *gps = p->gps;
+    int32_t v;
+
+    // Fix Quality (Index 6): 0=Invalid, 1=GPS fix, 2=DGPS fix
+    gps->fix_quality = field_int(f, 6);
+
+    // 위성 개수 (Index 7) - 이게 중요!
+    gps->sat_count = field_int(f, 7);
+
+    field_dop(f, 8, &gps->hdop_x100);
+    if (field_fixed(f, 9, 2, &v)) gps->altitude_cm = v;
+    return GPS_UPDATED_FIX;
+}
+
+// --- [GSA: 2D/3D 여부, DOP] ---
+static uint32_t parse_gsa(nmea_parser_t *p, const nmea_fields_t *f, gnss_system_t sys) {
+    GPS_Data *gps = p->gps;
+    gps->fix_type = field_int(f, 2);
+    field_dop(f, 15, &gps->pdop_x100);
+    field_dop(f, 16, &gps->hdop_x100);
+    field_dop(f, 17, &gps->vdop_x100);
+    return GPS_UPDATED_INFO;
+}
+
+// --- [VTG: 방향, 속도] ---
+// $xxVTG,방향(T),T,방향(M),M,속도(kn),N,속도(km/h),K,...
+static uint32_t parse_vtg(nmea_parser_t *p, const nmea_fields_t *f, gnss_system_t sys) {
+    GPS_Data *gps = p->gps;
+    int32_t v;
+    if (field_fixed(f, 1, 2, &v) && v >= 0) gps->course_cdeg = (uint16_t)v;
+    if (field_fixed(f, 5, 3, &v) && v >= 0) gps->speed_mmps = knots_e3_to_mmps(v);
+    return GPS_UPDATED_INFO;
+}
+
+// --- [GLL: 위도, 경도, 시간] ---
+static uint32_t parse_gll(nmea_parser_t *p, const nmea_fields_t *f, gnss_system_t sys) {
+    GPS_Data *gps = p->gps;
+    field_coord(f, 1, 90, &gps->latitude);
+    field_coord(f, 3, 180, &gps->longitude);
+    field_time(p, f, 5);
+    gps->valid = field_char(f, 6) == 'A';
+    return GPS_UPDATED_FIX;
+}
+
+// --- [GSV: 위성 목록, 시스템별] ---
+// GSV 는 위성 4개씩 여러 줄(1/N ~ N/N)로 나눠서 옴.
+// 줄이 올 때마다 위성 목록(p->sats)의 해당 칸(시스템+PRN)을 제자리에서 갱신하고,
+// 마지막 줄이 왔을 때 이번 묶음에 안 나온 위성을 지우고 요약(gps->sky)까지 한 번에 확정함.
+// 확정 전의 중간 상태는 발행되지 않으므로 읽는 쪽은 항상 완성된 목록만 봄
+
+// 시스템+PRN 칸 찾기. 없으면 새 칸 (표가 꽉 찼으면 NULL)
+static gps_sat_t *sat_slot(gps_sat_table_t *sats, gnss_system_t sys, int prn) {
+    for (int i = 0; i < sats->count; i++) {
+        gps_sat_t *s = &sats->sats[i];
+        if (s->system == sys && s->prn == prn) return s;
+    }
+    if (sats->count >= GPS_MAX_SATS) return NULL;
+
+    gps_sat_t *s = &sats->sats[sats->count++];
+    s->system = sys;
+    s->prn = prn;
+    return s;
+}
+
+// 묶음 완료: 이번에 안 보인 위성 제거 + 시스템 요약 다시 계산
+static void gsv_commit(nmea_parser_t *p, gnss_system_t sys) {
+    GPS_Data *gps = p->gps;
+    gps_sat_table_t *sats = p->sats;
+    gnss_sky_t sky = { .in_view = p->gsv_in_view[sys], .max_snr = 0 };
+    int n = 0;
+
+    sats->epoch++;
+    for (int i = 0; i < sats->count; i++) {
+        gps_sat_t s = sats->sats[i];
+        if (s.system == sys) {
+            if (s.last_seen != sats->epoch) continue; // 이번 묶음에 없었음 -> 시야에서 사라짐
+            if (s.snr > sky.max_snr) sky.max_snr = s.snr;
+        }
+        sats->sats[n++] = s;
+    }
+    sats->count = n;
+
+    gps->sky[sys] = sky;
+    gps->max_snr = 0;
+    for (int i = 0; i < GNSS_COUNT; i++) {
+        if (gps->sky[i].max_snr > gps->max_snr) gps->max_snr = gps->sky[i].max_snr;
+    }
+}
+
+static uint32_t parse_gsv(nmea_parser_t *p, const nmea_fields_t *f, gnss_system_t sys) {
+    if (sys >= GNSS_COUNT) return 0; // $GNGSV 는 시스템을 알 수 없으므로 무시
+    int total = field_int(f, 1);
+    int part = field_int(f, 2);
+    int sats_end = f->count;
+
+    // NMEA 4.11 은 맨 끝에 신호 ID 가 붙음 (L1/L5 처럼 같은 위성이 묶음 2개로 옴).
+    // 처음 본 신호의 묶음만 사용해서 서로 덮어쓰지 않게 함
+    if ((f->count - 4) % 4 == 1) {
+        int signal = field_int(f, --sats_end);
+        if (p->gsv_signal[sys] == 0) p->gsv_signal[sys] = signal;
+        if (signal != p->gsv_signal[sys]) return 0;
+    }
+
+    if (part == 1) {
+        p->gsv_in_view[sys] = field_int(f, 3);
+        p->gsv_next_part[sys] = 1;
+    }
+    // 중간 줄이 빠졌으면 이번 묶음은 확정하지 않음 (다음 1번 줄부터 다시)
+    if (part < 1 || part != p->gsv_next_part[sys]) {
+        p->gsv_next_part[sys] = 0;
+        return 0;
+    }
+    p->gsv_next_part[sys]++;
+
+    // 위성 1개 = PRN, 고도각, 방위각, SNR (4번 필드부터 4개씩)
+    uint32_t epoch = p->sats->epoch + 1; // 이번 묶음이 확정될 때의 주기 번호
+    for (int i = 4; i + 3 < sats_end; i += 4) {
+        int prn = field_int(f, i);
+        if (prn <= 0 || prn > 255) continue;
+
+        gps_sat_t *s = sat_slot(p->sats, sys, prn);
+        if (s == NULL) continue;
+        s->elevation = field_int(f, i + 1);
+        s->azimuth = field_int(f, i + 2);
+        s->snr = field_int(f, i + 3);
+        s->last_seen = epoch;
+    }
+
+    if (part != total) return 0;
+
+    p->gsv_next_part[sys] = 0;
+    gsv_commit(p, sys);
+    return GPS_UPDATED_SKY;
+}
+
+// --- [ZDA: UTC 시각 + 날짜] ---
+// RMC 와 달리 위치 없이 시간만 옴 (시간 서비스용)
+static uint32_t parse_zda(nmea_parser_t *p, const nmea_fields_t *f, gnss_system_t sys) {
+    GPS_Data *gps = p->gps;
+    if (nmea_field_len(f, 1) == 0 || nmea_field_len(f, 4) == 0) return 0;
+    field_time(p, f, 1);
+    gps->day = field_int(f, 2);
+    gps->month = field_int(f, 3);
+    gps->year = field_int(f, 4);
+    return GPS_UPDATED_TIME;
+}
+
+// --- [날짜 -> 일수] ---
+// 윤년 계산을 식 하나로 처리 (반복문/테이블 없음)
+int32_t gps_days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// --- [문장 처리 테이블] ---
+// 3글자 문장 종류로 슬롯 번호를 바로 계산해서 찾음 (문장 수가 늘어도 비교는 1번)
+// 새 문장을 추가할 때는 아래 테이블에 한 줄만 추가하면 됨.
+// 슬롯이 다른 문장과 겹치면 -Woverride-init 경고가 나므로 NMEA_SLOT 의 곱셈 값을 바꿀 것.
+typedef uint32_t (*nmea_handler_t)(nmea_parser_t *p, const nmea_fields_t *f, gnss_system_t sys);
+
+#define NMEA_SLOT_COUNT 32
+#define NMEA_SLOT(a, b, c) (((a) + (b) * 3 + (c)) & (NMEA_SLOT_COUNT - 1))
+
+static const struct {
+    uint32_t type;
+    nmea_handler_t handler;
+} sentence_table[NMEA_SLOT_COUNT] = {
+    [NMEA_SLOT('R', 'M', 'C')] = { NMEA_TYPE('R', 'M', 'C'), parse_rmc },
+    [NMEA_SLOT('G', 'G', 'A')] = { NMEA_TYPE('G', 'G', 'A'), parse_gga },
+    [NMEA_SLOT('G', 'S', 'V')] = { NMEA_TYPE('G', 'S', 'V'), parse_gsv },
+    [NMEA_SLOT('G', 'S', 'A')] = { NMEA_TYPE('G', 'S', 'A'), parse_gsa },
+    [NMEA_SLOT('V', 'T', 'G')] = { NMEA_TYPE('V', 'T', 'G'), parse_vtg },
+    [NMEA_SLOT('G', 'L', 'L')] = { NMEA_TYPE('G', 'L', 'L'), parse_gll },
+    [NMEA_SLOT('Z', 'D', 'A')] = { NMEA_TYPE('Z', 'D', 'A'), parse_zda },
+};
+
+// 토커 ID(2글자) -> 위성 시스템. 모르는 토커면 -1
+static int talker_to_system(char a, char b) {
+    switch ((a << 8) | b) {
+        case ('G' << 8) | 'P': return GNSS_GPS;
+        case ('G' << 8) | 'L': return GNSS_GLONASS;
+        case ('G' << 8) | 'A': return GNSS_GALILEO;
+        case ('G' << 8) | 'B':
+        case ('B' << 8) | 'D': return GNSS_BEIDOU;
+        case ('G' << 8) | 'Q':
+        case ('Q' << 8) | 'Z': return GNSS_QZSS;
+        case ('G' << 8) | 'N': return GNSS_MULTI;
+        default:               return -1;
+    }
+}
+
+// --- [파싱 함수] ---
+uint32_t nmea_parse(nmea_parser_t *p, char *nmea_sentence) {
+    nmea_fields_t f;
+
+    if (nmea_sentence[0] != '$') return 0;
+    nmea_split_fields(nmea_sentence, &f);
+
+    // 문장 ID 는 항상 "$" + 토커 2글자 + 종류 3글자 (예: $GPRMC, $GNGGA)
+    if (nmea_field_len(&f, 0) != 6) return 0;
+    const char *id = nmea_sentence + 1;
+
+    int sys = talker_to_system(id[0], id[1]);
+    if (sys < 0) return 0; // $PMTK, $PUBX 같은 제조사 전용 문장 등
+
+    uint32_t type = NMEA_TYPE(id[2], id[3], id[4]);
+    unsigned slot = NMEA_SLOT(id[2], id[3], id[4]);
+    if (sentence_table[slot].type != type) return 0; // 사용하지 않는 문장
+    return sentence_table[slot].handler(p, &f, (gnss_system_t)sys);
+}
+
+uint32_t parse_nmea(char *nmea_sentence) {
+    return nmea_parse(&default_parser, nmea_sentence);
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- [NMEA 파서] ---
+// ESP-IDF 의존성이 없는 순수 C 코드라서 PC(리눅스)에서도 그대로 컴파일됩니다.
+// (GPS/tools 의 벤치마크가 이 파일을 직접 빌드합니다)
+
+// --- [데이터 저장용 구조체] ---
+// 좌표와 시간은 정수(고정소수점)로 저장: double/float 연산 없이 파싱하고 정밀도 손실도 없음
+#define GPS_COORD_SCALE 10000000 // 좌표 단위: 1e-7 도 (37.5665350도 -> 375665350)
+
+// 위성 시스템 (NMEA 토커 ID 로 구분)
+typedef enum {
+    GNSS_GPS = 0,   // $GP
+    GNSS_GLONASS,   // $GL
+    GNSS_GALILEO,   // $GA
+    GNSS_BEIDOU,    // $GB, $BD
+    GNSS_QZSS,      // $GQ
+    GNSS_COUNT,
+    GNSS_MULTI = GNSS_COUNT, // $GN: 여러 시스템을 합친 결과 (RMC/GGA 등)
+} gnss_system_t;
+
+// 시스템별 GSV 요약
+typedef struct {
+    int in_view;        // 보이는 위성 수
+    int max_snr;        // 가장 강한 신호 세기 (dB)
+} gnss_sky_t;
+
+// --- [위성 목록 (GSV)] ---
+// 시스템 + PRN(위성 번호) 하나가 한 칸. 크기가 고정이라 할당/재파싱 없이 제자리 갱신
+#define GPS_MAX_SATS 64 // 모든 시스템을 합친 최대 위성 수 (넘치면 새 위성은 버림)
+
+typedef struct {
+    uint32_t last_seen; // 마지막으로 보인 GSV 주기 (gps_sat_table_t.epoch 값)
+    uint16_t azimuth;   // 방위각 (도, 0~359)
+    uint8_t elevation;  // 고도각 (도, 0~90)
+    uint8_t snr;        // 신호 세기 (dB, 0 = 보이기만 하고 추적 안 됨)
+    uint8_t system;     // gnss_system_t
+    uint8_t prn;        // 위성 번호
+} gps_sat_t;
+
+typedef struct {
+    uint32_t epoch;     // GSV 묶음이 하나 완료될 때마다 1씩 증가
+    int count;          // sats[] 에서 사용 중인 칸 수
+    gps_sat_t sats[GPS_MAX_SATS];
+} gps_sat_table_t;
+
+typedef struct {
+    int32_t latitude;   // 위도 (1e-7 도, 북위 +, 남위 -)
+    int32_t longitude;  // 경도 (1e-7 도, 동경 +, 서경 -)
+    uint32_t utc_ms;    // UTC 시각 (자정부터 ms)
+    uint8_t day, month; // UTC 날짜 (RMC)
+    uint16_t year;
+    int32_t altitude_cm;    // 해발 고도 (cm, GGA)
+    uint32_t speed_mmps;    // 지면 속도 (mm/s, RMC/VTG)
+    uint16_t course_cdeg;   // 진행 방향 (0.01 도, 진북 기준)
+    uint16_t hdop_x100;     // 정밀도 저하율 x100 (작을수록 좋음)
+    uint16_t pdop_x100;
+    uint16_t vdop_x100;
+    uint32_t h_acc_mm;      // 수평 위치 오차 추정 (mm, UBX NAV-PVT 에서만)
+    uint32_t v_acc_mm;      // 수직 위치 오차 추정 (mm, UBX NAV-PVT 에서만)
+    bool valid;         // RMC/GLL 상태 'A' (유효한 위치)
+    int fix_type;       // GSA: 1=없음, 2=2D, 3=3D
+    int sat_count;      // 연결된 위성 개수 (중요!)
+    int max_snr;        // 가장 강한 신호 세기 (감도, 모든 시스템 중)
+    int fix_quality;    // 0=없음, 1=GPS, 2=DGPS
+    gnss_sky_t sky[GNSS_COUNT]; // 시스템별 위성 상태 (GSV)
+} GPS_Data;
+
+// 파서가 직접 채우는 작업용 데이터 (파서 태스크 전용).
+// 다른 태스크는 gps_snapshot_read() 로 복사본을 받아서 읽을 것.
+extern GPS_Data my_gps;
+// 위성 목록도 같은 규칙 (GPS_UPDATED_SKY 일 때만 완성된 상태, gps_snapshot_read_sats() 로 읽을 것)
+extern gps_sat_table_t my_sats;
+
+// --- [파서 상태] ---
+// 수신기 하나당 하나. 결과를 쓸 곳과 여러 줄에 걸친 문장(GSV)의 진행 상태를 가짐.
+// 전역 상태가 없으므로 수신기 여러 대를 한 태스크에서 번갈아 파싱해도 서로 섞이지 않음
+typedef struct {
+    GPS_Data *gps;                      // 결과 (위치/시간/요약)
+    gps_sat_table_t *sats;              // 결과 (위성 목록)
+    int gsv_in_view[GNSS_COUNT];        // GSV 1번 줄의 "보이는 위성 수"
+    int gsv_next_part[GNSS_COUNT];      // 다음에 와야 할 줄 번호 (0 = 묶음 진행 중 아님)
+    int gsv_signal[GNSS_COUNT];         // NMEA 4.11 신호 ID (처음 본 신호만 사용, 0 = 아직 모름)
+} nmea_parser_t;
+
+// parse_nmea() 가 돌려주는 "무엇이 바뀌었나" 비트
+#define GPS_UPDATED_FIX   (1u << 0) // 위치/시간 (RMC, GGA, GLL, UBX NAV-PVT)
+#define GPS_UPDATED_SKY   (1u << 1) // 위성 목록/신호 (GSV 묶음 완료)
+#define GPS_UPDATED_INFO  (1u << 2) // 속도/방향/DOP (VTG, GSA)
+#define GPS_UPDATED_TIME  (1u << 3) // 시각/날짜만 (ZDA)
+
+// --- [필드 분리 결과] ---
+// 문장을 한 번만 훑어서 각 필드의 시작 위치(오프셋)만 기록합니다.
+// 필드 내용은 복사하지 않고 원본 문장 안을 그대로 가리킵니다.
+#define NMEA_MAX_FIELDS 32
+
+typedef struct {
+    const char *base;                   // 원본 문장 ('$' 부터)
+    int count;                          // 필드 개수 (0번 = "$GPRMC" 같은 문장 ID)
+    uint16_t off[NMEA_MAX_FIELDS + 1];  // off[i] = i번째 필드 시작, off[count] = 마지막 필드 끝 + 1
+} nmea_fields_t;
+
+// 3글자 문장 종류("RMC" 등)를 정수 하나로 묶음 -> 문자열 비교 없이 정수 비교
+#define NMEA_TYPE(a, b, c) (((uint32_t)(a) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(c))
+
+int nmea_split_fields(const char *sentence, nmea_fields_t *f);
+
+static inline const char *nmea_field_ptr(const nmea_fields_t *f, int i) {
+    return f->base + f->off[i];
+}
+
+// 빈 필드(",,")이거나 없는 필드면 0
+static inline int nmea_field_len(const nmea_fields_t *f, int i) {
+    if (i >= f->count) return 0;
+    return f->off[i + 1] - f->off[i] - 1;
+}
+
+// "ddmm.mmmm" / "dddmm.mmmm" -> 1e-7 도 (반올림). 형식이 틀렸거나 180 도 / 60 분을 넘으면 false
+bool nmea_parse_coord(const char *p, int len, int32_t *out_e7);
+// "hhmmss.sss" -> 자정부터 ms. 형식이 틀리면 false
+bool nmea_parse_time(const char *p, int len, uint32_t *out_ms);
+// "123.45" -> 소수 decimals 자리까지 정수로 (decimals=2 이면 12345). 음수 허용
+bool nmea_parse_fixed(const char *p, int len, int decimals, int32_t *out);
+
+const char *gnss_system_name(gnss_system_t sys);
+// UTC 날짜 -> 1970-01-01 부터의 일수 (예: 2000-01-01 -> 10957)
+int32_t gps_days_from_civil(int year, int month, int day);
+// 결과를 gps / sats 에 쓰는 파서 준비
+void nmea_parser_init(nmea_parser_t *p, GPS_Data *gps, gps_sat_table_t *sats);
+// 한 문장을 p 의 결과에 반영하고 GPS_UPDATED_* 비트를 돌려줌 (사용 안 하는 문장이면 0)
+uint32_t nmea_parse(nmea_parser_t *p, char *nmea_sentence);
+// 수신기가 하나일 때: 기본 파서로 my_gps / my_sats 에 반영
+uint32_t parse_nmea(char *nmea_sentence);
@@ -0,0 +1,48 @@
+#include <string.h>
+#include "nmea_ring.h"
+
+bool nmea_ring_init(nmea_ring_t *r, uint8_t *buf, uint32_t size) {
+    memset(r, 0, sizeof(*r));
+    if (size < 64 || (size & (size - 1)) != 0) return false;
+    r->buf = buf;
+    r->size = size;
+    return true;
+}
+
+// 링 끝에서 잘리면 두 번에 나눠 씀
+static void copy_in(nmea_ring_t *r, uint32_t pos, const void *src, size_t n) {
+    uint32_t off = pos & (r->size - 1);
+    size_t first = r->size - off < n ? r->size - off : n;
+    memcpy(r->buf + off, src, first);
+    memcpy(r->buf, (const uint8_t *)src + first, n - first);
+}
+
+void nmea_ring_put_line(nmea_ring_t *r, const char *line, size_t len) {
+    if (len + 2 > r->size / 4) {
+        r->too_long++;
+        return;
+    }
+    uint32_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    copy_in(r, head, line, len);
+    copy_in(r, head + (uint32_t)len, "\r\n", 2);
+
+    // 줄을 다 쓴 다음에 head 가 보이도록 (읽는 쪽은 항상 완성된 줄까지만 봄)
+    atomic_store_explicit(&r->head, head + (uint32_t)len + 2, memory_order_release);
+    r->lines++;
+}
+
+const uint8_t *nmea_ring_peek(const nmea_ring_t *r, uint32_t cursor, size_t *len) {
+    uint32_t avail = nmea_ring_head(r) - cursor;
+    if (avail == 0 || avail > nmea_ring_lag_limit(r)) return NULL;
+
+    uint32_t off = cursor & (r->size - 1);
+    *len = r->size - off < avail ? r->size - off : avail;
+    return r->buf + off;
+}
+
+bool nmea_ring_valid(const nmea_ring_t *r, uint32_t cursor) {
+    // 쓰는 중인 줄(최대 size/4, head 는 아직 그대로)까지 생각해서 peek 와 같은 기준으로 확인:
+    // head - cursor 가 size 의 3/4 이하면 지금 쓰는 줄도 cursor 앞쪽만 덮음
+    atomic_thread_fence(memory_order_acquire);
+    return nmea_ring_head(r) - cursor <= nmea_ring_lag_limit(r);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// --- [NMEA 공유 링 버퍼 (쓰는 쪽 1개, 읽는 쪽 여러 개)] ---
+// 수신한 줄을 한 번만 링에 써 두고, 읽는 쪽(TCP 클라이언트)은 각자 커서(누적 위치)만 가짐.
+// 클라이언트마다 복사본을 만들지 않고 링 안의 바이트를 그대로 send() 로 넘김.
+//  - 쓰는 쪽은 절대 기다리지 않음: 읽는 쪽이 늦으면 그 쪽 데이터가 덮어써질 뿐
+//  - head = 지금까지 쓴 총 바이트 수 (32비트에서 돌아도 뺄셈으로 비교하므로 괜찮음)
+//  - 읽는 쪽은 쓰기 전에 nmea_ring_peek(), 다 쓴 뒤 nmea_ring_valid() 로 그 사이에 덮이지 않았는지 확인
+//    (gps_snapshot 과 같은 "읽고 나서 확인" 방식, 잠금 없음)
+// ESP-IDF 의존성 없음 (PC 의 tools/nmea_fanout 에서 같은 코드로 시험)
+
+typedef struct {
+    uint8_t *buf;
+    uint32_t size;          // 2의 거듭제곱
+    atomic_uint head;       // 쓴 총 바이트 수 (줄 경계에서만 증가)
+    uint32_t lines;         // 쓴 줄 수
+    uint32_t too_long;      // 링의 1/4 보다 길어서 버린 줄 수
+} nmea_ring_t;
+
+// size 는 2의 거듭제곱이어야 함 (아니면 false)
+bool nmea_ring_init(nmea_ring_t *r, uint8_t *buf, uint32_t size);
+
+// 쓰는 쪽 (한 태스크만): 줄 뒤에 "\r\n" 을 붙여서 넣음
+void nmea_ring_put_line(nmea_ring_t *r, const char *line, size_t len);
+
+static inline uint32_t nmea_ring_head(const nmea_ring_t *r) {
+    return atomic_load_explicit(&r->head, memory_order_acquire);
+}
+
+// 커서가 이만큼 넘게 뒤처지면 곧 덮어써지므로 읽지 말고 건너뛸 것 (링의 3/4)
+static inline uint32_t nmea_ring_lag_limit(const nmea_ring_t *r) {
+    return r->size - r->size / 4;
+}
+
+// cursor 부터 한 번에 보낼 수 있는 연속 구간 (링 끝에서 잘림). 보낼 게 없거나 너무 뒤처졌으면 NULL
+const uint8_t *nmea_ring_peek(const nmea_ring_t *r, uint32_t cursor, size_t *len);
+
+// cursor 위치의 데이터가 아직 덮어써지지 않았는지 (peek 한 구간을 다 쓴 뒤 확인)
+bool nmea_ring_valid(const nmea_ring_t *r, uint32_t cursor);
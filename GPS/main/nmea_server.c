@@ -0,0 +1,180 @@
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "nmea_server.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // 없는 플랫폼 (끊긴 소켓에 써도 SIGPIPE 가 없는 lwIP 등)
+#endif
+
+static void set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+bool nmea_server_open(nmea_server_t *s, const nmea_ring_t *ring, uint16_t port) {
+    memset(s, 0, sizeof(*s));
+    s->ring = ring;
+    for (int i = 0; i < NMEA_SERVER_MAX_CLIENTS; i++) s->clients[i].fd = -1;
+
+    s->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (s->listen_fd < 0) return false;
+
+    int one = 1;
+    setsockopt(s->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(s->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(s->listen_fd, 2) != 0) {
+        int e = errno;
+        close(s->listen_fd);
+        s->listen_fd = -1;
+        errno = e;
+        return false;
+    }
+    set_nonblocking(s->listen_fd);
+    return true;
+}
+
+static void close_client(nmea_client_t *c) {
+    close(c->fd);
+    c->fd = -1;
+}
+
+static void accept_clients(nmea_server_t *s) {
+    int fd;
+    while ((fd = accept(s->listen_fd, NULL, NULL)) >= 0) {
+        nmea_client_t *slot = NULL;
+        for (int i = 0; i < NMEA_SERVER_MAX_CLIENTS && slot == NULL; i++) {
+            if (s->clients[i].fd < 0) slot = &s->clients[i];
+        }
+        if (slot == NULL) {
+            close(fd);
+            s->stats.rejected++;
+            continue;
+        }
+        set_nonblocking(fd);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // 문장마다 바로 나가도록
+        // 접속한 시점부터의 문장만 보냄 (지난 것은 보내지 않음)
+        slot->fd = fd;
+        slot->cursor = nmea_ring_head(s->ring);
+        slot->skips = 0;
+        s->stats.accepted++;
+    }
+}
+
+// 클라이언트가 보낸 것은 버리고, 연결이 끊겼는지만 확인. 끊겼으면 false
+static bool drain_input(nmea_client_t *c) {
+    char junk[64];
+    for (;;) {
+        ssize_t n = recv(c->fd, junk, sizeof(junk), MSG_DONTWAIT);
+        if (n > 0) continue;
+        if (n == 0) return false;
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+}
+
+// 뒤처진 클라이언트를 최신 위치로 옮김. 연속으로 너무 많이 건너뛰었으면 false (끊을 것)
+static bool skip_ahead(nmea_server_t *s, nmea_client_t *c) {
+    s->stats.skips++;
+    if (++c->skips >= NMEA_SERVER_MAX_SKIPS) {
+        s->stats.dropped++;
+        return false;
+    }
+    c->cursor = nmea_ring_head(s->ring);
+    return true;
+}
+
+// 밀린 데이터를 소켓이 받아 주는 만큼 보냄. 연결을 닫아야 하면 false
+static bool flush_client(nmea_server_t *s, nmea_client_t *c) {
+    const nmea_ring_t *r = s->ring;
+    bool sent = false;
+    for (;;) {
+        if (nmea_ring_head(r) == c->cursor) {
+            if (sent) c->skips = 0; // 건너뛰지 않고 보내서 따라잡음
+            return true;
+        }
+        size_t len;
+        const uint8_t *p = nmea_ring_peek(r, c->cursor, &len);
+        if (p == NULL) {
+            // 이미 덮어써지는 중: 최신 위치로 건너뜀
+            if (!skip_ahead(s, c)) return false;
+            sent = false;
+            continue;
+        }
+
+        ssize_t n = send(c->fd, p, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return true; // 소켓 버퍼가 참
+            return false;
+        }
+        // 보내는 동안 덮어써졌으면 방금 보낸 조각이 깨졌을 수 있음 (체크섬으로 걸러짐)
+        if (!nmea_ring_valid(r, c->cursor)) {
+            if (!skip_ahead(s, c)) return false;
+            sent = false;
+            continue;
+        }
+        c->cursor += (uint32_t)n;
+        s->stats.bytes_sent += (uint64_t)n;
+        sent = true;
+        if ((size_t)n < len) return true;
+    }
+}
+
+void nmea_server_poll(nmea_server_t *s, int timeout_ms) {
+    if (s->listen_fd < 0) return;
+
+    // 보낼 게 남은 클라이언트는 쓰기 가능해질 때, 나머지는 들어온 데이터/끊김이 있을 때 깨어남
+    fd_set rfds, wfds;
+    FD_ZERO(&rfds);
+    FD_ZERO(&wfds);
+    FD_SET(s->listen_fd, &rfds);
+    int max_fd = s->listen_fd;
+    uint32_t head = nmea_ring_head(s->ring);
+    for (int i = 0; i < NMEA_SERVER_MAX_CLIENTS; i++) {
+        const nmea_client_t *c = &s->clients[i];
+        if (c->fd < 0) continue;
+        FD_SET(c->fd, &rfds);
+        if (c->cursor != head) FD_SET(c->fd, &wfds);
+        if (c->fd > max_fd) max_fd = c->fd;
+    }
+    struct timeval tv = { .tv_sec = timeout_ms / 1000, .tv_usec = (timeout_ms % 1000) * 1000 };
+    if (select(max_fd + 1, &rfds, &wfds, NULL, &tv) < 0) return;
+
+    if (FD_ISSET(s->listen_fd, &rfds)) accept_clients(s);
+
+    // select 결과와 관계없이 모두 시도 (기다리는 동안 링에 새 줄이 들어왔을 수 있음)
+    for (int i = 0; i < NMEA_SERVER_MAX_CLIENTS; i++) {
+        nmea_client_t *c = &s->clients[i];
+        if (c->fd < 0) continue;
+        bool ok = !FD_ISSET(c->fd, &rfds) || drain_input(c);
+        if (!ok) s->stats.closed++;
+        else if (!flush_client(s, c)) {
+            if (c->skips < NMEA_SERVER_MAX_SKIPS) s->stats.closed++; // 전송 오류 (느려서 끊은 건 이미 셈)
+            ok = false;
+        }
+        if (!ok) close_client(c);
+    }
+}
+
+int nmea_server_clients(const nmea_server_t *s) {
+    int n = 0;
+    for (int i = 0; i < NMEA_SERVER_MAX_CLIENTS; i++) n += s->clients[i].fd >= 0;
+    return n;
+}
+
+void nmea_server_close(nmea_server_t *s) {
+    for (int i = 0; i < NMEA_SERVER_MAX_CLIENTS; i++) {
+        if (s->clients[i].fd >= 0) close_client(&s->clients[i]);
+    }
+    if (s->listen_fd >= 0) close(s->listen_fd);
+    s->listen_fd = -1;
+}
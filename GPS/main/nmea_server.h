@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nmea_ring.h"
+
+// --- [NMEA TCP 서버 (여러 클라이언트에 같은 문장 뿌리기)] ---
+// nmea_ring 에 쌓인 원본 문장을 접속한 클라이언트 모두에게 그대로 보냅니다 (표준 포트 10110).
+// 클라이언트마다 링 안의 읽기 위치(cursor)만 가지고, 링의 바이트를 바로 send() 함 (복사 없음).
+//  - 소켓은 모두 논블로킹: 한 클라이언트가 느려도 다른 클라이언트나 UART 수신은 기다리지 않음
+//  - 느린 클라이언트는 링의 3/4 이상 뒤처지면 최신 위치로 건너뜀 (중간 문장은 빠짐).
+//    건너뛰는 순간 보내던 문장이 잘리지만 NMEA 체크섬이 있으므로 받는 쪽에서 버려짐
+//  - 따라잡지 못하고 NMEA_SERVER_MAX_SKIPS 번 연속으로 건너뛰면 연결을 끊음
+//  - 클라이언트가 보내는 데이터는 읽어서 버림 (연결 끊김 확인용)
+// BSD 소켓만 쓰므로 ESP-IDF(lwIP) 와 PC 에서 같은 코드가 동작 (tools/nmea_fanout 으로 시험)
+
+#define NMEA_SERVER_PORT         10110
+#define NMEA_SERVER_MAX_CLIENTS  4
+#define NMEA_SERVER_MAX_SKIPS    3
+
+typedef struct {
+    int fd;                 // -1 = 빈 자리
+    uint32_t cursor;        // 링에서 다음에 보낼 위치
+    uint32_t skips;         // 따라잡지 못하고 연속으로 건너뛴 횟수
+} nmea_client_t;
+
+typedef struct {
+    uint32_t accepted;      // 받아들인 연결
+    uint32_t rejected;      // 자리가 없어서 바로 끊은 연결
+    uint32_t closed;        // 클라이언트가 끊거나 오류로 닫힌 연결
+    uint32_t dropped;       // 너무 느려서 서버가 끊은 연결
+    uint32_t skips;         // 뒤처져서 건너뛴 횟수 (전체)
+    uint64_t bytes_sent;
+} nmea_server_stats_t;
+
+typedef struct {
+    const nmea_ring_t *ring;
+    int listen_fd;
+    nmea_client_t clients[NMEA_SERVER_MAX_CLIENTS];
+    nmea_server_stats_t stats;
+} nmea_server_t;
+
+// port 에서 접속 대기 시작. 실패하면 false (errno 유지)
+bool nmea_server_open(nmea_server_t *s, const nmea_ring_t *ring, uint16_t port);
+
+// 새 연결 받기 + 밀린 데이터 보내기. 할 일이 없으면 최대 timeout_ms 동안 기다림.
+// 링에 새 줄이 들어와도 깨워 주지 않으므로, timeout_ms 가 곧 전달 지연의 최대값
+void nmea_server_poll(nmea_server_t *s, int timeout_ms);
+
+// 접속 중인 클라이언트 수
+int nmea_server_clients(const nmea_server_t *s);
+
+void nmea_server_close(nmea_server_t *s);
@@ -0,0 +1,235 @@
+#include <string.h>
+#include "track_codec.h"
+
+// --- [레코드 flags] ---
+#define F_DT    0x01 // 시간 간격이 바뀜: varint dt_ms
+#define F_ALT   0x02 // 고도가 바뀜: zigzag 고도 차이
+#define F_QUAL  0x04 // 품질이 바뀜: quality(1), sats(1), varint hdop_x10
+#define F_KEY   0x80 // 키프레임: varint time_ms, zigzag 위도/경도/고도, quality, sats, varint hdop_x10
+#define F_VALID (F_DT | F_ALT | F_QUAL | F_KEY)
+
+#define TRACK_MAX_RECORD 48 // 키프레임 최대 크기보다 넉넉하게
+
+#define MS_PER_DAY 86400000ull
+#define MAX_GAP_MS 3600000u // 이보다 오래 끊기면 키프레임 (dt 가 32비트를 넘지 않도록)
+
+// --- [일수 -> 날짜] ---
+// gps_days_from_civil() 의 반대 (1970-01-01 부터의 일수 -> 그레고리력 날짜)
+static void civil_from_days(int32_t z, uint16_t *year, uint8_t *month, uint8_t *day) {
+    z += 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = z - era * 146097;
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    int d = doy - (153 * mp + 2) / 5 + 1;
+    int m = mp + (mp < 10 ? 3 : -9);
+    *year = yoe + era * 400 + (m <= 2);
+    *month = m;
+    *day = d;
+}
+
+#define DAYS_2000 10957 // gps_days_from_civil(2000, 1, 1)
+
+bool track_point_from_gps(const GPS_Data *gps, track_point_t *out) {
+    if (!gps->valid || gps->year < 2000 || gps->month == 0 || gps->day == 0) return false;
+
+    int32_t days = gps_days_from_civil(gps->year, gps->month, gps->day) - DAYS_2000;
+    out->time_ms = (uint64_t)days * MS_PER_DAY + gps->utc_ms;
+    out->lat = gps->latitude;
+    out->lon = gps->longitude;
+    out->alt_cm = gps->altitude_cm;
+    out->quality = gps->fix_quality;
+    out->sats = gps->sat_count;
+    out->hdop_x10 = (gps->hdop_x100 + 5) / 10;
+    return true;
+}
+
+void track_time_to_utc(uint64_t time_ms, uint16_t *year, uint8_t *month, uint8_t *day, uint32_t *ms_of_day) {
+    civil_from_days((int32_t)(time_ms / MS_PER_DAY) + DAYS_2000, year, month, day);
+    *ms_of_day = time_ms % MS_PER_DAY;
+}
+
+// --- [varint / zigzag] ---
+static size_t put_varint(uint8_t *p, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)v | 0x80;
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static size_t put_zigzag(uint8_t *p, int64_t v) {
+    return put_varint(p, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+static bool get_varint(track_decoder_t *dec, uint64_t *out) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64 && dec->pos < dec->size; shift += 7) {
+        uint8_t b = dec->page[dec->pos++];
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool get_zigzag(track_decoder_t *dec, int64_t *out) {
+    uint64_t v;
+    if (!get_varint(dec, &v)) return false;
+    *out = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    return true;
+}
+
+static bool get_byte(track_decoder_t *dec, uint8_t *out) {
+    if (dec->pos >= dec->size) return false;
+    *out = dec->page[dec->pos++];
+    return true;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 레코드 하나를 쓰고/읽은 뒤 양쪽이 똑같이 상태를 갱신 (키프레임이면 이동량 0 부터)
+static void state_advance(track_state_t *st, const track_point_t *pt, bool key) {
+    st->vlat = key ? 0 : (int32_t)((int64_t)pt->lat - st->prev.lat);
+    st->vlon = key ? 0 : (int32_t)((int64_t)pt->lon - st->prev.lon);
+    st->prev = *pt;
+    st->has_prev = true;
+}
+
+// --- [인코더] ---
+void track_encoder_start(track_encoder_t *enc, uint8_t *page, size_t size, uint32_t seq) {
+    enc->page = page;
+    enc->size = size;
+    memset(page, 0xFF, size); // 지워진 플래시와 같은 상태
+    put_u32(page, TRACK_PAGE_MAGIC);
+    put_u32(page + 4, seq);
+    enc->len = TRACK_HEADER_SIZE;
+    enc->points = 0;
+    memset(&enc->st, 0, sizeof(enc->st));
+}
+
+bool track_encode(track_encoder_t *enc, const track_point_t *pt) {
+    uint8_t rec[TRACK_MAX_RECORD];
+    size_t n = 1;
+    track_state_t *st = &enc->st;
+    uint8_t flags = 0;
+
+    // 페이지 첫 fix 이거나, 시간이 거꾸로 가거나 너무 오래 끊겼으면 절대값으로
+    bool key = !st->has_prev || pt->time_ms <= st->prev.time_ms || pt->time_ms - st->prev.time_ms > MAX_GAP_MS;
+
+    if (key) {
+        flags = F_KEY;
+        n += put_varint(rec + n, pt->time_ms);
+        n += put_zigzag(rec + n, pt->lat);
+        n += put_zigzag(rec + n, pt->lon);
+        n += put_zigzag(rec + n, pt->alt_cm);
+        rec[n++] = pt->quality;
+        rec[n++] = pt->sats;
+        n += put_varint(rec + n, pt->hdop_x10);
+        st->dt_ms = 0;
+    } else {
+        uint32_t dt = (uint32_t)(pt->time_ms - st->prev.time_ms);
+        if (dt != st->dt_ms) {
+            // 간격이 바뀌면 이동량 예측도 맞지 않으므로 버림 (디코더도 똑같이)
+            flags |= F_DT;
+            n += put_varint(rec + n, dt);
+            st->dt_ms = dt;
+            st->vlat = st->vlon = 0;
+        }
+        if (pt->alt_cm != st->prev.alt_cm) {
+            flags |= F_ALT;
+            n += put_zigzag(rec + n, (int64_t)pt->alt_cm - st->prev.alt_cm);
+        }
+        if (pt->quality != st->prev.quality || pt->sats != st->prev.sats || pt->hdop_x10 != st->prev.hdop_x10) {
+            flags |= F_QUAL;
+            rec[n++] = pt->quality;
+            rec[n++] = pt->sats;
+            n += put_varint(rec + n, pt->hdop_x10);
+        }
+        n += put_zigzag(rec + n, (int64_t)pt->lat - ((int64_t)st->prev.lat + st->vlat));
+        n += put_zigzag(rec + n, (int64_t)pt->lon - ((int64_t)st->prev.lon + st->vlon));
+    }
+    rec[0] = flags;
+
+    // 자리가 없음. 위에서 바뀐 dt_ms 등은 새 페이지를 시작할 때 초기화되므로 되돌리지 않음
+    if (enc->len + n > enc->size) return false;
+    memcpy(enc->page + enc->len, rec, n);
+    enc->len += n;
+    enc->points++;
+    state_advance(st, pt, key);
+    return true;
+}
+
+// --- [디코더] ---
+bool track_decoder_start(track_decoder_t *dec, const uint8_t *page, size_t size, uint32_t *seq) {
+    if (size < TRACK_HEADER_SIZE || get_u32(page) != TRACK_PAGE_MAGIC) return false;
+    dec->page = page;
+    dec->size = size;
+    dec->pos = TRACK_HEADER_SIZE;
+    memset(&dec->st, 0, sizeof(dec->st));
+    if (seq) *seq = get_u32(page + 4);
+    return true;
+}
+
+bool track_decode_next(track_decoder_t *dec, track_point_t *out) {
+    track_state_t *st = &dec->st;
+    uint8_t flags;
+    uint64_t u;
+    int64_t s;
+
+    if (!get_byte(dec, &flags) || flags == 0xFF || (flags & ~F_VALID)) return false;
+
+    track_point_t pt;
+    bool key = flags & F_KEY;
+    if (key) {
+        if (!get_varint(dec, &pt.time_ms)) return false;
+        if (!get_zigzag(dec, &s)) return false;
+        pt.lat = (int32_t)s;
+        if (!get_zigzag(dec, &s)) return false;
+        pt.lon = (int32_t)s;
+        if (!get_zigzag(dec, &s)) return false;
+        pt.alt_cm = (int32_t)s;
+        if (!get_byte(dec, &pt.quality) || !get_byte(dec, &pt.sats) || !get_varint(dec, &u)) return false;
+        pt.hdop_x10 = (uint16_t)u;
+        st->dt_ms = 0;
+    } else {
+        if (!st->has_prev) return false; // 키프레임 없이 차분부터 나오면 깨진 페이지
+        pt = st->prev;
+        if (flags & F_DT) {
+            if (!get_varint(dec, &u)) return false;
+            st->dt_ms = (uint32_t)u;
+            st->vlat = st->vlon = 0;
+        }
+        pt.time_ms = st->prev.time_ms + st->dt_ms;
+        if (flags & F_ALT) {
+            if (!get_zigzag(dec, &s)) return false;
+            pt.alt_cm = (int32_t)(st->prev.alt_cm + s);
+        }
+        if (flags & F_QUAL) {
+            if (!get_byte(dec, &pt.quality) || !get_byte(dec, &pt.sats) || !get_varint(dec, &u)) return false;
+            pt.hdop_x10 = (uint16_t)u;
+        }
+        if (!get_zigzag(dec, &s)) return false;
+        pt.lat = (int32_t)((int64_t)st->prev.lat + st->vlat + s);
+        if (!get_zigzag(dec, &s)) return false;
+        pt.lon = (int32_t)((int64_t)st->prev.lon + st->vlon + s);
+    }
+
+    state_advance(st, &pt, key);
+    *out = pt;
+    return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "nmea_parser.h"
+
+// --- [트랙 기록 형식 (페이지 단위, 차분 + varint)] ---
+// 플래시 섹터 크기(4KB)의 페이지에 fix 를 이어서 기록합니다.
+// 페이지는 각각 따로 해독할 수 있음: 머리말 + 첫 fix 는 절대값(키프레임), 이후는 차분.
+//
+//   머리말 : magic(4) "TRK1" | seq(4, 리틀엔디안, 페이지마다 1씩 증가)
+//   레코드 : flags(1) | [flags 에 따른 필드] | 위도 잔차 | 경도 잔차
+//
+// 위도/경도는 "직전 위치 + 직전 이동량" 으로 예측한 값과의 차이(잔차)만 저장.
+// 일정한 속도로 움직이면 잔차가 거의 0 이라 1바이트씩이면 됨.
+// 시간 간격(100ms 등), 고도, 품질은 바뀌었을 때만 저장 -> 10Hz 에서 fix 당 평균 3~6 바이트.
+// 정수는 zigzag + varint (7비트씩, 작은 값은 1바이트).
+// 지워진 플래시는 0xFF 이고 flags 로 0xFF 는 쓰지 않으므로 0xFF 를 만나면 페이지 끝.
+// ESP-IDF 의존성 없음 (PC 의 tools/track_decode 도 같은 코드로 해독)
+
+#define TRACK_PAGE_SIZE   4096
+#define TRACK_PAGE_MAGIC  0x314B5254u // "TRK1"
+#define TRACK_HEADER_SIZE 8
+
+typedef struct {
+    uint64_t time_ms;   // 2000-01-01 00:00 UTC 부터 ms
+    int32_t lat, lon;   // 1e-7 도
+    int32_t alt_cm;
+    uint8_t quality;    // GGA fix quality
+    uint8_t sats;
+    uint16_t hdop_x10;  // HDOP x10 (기록할 때 0.1 단위로 줄임)
+} track_point_t;
+
+// 인코더와 디코더가 똑같이 갖고 있는 "직전 상태" (예측에 사용)
+typedef struct {
+    track_point_t prev;
+    int32_t vlat, vlon; // 직전 이동량 (fix 1번당)
+    uint32_t dt_ms;     // 직전 시간 간격
+    bool has_prev;
+} track_state_t;
+
+typedef struct {
+    uint8_t *page;
+    size_t size;
+    size_t len;         // 지금까지 쓴 바이트 (머리말 포함)
+    uint32_t points;    // 이 페이지의 fix 수
+    track_state_t st;
+} track_encoder_t;
+
+typedef struct {
+    const uint8_t *page;
+    size_t size;
+    size_t pos;
+    track_state_t st;
+} track_decoder_t;
+
+// GPS_Data -> 기록용 값. 유효한 위치/날짜가 아니면 false
+bool track_point_from_gps(const GPS_Data *gps, track_point_t *out);
+// 기록 시간 -> UTC 날짜/시각
+void track_time_to_utc(uint64_t time_ms, uint16_t *year, uint8_t *month, uint8_t *day, uint32_t *ms_of_day);
+
+// 빈 페이지 시작 (머리말 기록). 다음 fix 는 키프레임
+void track_encoder_start(track_encoder_t *enc, uint8_t *page, size_t size, uint32_t seq);
+// fix 하나 추가. 페이지에 자리가 없으면 false (새 페이지로 시작해서 다시 넣을 것)
+bool track_encode(track_encoder_t *enc, const track_point_t *pt);
+
+// 페이지 머리말 확인. 트랙 페이지가 아니면(지워진 섹터 등) false
+bool track_decoder_start(track_decoder_t *dec, const uint8_t *page, size_t size, uint32_t *seq);
+// 다음 fix. 페이지 끝이거나 깨진 레코드면 false
+bool track_decode_next(track_decoder_t *dec, track_point_t *out);
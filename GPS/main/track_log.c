@@ -0,0 +1,186 @@
+#include <string.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_partition.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "track_codec.h"
+#include "track_log.h"
+
+static const char *TAG = "GPS_TRACK";
+
+#define TRACK_PARTITION   "track"
+#define WRITE_QUEUE_LEN   4
+#define FLUSH_MS          (CONFIG_GPS_TRACK_FLUSH_SEC * 1000u) // GPS_TRACK_LOG 가 켜져 있을 때만 빌드됨 (CMakeLists.txt)
+
+// 쓰기 태스크에 넘기는 일: page_buf[buf] 의 [from, to) 를 sector 에 씀.
+// from == 0 이면 먼저 섹터를 지움. last 면 다 쓴 뒤 버퍼를 돌려줌
+typedef struct {
+    uint8_t buf;
+    bool last;
+    uint16_t from, to;
+    uint32_t sector;
+} write_job_t;
+
+static const esp_partition_t *part;
+static uint32_t page_count;     // 파티션 안의 섹터(페이지) 수
+static uint32_t next_sector;    // 다음 페이지를 쓸 섹터
+static uint32_t next_seq;       // 다음 페이지 번호
+
+static uint8_t page_buf[2][TRACK_PAGE_SIZE]; // 하나는 채우는 중, 하나는 플래시로 쓰는 중
+static volatile bool buf_busy[2];
+static int active_buf;
+static uint32_t active_sector;
+static size_t flushed_len;      // 활성 페이지에서 이미 쓰기 요청한 바이트
+static track_encoder_t enc;     // enc.page == NULL 이면 활성 페이지 없음
+
+static track_point_t pending;   // 아직 끝나지 않은 에포크
+static bool has_pending;
+static uint64_t last_flush_ms;
+
+static QueueHandle_t write_queue;
+static track_log_stats_t stats;
+
+// --- [쓰기 태스크] ---
+static void track_writer_task(void *arg) {
+    write_job_t job;
+    while (1) {
+        if (xQueueReceive(write_queue, &job, portMAX_DELAY) != pdTRUE) continue;
+
+        size_t addr = (size_t)job.sector * TRACK_PAGE_SIZE;
+        esp_err_t err = ESP_OK;
+        if (job.from == 0) err = esp_partition_erase_range(part, addr, TRACK_PAGE_SIZE);
+        if (err == ESP_OK) err = esp_partition_write(part, addr + job.from, page_buf[job.buf] + job.from, job.to - job.from);
+        if (err != ESP_OK) {
+            stats.write_errors++;
+            ESP_LOGE(TAG, "섹터 %lu 쓰기 실패: %s", (unsigned long)job.sector, esp_err_to_name(err));
+        }
+        if (job.last) buf_busy[job.buf] = false;
+    }
+}
+
+// 활성 페이지에서 아직 안 쓴 부분을 쓰기 태스크로 넘김.
+// 이미 넘긴 바이트는 다시 바뀌지 않으므로(이어 쓰기만 함) 버퍼를 복사하지 않고 그대로 넘김
+static bool queue_write(bool last) {
+    if (flushed_len == enc.len && !last) return true;
+
+    write_job_t job = {
+        .buf = active_buf,
+        .last = last,
+        .from = flushed_len,
+        .to = enc.len,
+        .sector = active_sector,
+    };
+    if (last) buf_busy[active_buf] = true;
+    if (xQueueSend(write_queue, &job, 0) != pdTRUE) {
+        if (last) buf_busy[active_buf] = false;
+        return false;
+    }
+    flushed_len = enc.len;
+    return true;
+}
+
+// 비어 있는 버퍼로 새 페이지 시작 (방금 넘긴 버퍼는 쓰는 중이므로 다른 쪽부터).
+// 두 버퍼 모두 아직 플래시로 쓰이는 중이면 false
+static bool start_page(void) {
+    int buf = active_buf ^ 1;
+    if (buf_busy[buf]) buf = active_buf;
+    if (buf_busy[buf]) return false;
+
+    active_buf = buf;
+    active_sector = next_sector;
+    next_sector = (next_sector + 1) % page_count;
+    flushed_len = 0;
+    track_encoder_start(&enc, page_buf[buf], TRACK_PAGE_SIZE, next_seq++);
+    return true;
+}
+
+static void log_point(const track_point_t *pt) {
+    if (enc.page == NULL && !start_page()) {
+        stats.dropped++;
+        return;
+    }
+
+    size_t before = enc.len;
+    if (!track_encode(&enc, pt)) {
+        // 페이지가 가득 참 -> 플래시로 넘기고 다음 페이지에 다시 씀
+        uint32_t points = enc.points;
+        if (queue_write(true)) {
+            stats.pages++;
+        } else {
+            stats.dropped += points;
+        }
+        enc.page = NULL;
+        if (!start_page()) {
+            stats.dropped++;
+            return;
+        }
+        before = enc.len;
+        track_encode(&enc, pt);
+    }
+    stats.fixes++;
+    stats.bytes += enc.len - before;
+
+    // 전원이 꺼져도 잃는 양을 줄이기 위해 주기적으로 새로 쌓인 부분만 씀
+    if (pt->time_ms - last_flush_ms >= FLUSH_MS) {
+        if (queue_write(false)) last_flush_ms = pt->time_ms;
+    }
+}
+
+void track_log_fix(const GPS_Data *gps) {
+    track_point_t pt;
+    if (part == NULL || !track_point_from_gps(gps, &pt)) return;
+
+    // 한 에포크의 RMC, GGA 가 따로 들어오므로 시각이 바뀔 때 직전 에포크(마지막 상태)를 기록
+    if (has_pending && pt.time_ms != pending.time_ms) log_point(&pending);
+    pending = pt;
+    has_pending = true;
+}
+
+void track_log_get_stats(track_log_stats_t *out) {
+    *out = stats;
+}
+
+// --- [이어 쓰기 위치 찾기] ---
+// 각 섹터의 머리말만 읽어서 페이지 번호가 가장 큰 섹터의 다음부터 씀
+static void find_resume_point(void) {
+    uint32_t best_seq = 0;
+    bool found = false;
+
+    for (uint32_t i = 0; i < page_count; i++) {
+        uint8_t header[TRACK_HEADER_SIZE];
+        track_decoder_t dec;
+        uint32_t seq;
+        if (esp_partition_read(part, (size_t)i * TRACK_PAGE_SIZE, header, sizeof(header)) != ESP_OK) continue;
+        if (!track_decoder_start(&dec, header, sizeof(header), &seq)) continue;
+        if (!found || (int32_t)(seq - best_seq) > 0) {
+            best_seq = seq;
+            next_sector = (i + 1) % page_count;
+            found = true;
+        }
+    }
+    next_seq = found ? best_seq + 1 : 1;
+}
+
+esp_err_t track_log_init(void) {
+    const esp_partition_t *p = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, TRACK_PARTITION);
+    if (p == NULL) {
+        ESP_LOGW(TAG, "'%s' 파티션이 없습니다 (partitions.csv 확인). 트랙 기록 안 함", TRACK_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+    page_count = p->size / TRACK_PAGE_SIZE;
+    if (page_count < 2) return ESP_ERR_INVALID_SIZE;
+
+    write_queue = xQueueCreate(WRITE_QUEUE_LEN, sizeof(write_job_t));
+    if (write_queue == NULL) return ESP_ERR_NO_MEM;
+    if (xTaskCreate(track_writer_task, "track_writer", 3072, NULL, 3, NULL) != pdPASS) return ESP_ERR_NO_MEM;
+
+    part = p;
+    find_resume_point();
+    ESP_LOGI(TAG, "트랙 파티션 %lu KB (%lu 페이지), 섹터 %lu 부터 기록 (페이지 #%lu)",
+             (unsigned long)(p->size / 1024), (unsigned long)page_count,
+             (unsigned long)next_sector, (unsigned long)next_seq);
+    return ESP_OK;
+}
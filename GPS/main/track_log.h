@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "nmea_parser.h"
+
+// --- [트랙 기록 (플래시 파티션 "track")] ---
+// fix 를 track_codec 형식으로 RAM 페이지(4KB)에 모았다가 섹터 단위로 플래시에 씁니다.
+// 파티션을 링처럼 돌려 쓰므로 가득 차면 가장 오래된 페이지부터 지워짐.
+// 섹터 지우기(수십 ms)는 별도 쓰기 태스크가 하므로 파서 태스크는 기다리지 않음.
+// 전원이 갑자기 꺼져도 잃는 양이 CONFIG_GPS_TRACK_FLUSH_SEC 초 이하가 되도록,
+// 쓰고 있는 페이지도 주기적으로 새로 추가된 부분만 써 둠 (같은 섹터에 이어 쓰기, 추가 지우기 없음).
+// 기록된 트랙은 PC 에서 tools/track_decode 로 CSV/GPX 로 풀 수 있음.
+
+typedef struct {
+    uint32_t fixes;         // 기록한 fix 수
+    uint32_t bytes;         // 기록한 레코드 바이트 수 (페이지 머리말 제외)
+    uint32_t pages;         // 다 채워서 넘긴 페이지 수
+    uint32_t dropped;       // 쓰기가 밀려서 버린 fix 수
+    uint32_t write_errors;  // 플래시 지우기/쓰기 실패
+} track_log_stats_t;
+
+// 파티션을 찾고 마지막으로 쓴 페이지 다음부터 이어서 기록하도록 준비.
+// 파티션이 없으면 ESP_ERR_NOT_FOUND (이후 track_log_fix 는 아무것도 안 함)
+esp_err_t track_log_init(void);
+
+// 파서 태스크에서 GPS_UPDATED_FIX 마다 호출. 한 에포크(같은 UTC 시각)는 fix 1개로 기록
+void track_log_fix(const GPS_Data *gps);
+
+void track_log_get_stats(track_log_stats_t *out);
@@ -0,0 +1,108 @@
+#include <string.h>
+#include "ubx.h"
+
+// 조립 상태
+enum {
+    UBX_WAIT_SYNC1 = 0,
+    UBX_WAIT_SYNC2,
+    UBX_READ_CLASS,
+    UBX_READ_ID,
+    UBX_READ_LEN1,
+    UBX_READ_LEN2,
+    UBX_READ_PAYLOAD,
+    UBX_READ_CK_A,
+    UBX_READ_CK_B,
+};
+
+void ubx_decoder_init(ubx_decoder_t *d) {
+    memset(d, 0, sizeof(*d));
+}
+
+// 체크섬 누적 (class ~ payload)
+static inline void ck_add(ubx_decoder_t *d, uint8_t b) {
+    d->ck_a += b;
+    d->ck_b += d->ck_a;
+}
+
+bool ubx_decoder_push(ubx_decoder_t *d, uint8_t b) {
+    switch (d->state) {
+        case UBX_WAIT_SYNC1:
+            if (b == UBX_SYNC1) d->state = UBX_WAIT_SYNC2;
+            break;
+        case UBX_WAIT_SYNC2:
+            if (b == UBX_SYNC2) d->state = UBX_READ_CLASS;
+            else d->state = (b == UBX_SYNC1) ? UBX_WAIT_SYNC2 : UBX_WAIT_SYNC1;
+            break;
+        case UBX_READ_CLASS:
+            d->ck_a = d->ck_b = 0;
+            ck_add(d, b);
+            d->cls = b;
+            d->state = UBX_READ_ID;
+            break;
+        case UBX_READ_ID:
+            ck_add(d, b);
+            d->id = b;
+            d->state = UBX_READ_LEN1;
+            break;
+        case UBX_READ_LEN1:
+            ck_add(d, b);
+            d->len = b;
+            d->state = UBX_READ_LEN2;
+            break;
+        case UBX_READ_LEN2:
+            ck_add(d, b);
+            d->len |= (uint16_t)b << 8;
+            d->pos = 0;
+            if (d->len > UBX_MAX_PAYLOAD) {
+                d->errors++;
+                d->state = UBX_WAIT_SYNC1;
+            } else {
+                d->state = d->len > 0 ? UBX_READ_PAYLOAD : UBX_READ_CK_A;
+            }
+            break;
+        case UBX_READ_PAYLOAD:
+            ck_add(d, b);
+            d->payload[d->pos++] = b;
+            if (d->pos >= d->len) d->state = UBX_READ_CK_A;
+            break;
+        case UBX_READ_CK_A:
+            if (b == d->ck_a) {
+                d->state = UBX_READ_CK_B;
+            } else {
+                d->errors++;
+                d->state = UBX_WAIT_SYNC1;
+            }
+            break;
+        case UBX_READ_CK_B:
+            d->state = UBX_WAIT_SYNC1;
+            if (b == d->ck_b) {
+                d->frames++;
+                return true;
+            }
+            d->errors++;
+            break;
+    }
+    return false;
+}
+
+size_t ubx_build(uint8_t *out, size_t size, uint8_t cls, uint8_t id, const void *payload, uint16_t len) {
+    size_t total = (size_t)len + 8;
+    if (total > size) return 0;
+
+    out[0] = UBX_SYNC1;
+    out[1] = UBX_SYNC2;
+    out[2] = cls;
+    out[3] = id;
+    out[4] = (uint8_t)(len & 0xFF);
+    out[5] = (uint8_t)(len >> 8);
+    if (len > 0) memcpy(out + 6, payload, len);
+
+    uint8_t ck_a = 0, ck_b = 0;
+    for (size_t i = 2; i < 6 + (size_t)len; i++) {
+        ck_a += out[i];
+        ck_b += ck_a;
+    }
+    out[6 + len] = ck_a;
+    out[7 + len] = ck_b;
+    return total;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- [UBX 바이너리 프로토콜 (u-blox)] ---
+// 프레임 구조: 0xB5 0x62 | class | id | 길이(2, 리틀엔디안) | payload | CK_A CK_B
+// 체크섬은 class 부터 payload 끝까지의 8비트 Fletcher 합.
+// ESP-IDF 의존성 없음 (PC 에서도 빌드 가능)
+
+#define UBX_SYNC1   0xB5
+#define UBX_SYNC2   0x62
+#define UBX_MAX_PAYLOAD  256 // 이보다 긴 프레임은 버림 (NAV-PVT 는 92 바이트)
+
+// 자주 쓰는 class / id
+#define UBX_CLASS_NAV     0x01
+#define UBX_CLASS_ACK     0x05
+#define UBX_CLASS_CFG     0x06
+#define UBX_ACK_NAK       0x00
+#define UBX_ACK_ACK       0x01
+#define UBX_CFG_PRT       0x00
+#define UBX_CFG_MSG       0x01
+#define UBX_CFG_RATE      0x08
+
+// 수신 프레임 조립기 (바이트 단위로 넣으면 완성된 프레임을 알려줌)
+typedef struct {
+    uint8_t state;
+    uint8_t cls, id;
+    uint16_t len, pos;
+    uint8_t ck_a, ck_b;
+    uint8_t payload[UBX_MAX_PAYLOAD];
+    uint32_t frames;    // 체크섬 통과한 프레임 수
+    uint32_t errors;    // 체크섬 오류 / 너무 긴 프레임
+} ubx_decoder_t;
+
+void ubx_decoder_init(ubx_decoder_t *d);
+// 바이트 하나 처리. 프레임이 완성되면 true (d->cls, d->id, d->len, d->payload 가 유효)
+bool ubx_decoder_push(ubx_decoder_t *d, uint8_t byte);
+
+// 보낼 프레임 만들기. 만든 길이(바이트)를 돌려줌, 공간이 모자라면 0
+size_t ubx_build(uint8_t *out, size_t size, uint8_t cls, uint8_t id, const void *payload, uint16_t len);
+
+// payload 에서 리틀엔디안 값 읽기
+static inline uint16_t ubx_u16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t ubx_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static inline int32_t ubx_i32(const uint8_t *p) { return (int32_t)ubx_u32(p); }
@@ -0,0 +1,74 @@
+#include "ubx_nav.h"
+
+#define MS_PER_DAY 86400000L
+
+// NAV-PVT payload 오프셋
+#define PVT_YEAR      4
+#define PVT_MONTH     6
+#define PVT_DAY       7
+#define PVT_HOUR      8
+#define PVT_MIN       9
+#define PVT_SEC       10
+#define PVT_VALID     11  // bit0 = 날짜 유효, bit1 = 시간 유효
+#define PVT_NANO      16  // 초 단위 이하 보정 (-1e9 ~ 1e9 ns)
+#define PVT_FIX_TYPE  20  // 0=없음, 1=DR, 2=2D, 3=3D, 4=GNSS+DR, 5=시간만
+#define PVT_FLAGS     21  // bit0 = gnssFixOK, bit1 = diffSoln
+#define PVT_NUM_SV    23
+#define PVT_LON       24  // 1e-7 도
+#define PVT_LAT       28  // 1e-7 도
+#define PVT_HMSL      36  // 해발 고도 (mm)
+#define PVT_HACC      40  // mm
+#define PVT_VACC      44  // mm
+#define PVT_GSPEED    60  // 지면 속도 (mm/s)
+#define PVT_HEADMOT   64  // 진행 방향 (1e-5 도)
+#define PVT_PDOP      76  // 0.01
+
+static uint32_t apply_nav_pvt(GPS_Data *gps, const uint8_t *p) {
+    uint8_t valid = p[PVT_VALID];
+    uint8_t flags = p[PVT_FLAGS];
+    uint8_t fix_type = p[PVT_FIX_TYPE];
+
+    if (valid & 0x02) {
+        int32_t ms = ((p[PVT_HOUR] * 60 + p[PVT_MIN]) * 60 + p[PVT_SEC]) * 1000
+                   + ubx_i32(p + PVT_NANO) / 1000000;
+        if (ms < 0) ms += MS_PER_DAY;
+        gps->utc_ms = (uint32_t)(ms % MS_PER_DAY);
+    }
+    if (valid & 0x01) {
+        gps->year = ubx_u16(p + PVT_YEAR);
+        gps->month = p[PVT_MONTH];
+        gps->day = p[PVT_DAY];
+    }
+
+    gps->valid = flags & 0x01;
+    gps->fix_quality = !(flags & 0x01) ? 0 : (flags & 0x02) ? 2 : 1;
+    gps->fix_type = (fix_type == 2) ? 2 : (fix_type == 3 || fix_type == 4) ? 3 : 1;
+    gps->sat_count = p[PVT_NUM_SV];
+
+    // 좌표 단위가 GPS_Data 와 같은 1e-7 도라서 그대로 복사
+    gps->latitude = ubx_i32(p + PVT_LAT);
+    gps->longitude = ubx_i32(p + PVT_LON);
+    gps->altitude_cm = ubx_i32(p + PVT_HMSL) / 10;
+    gps->h_acc_mm = ubx_u32(p + PVT_HACC);
+    gps->v_acc_mm = ubx_u32(p + PVT_VACC);
+
+    int32_t speed = ubx_i32(p + PVT_GSPEED);
+    gps->speed_mmps = speed > 0 ? (uint32_t)speed : 0;
+    int32_t heading = ubx_i32(p + PVT_HEADMOT) / 1000; // 1e-5 도 -> 0.01 도
+    if (heading < 0) heading += 36000;
+    gps->course_cdeg = (uint16_t)heading;
+    gps->pdop_x100 = ubx_u16(p + PVT_PDOP);
+
+    return GPS_UPDATED_FIX;
+}
+
+uint32_t ubx_apply_frame_to(GPS_Data *gps, const ubx_decoder_t *d) {
+    if (d->cls == UBX_CLASS_NAV && d->id == UBX_NAV_PVT && d->len == UBX_NAV_PVT_LEN) {
+        return apply_nav_pvt(gps, d->payload);
+    }
+    return 0;
+}
+
+uint32_t ubx_apply_frame(const ubx_decoder_t *d) {
+    return ubx_apply_frame_to(&my_gps, d);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include "ubx.h"
+#include "nmea_parser.h"
+
+// --- [UBX NAV-PVT -> GPS_Data] ---
+// NAV-PVT(0x01 0x07) 한 프레임(92 바이트)에 위치/시간/fix 종류/위성 수/정확도가 모두 들어있음.
+// 숫자가 이미 정수(1e-7 도, mm, ms)로 오기 때문에 NMEA 처럼 문자 -> 숫자 변환이 필요 없음.
+// parse_nmea() 와 같은 my_gps 를 채우므로 출력 쪽은 프로토콜을 몰라도 됨.
+
+#define UBX_NAV_PVT      0x07
+#define UBX_NAV_PVT_LEN  92
+
+// 완성된 UBX 프레임을 gps 에 반영하고 GPS_UPDATED_* 비트를 돌려줌 (모르는 프레임이면 0)
+uint32_t ubx_apply_frame_to(GPS_Data *gps, const ubx_decoder_t *d);
+// 수신기가 하나일 때: my_gps 에 반영
+uint32_t ubx_apply_frame(const ubx_decoder_t *d);
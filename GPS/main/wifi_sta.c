@@ -0,0 +1,52 @@
+#include <string.h>
+#include "esp_wifi.h"
+#include "esp_netif.h"
+#include "esp_event.h"
+#include "esp_log.h"
+#include "wifi_sta.h"
+
+static const char *TAG = "WIFI_STA";
+
+static volatile bool connected;
+
+static void on_wifi_event(void *arg, esp_event_base_t base, int32_t id, void *data) {
+    if (base == WIFI_EVENT && id == WIFI_EVENT_STA_START) {
+        esp_wifi_connect();
+    } else if (base == WIFI_EVENT && id == WIFI_EVENT_STA_DISCONNECTED) {
+        if (connected) ESP_LOGW(TAG, "연결 끊김, 다시 연결 중");
+        connected = false;
+        esp_wifi_connect(); // AP 가 없어도 계속 시도 (시도마다 수 초 걸리므로 따로 쉬지 않음)
+    } else if (base == IP_EVENT && id == IP_EVENT_STA_GOT_IP) {
+        const ip_event_got_ip_t *ev = data;
+        ESP_LOGI(TAG, "연결됨: " IPSTR, IP2STR(&ev->ip_info.ip));
+        connected = true;
+    }
+}
+
+esp_err_t wifi_sta_start(const char *ssid, const char *password) {
+    esp_err_t err = esp_netif_init();
+    if (err == ESP_OK) err = esp_event_loop_create_default();
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err; // 이미 만들어져 있으면 그대로 씀
+    esp_netif_create_default_wifi_sta();
+
+    wifi_init_config_t init = WIFI_INIT_CONFIG_DEFAULT();
+    err = esp_wifi_init(&init);
+    if (err != ESP_OK) return err;
+    esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID, on_wifi_event, NULL);
+    esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, on_wifi_event, NULL);
+
+    wifi_config_t cfg = { 0 };
+    strncpy((char *)cfg.sta.ssid, ssid, sizeof(cfg.sta.ssid));
+    strncpy((char *)cfg.sta.password, password, sizeof(cfg.sta.password));
+    esp_wifi_set_mode(WIFI_MODE_STA);
+    esp_wifi_set_config(WIFI_IF_STA, &cfg);
+    err = esp_wifi_start();
+    // 기본 절전(modem sleep)에서는 클라이언트의 ACK 를 비콘 간격(100~300 ms)마다 몰아서 받아서 전송이 띄엄띄엄 됨
+    if (err == ESP_OK) esp_wifi_set_ps(WIFI_PS_NONE);
+    if (err == ESP_OK) ESP_LOGI(TAG, "'%s' 에 연결 시도", ssid);
+    return err;
+}
+
+bool wifi_sta_connected(void) {
+    return connected;
+}
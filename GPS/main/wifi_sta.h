@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+// --- [Wi-Fi 스테이션 연결] ---
+// NMEA TCP 서버용 최소 연결: 설정한 AP 에 붙고, 끊기면 계속 다시 붙음.
+// 연결을 기다리지 않고 바로 돌아오므로 GPS 수신은 Wi-Fi 상태와 관계없이 시작됨
+// (서버 소켓은 IP 를 받기 전에도 열 수 있고, 연결되면 그때부터 접속을 받음).
+
+// nvs_flash_init() 다음에 호출
+esp_err_t wifi_sta_start(const char *ssid, const char *password);
+
+// IP 를 받아서 연결되어 있으면 true
+bool wifi_sta_connected(void);
@@ -0,0 +1,162 @@
+// --- [지오펜스 벤치마크 (PC 용)] ---
+// main/geofence.c 로 구역 수를 늘려 가며 fix 1개 검사에 드는 시간을 잽니다.
+//  - 구역: 서울 시청 주변 20 km x 20 km 에 무작위로 배치 (반은 원, 반은 꼭짓점 3~12개 다각형, 반지름 50~500 m)
+//  - 경로: 15 m/s 로 방향을 바꿔 가며 달리는 차량, 10Hz fix
+//  - 같은 경로를 "전부 검사"(색인 없음)와 "격자 색인" 으로 돌려서 속도를 비교하고,
+//    들어감/나옴 이벤트 순서가 완전히 같은지 확인
+// 10Hz 면 fix 간격이 100 ms 이므로, ns/fix 가 그보다 훨씬 작으면 파서 태스크 안에서 바로 검사해도 됨.
+//
+// 빌드 & 실행 (GPS/tools 폴더에서):
+//   gcc -O2 -I../main -o geofence_bench geofence_bench.c ../main/geofence.c -lm
+//   ./geofence_bench [seconds]      (경로 길이, 기본 3600초 = fix 36000개)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "geofence.h"
+
+#define CENTER_LAT  37.5665
+#define CENTER_LON  126.9780
+#define AREA_M      20000.0
+#define SPEED_MPS   15.0
+#define FIX_HZ      10
+
+static const int fence_counts[] = { 10, 100, 1000, 5000, 10000 };
+
+static uint32_t rng = 12345;
+static uint32_t rand_u32(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+static double rand_unit(void) {
+    return rand_u32() / 4294967296.0;
+}
+
+static double cpu_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 중심에서 동쪽/북쪽으로 (x, y) m 떨어진 점 -> 1e-7 도
+static geofence_point_t offset_point(double x, double y) {
+    double lat = CENTER_LAT + y / 111320.0;
+    double lon = CENTER_LON + x / (111320.0 * cos(CENTER_LAT * M_PI / 180.0));
+    return (geofence_point_t){ (int32_t)llround(lat * 1e7), (int32_t)llround(lon * 1e7) };
+}
+
+static void add_random_fences(geofence_t *gf, int n) {
+    rng = 12345; // 구역 수와 상관없이 앞쪽 구역은 같게
+    for (int i = 0; i < n; i++) {
+        double x = (rand_unit() - 0.5) * AREA_M, y = (rand_unit() - 0.5) * AREA_M;
+        double radius = 50 + rand_unit() * 450;
+        if (i % 2 == 0) {
+            geofence_point_t c = offset_point(x, y);
+            geofence_add_circle(gf, c.lat, c.lon, (uint32_t)radius, i);
+        } else {
+            // 중심 둘레로 각도 순서대로 꼭짓점을 찍은 별 모양 (오목할 수 있음)
+            geofence_point_t pts[12];
+            int nv = 3 + rand_u32() % 10;
+            for (int k = 0; k < nv; k++) {
+                double a = 2 * M_PI * (k + rand_unit() * 0.8) / nv;
+                double r = radius * (0.4 + 0.6 * rand_unit());
+                pts[k] = offset_point(x + r * cos(a), y + r * sin(a));
+            }
+            geofence_add_polygon(gf, pts, nv, i);
+        }
+    }
+}
+
+// 경로: 구역 배치 영역 안에서 튕기며 달림
+static geofence_point_t *make_track(int num_fixes) {
+    geofence_point_t *track = malloc(num_fixes * sizeof(geofence_point_t));
+    double x = 0, y = 0, heading = 0;
+    rng = 777;
+    for (int i = 0; i < num_fixes; i++) {
+        heading += (rand_unit() - 0.5) * 0.2;
+        x += SPEED_MPS / FIX_HZ * cos(heading);
+        y += SPEED_MPS / FIX_HZ * sin(heading);
+        if (fabs(x) > AREA_M / 2) heading = M_PI - heading;
+        if (fabs(y) > AREA_M / 2) heading = -heading;
+        track[i] = offset_point(x, y);
+    }
+    return track;
+}
+
+// 이벤트 순서 비교용 해시
+typedef struct {
+    uint32_t events;
+    uint64_t hash;
+} event_log_t;
+
+static void on_event(int fence, uint32_t tag, geofence_event_t ev, void *ctx) {
+    event_log_t *log = ctx;
+    log->events++;
+    // tag 도 섞음 (구역 번호와 같게 줬으므로 콜백이 tag 를 제대로 넘기는지도 같이 비교됨)
+    log->hash = (log->hash ^ ((uint64_t)tag << 32 | (uint64_t)(fence * 2 + ev))) * 1099511628211ULL;
+}
+
+// 경로 전체를 검사한 ns/fix
+static double run(int fences, bool indexed, const geofence_point_t *track, int num_fixes,
+                  event_log_t *log, geofence_t *out_stats) {
+    geofence_t gf;
+    memset(log, 0, sizeof(*log));
+    log->hash = 14695981039346656037ULL;
+    if (!geofence_init(&gf, fences, fences * 12, on_event, log)) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    add_random_fences(&gf, fences);
+    if (indexed && !geofence_build(&gf)) {
+        fprintf(stderr, "geofence_build failed\n");
+        exit(1);
+    }
+
+    double t0 = cpu_seconds();
+    for (int i = 0; i < num_fixes; i++) geofence_update(&gf, track[i].lat, track[i].lon);
+    double ns = (cpu_seconds() - t0) * 1e9 / num_fixes;
+
+    *out_stats = gf;
+    out_stats->fences = NULL;
+    out_stats->vertices = NULL;
+    out_stats->inside_bits = NULL;
+    out_stats->cell_start = NULL;
+    out_stats->cell_items = NULL;
+    geofence_free(&gf);
+    return ns;
+}
+
+int main(int argc, char **argv) {
+    int seconds = argc > 1 ? atoi(argv[1]) : 3600;
+    if (seconds < 1) seconds = 1;
+    int num_fixes = seconds * FIX_HZ;
+    geofence_point_t *track = make_track(num_fixes);
+
+    printf("[geofence] %d fixes (%d s at %d Hz), area %.0f x %.0f km\n", num_fixes, seconds, FIX_HZ,
+           AREA_M / 1000, AREA_M / 1000);
+    printf("%7s | %12s %10s | %12s %10s %8s %7s | %7s %5s\n", "fences", "linear ns", "evals/s",
+           "grid ns", "evals/s", "cells", "tests", "events", "same");
+
+    int all_same = 1;
+    for (size_t i = 0; i < sizeof(fence_counts) / sizeof(fence_counts[0]); i++) {
+        int n = fence_counts[i];
+        event_log_t lin_log, grid_log;
+        geofence_t lin_stats, grid_stats;
+        double lin_ns = run(n, false, track, num_fixes, &lin_log, &lin_stats);
+        double grid_ns = run(n, true, track, num_fixes, &grid_log, &grid_stats);
+        int same = lin_log.events == grid_log.events && lin_log.hash == grid_log.hash;
+        all_same &= same;
+
+        printf("%7d | %12.1f %10.0f | %12.1f %10.0f %8d %7.2f | %7u %5s\n", n, lin_ns, 1e9 / lin_ns,
+               grid_ns, 1e9 / grid_ns, grid_stats.rows * grid_stats.cols,
+               (double)grid_stats.exact_tests / num_fixes, (unsigned)grid_log.events, same ? "yes" : "NO");
+    }
+    printf("\n(tests = exact point-in-shape tests per fix after the bounding-box check;\n"
+           " at %d Hz the budget is %d ms per fix)\n", FIX_HZ, 1000 / FIX_HZ);
+
+    free(track);
+    return all_same ? 0 : 1;
+}
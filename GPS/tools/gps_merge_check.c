@@ -0,0 +1,105 @@
+// --- [수신기 합치기 확인 (PC 용)] ---
+// main/gps_merge.c 를 PC 에서 그대로 돌려서 주 수신기를 고르는 규칙을 상황별로 확인합니다.
+//  - 아무도 fix 가 없을 때 / 처음 fix 가 생겼을 때 / 등급이 확실히 좋을 때만 바꿈 (HDOP 차이로는 안 바꿈)
+//  - 주 수신기가 무효 fix 를 내거나 GPS_MERGE_STALE_MS 동안 조용하면 바로 예비로
+//  - 10 Hz 로 두 수신기를 번갈아 돌리며 한쪽을 끊었다 살렸을 때 출력이 끊기지 않고 왔다 갔다 하지 않음
+//
+// 빌드 & 실행 (GPS/tools 폴더에서):
+//   gcc -O2 -I../main -o gps_merge_check gps_merge_check.c ../main/gps_merge.c
+//   ./gps_merge_check                   (틀린 것이 있으면 종료 코드 1)
+#include <stdio.h>
+#include <string.h>
+#include "gps_merge.h"
+
+static int errors;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { errors++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static GPS_Data rx_data[2];
+static const GPS_Data *const gps[2] = { &rx_data[0], &rx_data[1] };
+
+static void set_fix(int rx, bool valid, int fix_type, int quality, int hdop_x100) {
+    rx_data[rx].valid = valid;
+    rx_data[rx].fix_type = fix_type;
+    rx_data[rx].fix_quality = quality;
+    rx_data[rx].hdop_x100 = (uint16_t)hdop_x100;
+}
+
+static bool fix_update(gps_merge_t *m, int rx, int64_t now_ms) {
+    return gps_merge_update(m, rx, GPS_UPDATED_FIX, gps, 2, now_ms);
+}
+
+int main(void) {
+    gps_merge_t m;
+
+    // 1. 아무도 fix 가 없으면 먼저 온 쪽을 그대로 (시각/위성 정보는 나가야 함)
+    gps_merge_init(&m);
+    memset(rx_data, 0, sizeof(rx_data));
+    CHECK(fix_update(&m, 1, 100), "no fix: first update goes out");
+    CHECK(m.primary == 1, "no fix: primary %d", m.primary);
+    CHECK(!fix_update(&m, 0, 150), "no fix: other receiver stays quiet");
+    CHECK(m.primary == 1 && m.switches == 0, "no fix: no switch (primary %d)", m.primary);
+
+    // 2. 예비 쪽에 처음 fix 가 생기면 넘어감
+    set_fix(0, true, 3, 1, 120);
+    CHECK(fix_update(&m, 0, 200), "first fix on receiver 0 goes out");
+    CHECK(m.primary == 0 && m.switches == 1, "first fix: primary %d, switches %lu", m.primary, (unsigned long)m.switches);
+
+    // 3. 같은 등급이면 HDOP 가 훨씬 좋아도 그대로
+    set_fix(1, true, 3, 1, 60);
+    CHECK(!fix_update(&m, 1, 250), "same rank, better HDOP: no switch");
+    CHECK(fix_update(&m, 0, 300), "primary keeps going out");
+    CHECK(m.primary == 0, "same rank: primary %d", m.primary);
+
+    // 4. 등급이 확실히 좋으면 (3D + DGPS) 바꿈
+    set_fix(1, true, 3, 2, 90);
+    CHECK(fix_update(&m, 1, 350), "better rank takes over");
+    CHECK(m.primary == 1 && m.switches == 2, "better rank: primary %d, switches %lu", m.primary, (unsigned long)m.switches);
+    CHECK(!fix_update(&m, 0, 400), "old primary is now quiet");
+
+    // 5. 주 수신기가 무효 fix 를 내면 그 갱신에서 바로 예비로
+    set_fix(1, false, 1, 0, 9999);
+    CHECK(!fix_update(&m, 1, 450), "invalid fix on primary is not sent");
+    CHECK(m.primary == 0, "invalid primary: primary %d", m.primary);
+    CHECK(fix_update(&m, 0, 500), "backup goes out");
+
+    // 6. 다시 좋아진 수신기도 등급이 같으면 돌아가지 않음
+    set_fix(1, true, 3, 1, 50);
+    CHECK(!fix_update(&m, 1, 550), "recovered receiver with same rank stays backup");
+    CHECK(m.primary == 0, "recovered: primary %d", m.primary);
+
+    // 7. 주 수신기가 조용해지면 (선이 빠짐) GPS_MERGE_STALE_MS 뒤 다른 쪽 갱신에서 넘어감
+    int64_t last0 = 500;
+    CHECK(!fix_update(&m, 1, last0 + GPS_MERGE_STALE_MS), "not stale yet at exactly the limit");
+    CHECK(fix_update(&m, 1, last0 + GPS_MERGE_STALE_MS + 1), "stale primary: backup takes over");
+    CHECK(m.primary == 1, "stale: primary %d", m.primary);
+
+    // 8. 잘못된 인자
+    CHECK(!gps_merge_update(&m, -1, GPS_UPDATED_FIX, gps, 2, 3000), "negative rx rejected");
+    CHECK(!gps_merge_update(&m, 2, GPS_UPDATED_FIX, gps, 2, 3000), "rx >= n rejected");
+    CHECK(m.primary == 1, "bad args leave primary alone");
+
+    // 9. 10 Hz 로 60초: 수신기 0 은 20~30초에 끊기고, 수신기 1 은 계속 (같은 등급).
+    //    매 100 ms 에 나가는 fix 가 하나 이상 있고, 바뀜은 끊길 때 한 번 + (돌아가지 않으므로) 그뿐
+    gps_merge_init(&m);
+    set_fix(0, true, 3, 1, 80);
+    set_fix(1, true, 3, 1, 100);
+    int gaps = 0;
+    for (int64_t t = 0; t < 60000; t += 100) {
+        bool rx0_alive = t < 20000 || t >= 30000;
+        bool sent = false;
+        if (rx0_alive) sent |= fix_update(&m, 0, t);
+        sent |= fix_update(&m, 1, t + 50);
+        // 끊긴 뒤 GPS_MERGE_STALE_MS 동안은 주 수신기의 fix 가 없음 (끊김을 알아채는 시간)
+        bool detecting = t >= 20000 && t < 20000 + GPS_MERGE_STALE_MS;
+        if (!sent && !detecting) gaps++;
+    }
+    CHECK(gaps == 0, "10 Hz run: %d intervals without output", gaps);
+    CHECK(m.switches == 1, "10 Hz run: %lu switches (want 1)", (unsigned long)m.switches);
+    CHECK(m.primary == 1, "10 Hz run: primary %d (should stay on 1 after 0 comes back)", m.primary);
+
+    printf("%s (%d errors)\n", errors ? "FAILED" : "OK", errors);
+    return errors ? 1 : 0;
+}
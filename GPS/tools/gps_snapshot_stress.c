@@ -0,0 +1,121 @@
+// --- [스냅샷 찢어짐 시험 (PC 용)] ---
+// main/gps_snapshot.c 를 PC 에서 그대로 돌림: 발행 스레드 하나가 쉬지 않고 발행하고,
+// 읽는 스레드 여러 개가 쉬지 않고 읽어서 받은 복사본이 한 번의 발행으로만 이루어졌는지 확인합니다.
+// 발행할 때마다 구조체 전체를 같은 바이트 (발행 번호의 아래 8비트) 로 채우므로,
+// 두 발행이 섞인 복사본은 바이트가 서로 다름. 위성 목록(약 650 바이트)도 같은 방식으로.
+// 읽은 번호가 거꾸로 가지 않는지도 확인 (한 번 본 것보다 오래된 발행이 나오면 안 됨).
+// 복사 한 번은 너무 짧아서 그냥 돌리면 겹치는 일이 거의 없으므로, memcpy 를 가로채서 (-Wl,--wrap=memcpy)
+// 중간에 양보함 (ESP32 에서 복사 도중 더 높은 우선순위 태스크가 끼어드는 것과 같은 상황).
+// 읽는 쪽은 앞 절반, 쓰는 쪽은 뒤 절반을 먼저 복사하고 양보 -> 읽는 쪽이 아직 안 읽은 부분에 새 값이 먼저 들어감
+//
+// 빌드 & 실행 (GPS/tools 폴더에서):
+//   gcc -O2 -I../main -o gps_snapshot_stress gps_snapshot_stress.c ../main/gps_snapshot.c -lpthread -Wl,--wrap=memcpy
+//   ./gps_snapshot_stress [seconds]      (기본 5초, 찢어진 복사본이 하나라도 있으면 종료 코드 1)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include "gps_snapshot.h"
+
+#define READERS 4
+
+static _Thread_local bool is_publisher;
+
+// 스냅샷 크기의 복사만 중간에 양보 (작은 복사는 그대로)
+void *__real_memcpy(void *dst, const void *src, size_t len);
+void *__wrap_memcpy(void *dst, const void *src, size_t len) {
+    if (len < sizeof(GPS_Data)) return __real_memcpy(dst, src, len);
+    size_t half = len / 2;
+    char *d = dst;
+    const char *s = src;
+    if (is_publisher) {
+        __real_memcpy(d + half, s + half, len - half);
+        sched_yield();
+        __real_memcpy(d, s, half);
+    } else {
+        __real_memcpy(d, s, half);
+        sched_yield();
+        __real_memcpy(d + half, s + half, len - half);
+    }
+    return dst;
+}
+
+static atomic_bool stop;
+static atomic_ulong published;
+
+static void *publisher(void *arg) {
+    static GPS_Data fix;
+    static gps_sat_table_t sats;
+    is_publisher = true;
+    for (unsigned long k = 1; !atomic_load(&stop); k++) {
+        memset(&fix, (int)(k & 0xFF), sizeof(fix));
+        gps_snapshot_publish(&fix);
+        memset(&sats, (int)(k & 0xFF), sizeof(sats));
+        gps_snapshot_publish_sats(&sats);
+        atomic_store(&published, k);
+    }
+    return NULL;
+}
+
+// 모든 바이트가 같은지
+static bool uniform(const void *p, size_t len) {
+    const unsigned char *b = p;
+    for (size_t i = 1; i < len; i++) {
+        if (b[i] != b[0]) return false;
+    }
+    return true;
+}
+
+typedef struct {
+    unsigned long reads, torn, backwards;
+} reader_result_t;
+
+static void *reader(void *arg) {
+    reader_result_t *r = arg;
+    GPS_Data fix;
+    gps_sat_table_t sats;
+    uint32_t last_seq = 0;
+    while (!atomic_load(&stop)) {
+        uint32_t seq = gps_snapshot_seq();
+        if (seq < last_seq) r->backwards++;
+        last_seq = seq;
+        if (gps_snapshot_read(&fix)) {
+            r->reads++;
+            if (!uniform(&fix, sizeof(fix))) r->torn++;
+        }
+        if (gps_snapshot_read_sats(&sats)) {
+            r->reads++;
+            if (!uniform(&sats, sizeof(sats))) r->torn++;
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    int seconds = argc > 1 ? atoi(argv[1]) : 5;
+    reader_result_t res[READERS] = { 0 };
+    pthread_t pub, rd[READERS];
+    pthread_create(&pub, NULL, publisher, NULL);
+    for (int i = 0; i < READERS; i++) pthread_create(&rd[i], NULL, reader, &res[i]);
+
+    struct timespec ts = { .tv_sec = seconds };
+    nanosleep(&ts, NULL);
+    atomic_store(&stop, true);
+    pthread_join(pub, NULL);
+    for (int i = 0; i < READERS; i++) pthread_join(rd[i], NULL);
+
+    unsigned long reads = 0, torn = 0, backwards = 0;
+    for (int i = 0; i < READERS; i++) {
+        reads += res[i].reads;
+        torn += res[i].torn;
+        backwards += res[i].backwards;
+    }
+    printf("published %lu x2, read %lu, torn %lu, seq went backwards %lu\n",
+           atomic_load(&published), reads, torn, backwards);
+    bool ok = torn == 0 && backwards == 0 && reads > 0;
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
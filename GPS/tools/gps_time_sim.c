@@ -0,0 +1,147 @@
+// --- [GPS 시간 맞추기 시뮬레이션 (PC 용)] ---
+// main/gps_time.c 에 가짜 PPS 와 NMEA 시각을 넣고, 계산한 UTC 가 실제와 얼마나 다른지 잽니다.
+//  - 로컬 타이머: 기준보다 +37 ppm 빠르고, 온도 변화처럼 10분 주기로 +-2 ppm 흔들림
+//  - PPS: 매 정각, ISR 지연 1~5 us (무작위)
+//  - NMEA: 10Hz, 각 에포크 문장이 50~350 ms 늦게 도착
+//  - 300~320초: PPS 끊김 (HOLDOVER 확인)
+//  - 400~402초: 문장이 1초 넘게 늦어서 다음 PPS 와 잘못 짝지어짐 (버려지는지 확인)
+// 10 ms 마다 gps_time_to_utc() 결과와 실제 UTC 의 차이를 모아서 상태별로 분포를 출력.
+//
+// 빌드 & 실행 (GPS/tools 폴더에서):
+//   gcc -O2 -I../main -o gps_time_sim gps_time_sim.c ../main/gps_time.c -lm
+//   ./gps_time_sim [seconds]        (기본 900초)
+//   ./gps_time_sim -n [seconds]     (PPS 없이 NMEA 수신 시각만 사용)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "gps_time.h"
+
+#define UTC_BASE_US   1768620310000000LL // 2026-01-17 03:25:10 UTC
+#define LOCAL_BASE_US 5000000LL          // 부팅 후 5초에 시작
+#define QUERY_STEP_US 10000
+
+static uint32_t rng = 12345;
+static uint32_t rand_u32(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+static int64_t rand_range(int64_t lo, int64_t hi) {
+    return lo + rand_u32() % (uint32_t)(hi - lo + 1);
+}
+
+// 실제 경과 시간(us) -> 로컬 타이머 값. 주파수 오차를 적분
+static double true_ppm(double t_s) {
+    return 37.0 + 2.0 * sin(2 * M_PI * t_s / 600.0);
+}
+static int64_t local_at(int64_t t_us) {
+    double t = t_us / 1e6;
+    // 37 ppm * t + 2 ppm 사인의 적분
+    double extra = 37.0 * t + 2.0 * 600.0 / (2 * M_PI) * (1 - cos(2 * M_PI * t / 600.0));
+    return LOCAL_BASE_US + t_us + (int64_t)llround(extra);
+}
+
+// |오차| 분포
+typedef struct {
+    int64_t *v;
+    size_t n, cap;
+} dist_t;
+
+static void dist_add(dist_t *d, int64_t x) {
+    if (d->n == d->cap) {
+        d->cap = d->cap ? d->cap * 2 : 4096;
+        d->v = realloc(d->v, d->cap * sizeof(int64_t));
+    }
+    d->v[d->n++] = x < 0 ? -x : x;
+}
+
+static int cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void dist_print(const char *name, dist_t *d) {
+    if (d->n == 0) {
+        printf("%-9s   : (no samples)\n", name);
+        return;
+    }
+    qsort(d->v, d->n, sizeof(int64_t), cmp_i64);
+    printf("%-9s   : n=%zu  p50=%lld us  p99=%lld us  max=%lld us\n", name, d->n,
+           (long long)d->v[d->n / 2], (long long)d->v[(size_t)(d->n * 0.99)], (long long)d->v[d->n - 1]);
+}
+
+// 시간 순서대로 처리할 사건
+typedef struct {
+    int64_t t_us;   // 실제 시각 (시작부터)
+    int kind;       // 0 = PPS, 1 = 문장
+    int64_t utc_us; // 문장에 담긴 시각
+} event_t;
+
+static int cmp_event(const void *a, const void *b) {
+    const event_t *x = a, *y = b;
+    return x->t_us < y->t_us ? -1 : x->t_us > y->t_us;
+}
+
+int main(int argc, char **argv) {
+    int use_pps = 1;
+    int argi = 1;
+    if (argi < argc && strcmp(argv[argi], "-n") == 0) {
+        use_pps = 0;
+        argi++;
+    }
+    int seconds = argi < argc ? atoi(argv[argi]) : 900;
+    if (seconds < 10) seconds = 10;
+
+    // 사건 만들기
+    size_t max_events = (size_t)seconds * 11;
+    event_t *ev = malloc(max_events * sizeof(event_t));
+    size_t n = 0;
+    for (int s = 0; s < seconds; s++) {
+        if (use_pps && !(s >= 300 && s < 320)) {
+            ev[n++] = (event_t){ (int64_t)s * 1000000 + rand_range(1, 5), 0, 0 };
+        }
+        for (int k = 0; k < 10; k++) {
+            int64_t epoch = (int64_t)s * 1000000 + k * 100000;
+            int64_t delay = rand_range(50000, 350000);
+            if (k == 0 && s >= 400 && s < 403) delay = 1050000; // 다음 PPS 뒤에 도착
+            ev[n++] = (event_t){ epoch + delay, 1, UTC_BASE_US + epoch };
+        }
+    }
+    qsort(ev, n, sizeof(event_t), cmp_event);
+
+    gps_time_t gt;
+    gps_time_init(&gt);
+    dist_t by_state[4] = { 0 };
+    size_t e = 0;
+
+    // 10 ms 마다 조회하면서 그 사이의 사건을 처리
+    for (int64_t t = 0; t < (int64_t)seconds * 1000000; t += QUERY_STEP_US) {
+        for (; e < n && ev[e].t_us <= t; e++) {
+            // ISR 지연은 이미 t_us 에 포함됨 (PPS 는 정각보다 1~5 us 늦게 기록)
+            int64_t local = local_at(ev[e].t_us);
+            if (ev[e].kind == 0) gps_time_pps(&gt, local);
+            else gps_time_utc(&gt, ev[e].utc_us, local);
+        }
+
+        int64_t utc;
+        gps_time_state_t st = gps_time_to_utc(&gt, local_at(t), &utc);
+        if (st != GPS_TIME_NONE && t >= 60 * 1000000) { // 처음 1분(드리프트 수렴)은 제외
+            dist_add(&by_state[st], utc - (UTC_BASE_US + t));
+        }
+    }
+
+    printf("[gps_time] %d s, PPS %s\n", seconds, use_pps ? "on" : "off");
+    printf("pps edges   : %u, paired %u, rejected %u, relocks %u\n", (unsigned)gt.pps_edges,
+           (unsigned)gt.samples, (unsigned)gt.rejected, (unsigned)gt.relocks);
+    printf("drift       : estimated %.3f ppm, true %.3f ppm (local runs fast -> negative)\n",
+           gt.drift_ppb / 1000.0, -true_ppm(seconds));
+    printf("jitter      : %u us\n", (unsigned)gt.jitter_us);
+    printf("\n|UTC error| after the first 60 s, by state:\n");
+    for (int s = GPS_TIME_COARSE; s <= GPS_TIME_HOLDOVER; s++) dist_print(gps_time_state_name(s), &by_state[s]);
+
+    for (int s = 0; s < 4; s++) free(by_state[s].v);
+    free(ev);
+    return 0;
+}
@@ -0,0 +1,396 @@
+// --- [NMEA 수신 경로 벤치마크 (PC 용)] ---
+// 녹화해 둔 NMEA 스트림으로 아래 항목을 측정합니다.
+//  1) 수신 경로: 프레이머 + parse_nmea 처리 속도(bytes/s)와 한 줄당 CPU 시간
+//  2) 파서만 (같은 일끼리 비교):
+//     - 필드 나누기: 모든 필드를 꺼내는 데 예전 get_token (필드마다 처음부터 + 복사) vs nmea_split_fields
+//     - 문장 해석: 예전 파서가 아는 $GPRMC/$GPGGA/$GPGSV 줄만 골라서 예전 parse_nmea vs 새 parse_nmea
+//       (새 파서는 같은 문장에서 속도/고도/위성 목록 등을 더 읽음). 전체 줄에 대한 parse_nmea 속도는 참고로만
+//  3) 프레이밍: 체크섬 통과/거부/넘침 줄 수 (파일을 한 번만 통과시킨 결과)
+//  4) 좌표 변환: 정수 nmea_parse_coord 와 atof + double 변환의 속도, 결과 일치 여부
+//  5) 1회 측위당 CPU: NMEA(RMC+GGA+GSA 프레이밍+파싱) vs UBX NAV-PVT(조립+적용)
+//     (녹화 파일의 각 측위로 같은 내용의 NAV-PVT 프레임을 만들어 비교)
+//
+// 빌드 & 실행 (GPS/tools 폴더에서):
+//   gcc -O2 -I../main -o nmea_bench nmea_bench.c nmea_legacy.c ../main/nmea_framer.c ../main/nmea_parser.c ../main/ubx.c ../main/ubx_nav.c -lm
+//   ./nmea_bench sample.nmea [chunk_bytes] [repeat]
+//   ./nmea_bench sample_gnss.nmea   (GPS+GLONASS+Galileo+BeiDou, $GN 토커)
+//
+// chunk_bytes 는 UART 이벤트 1번에 읽히는 양을 흉내냅니다 (기본 120 = RX FIFO 임계값).
+// chunk_bytes 를 1 로 주면 예전처럼 1바이트씩 넣는 경로와 비교할 수 있습니다.
+//
+// corrupt.nmea 는 깨진 문장을 섞어 둔 검증용 파일입니다.
+//   기대값: accepted=42 rejected=7 overflowed=1
+// (숫자 변조, 체크섬 없음/16진수 아님/3자리, 줄바꿈 유실, 잘린 줄, 바이너리, 너무 긴 줄은 거부.
+//  앞쪽에 쓰레기가 붙은 줄과 줄바꿈 유실로 붙은 뒤쪽 문장은 '$' 에서 다시 맞춰서 통과)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "nmea_framer.h"
+#include "nmea_parser.h"
+#include "nmea_legacy.h"
+#include "ubx.h"
+#include "ubx_nav.h"
+
+#define MAX_LINES 100000
+
+static long line_count = 0;
+
+// 파서 벤치마크용으로 잘라 둔 줄들
+static char *lines[MAX_LINES];
+static int num_lines = 0;
+
+static void on_line(char *line, size_t len, void *ctx) {
+    line_count++;
+    parse_nmea(line);
+}
+
+static void collect_line(char *line, size_t len, void *ctx) {
+    if (num_lines < MAX_LINES) lines[num_lines++] = strdup(line);
+}
+
+static double cpu_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char *load_file(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc(n > 0 ? n : 1);
+    *size = fread(data, 1, n, f);
+    fclose(f);
+    return data;
+}
+
+// --- [1) 수신 경로: 프레이머 + 파서] ---
+static void bench_ingest(const char *path, const char *data, size_t size, size_t chunk, int repeat) {
+    nmea_framer_t framer;
+    nmea_framer_init(&framer, on_line, NULL);
+
+    double t0 = cpu_seconds();
+    for (int r = 0; r < repeat; r++) {
+        for (size_t off = 0; off < size; off += chunk) {
+            size_t n = size - off < chunk ? size - off : chunk;
+            nmea_framer_feed(&framer, data + off, n);
+        }
+    }
+    double elapsed = cpu_seconds() - t0;
+
+    double total_bytes = (double)size * repeat;
+    printf("[ingest]\n");
+    printf("input       : %s (%zu bytes x %d)\n", path, size, repeat);
+    printf("chunk       : %zu bytes\n", chunk);
+    printf("lines       : %ld\n", line_count);
+    printf("cpu time    : %.3f ms\n", elapsed * 1e3);
+    printf("throughput  : %.1f MB/s\n", total_bytes / elapsed / 1e6);
+    printf("per line    : %.1f ns\n", elapsed * 1e9 / (line_count ? line_count : 1));
+    printf("last fix    : %ld, %ld (1e-7 deg)  sats=%d  snr=%d\n",
+           (long)my_gps.latitude, (long)my_gps.longitude, my_gps.sat_count, my_gps.max_snr);
+    for (int i = 0; i < GNSS_COUNT; i++) {
+        if (my_gps.sky[i].in_view == 0) continue;
+        int listed = 0, tracked = 0;
+        for (int k = 0; k < my_sats.count; k++) {
+            if (my_sats.sats[k].system != i) continue;
+            listed++;
+            if (my_sats.sats[k].snr > 0) tracked++;
+        }
+        printf("  %-8s  : in view %d, listed %d, tracked %d, max snr %d\n", gnss_system_name(i),
+               my_gps.sky[i].in_view, listed, tracked, my_gps.sky[i].max_snr);
+    }
+    printf("sat table   : %d / %d slots, epoch %lu\n", my_sats.count, GPS_MAX_SATS, (unsigned long)my_sats.epoch);
+}
+
+// --- [2) 파서만: 같은 일끼리 비교] ---
+static void parse_nmea_new(char *line) {
+    parse_nmea(line);
+}
+
+static void split_new(char *line) {
+    nmea_fields_t f;
+    nmea_split_fields(line, &f);
+}
+
+static void split_old(char *line) {
+    char fields[NMEA_MAX_FIELDS][LEGACY_FIELD_LEN];
+    split_fields_legacy(line, fields, NMEA_MAX_FIELDS);
+}
+
+static double bench_lines(void (*fn)(char *), char *const *set, int n, int repeat) {
+    double t0 = cpu_seconds();
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < n; i++) fn(set[i]);
+    }
+    double elapsed = cpu_seconds() - t0;
+    return (double)n * repeat / elapsed;
+}
+
+// 기준값: 예전 방식(atof + double 도분 변환)을 1e-7 도로 반올림
+static double legacy_to_decimal(double nmea_val) {
+    int degrees = (int)(nmea_val / 100);
+    double minutes = nmea_val - (degrees * 100);
+    return degrees + (minutes / 60.0);
+}
+
+static int32_t to_e7(double deg) {
+    return (int32_t)llround(deg * GPS_COORD_SCALE);
+}
+
+// 새 파서와 예전 파서의 마지막 결과 비교. 다른 필드는 값과 함께 (RMC 가 없었으면 시각은 둘 다 없으므로 빼고)
+static void print_fix_diff(bool has_time) {
+    char diff[256] = "";
+    size_t n = 0;
+#define FIELD_DIFF(name, mine, old) \
+    if ((long)(mine) != (long)(old)) n += snprintf(diff + n, sizeof(diff) - n, " %s %ld/%ld", name, (long)(mine), (long)(old))
+    FIELD_DIFF("lat", my_gps.latitude, to_e7(legacy_gps.latitude));
+    FIELD_DIFF("lon", my_gps.longitude, to_e7(legacy_gps.longitude));
+    if (has_time) {
+        FIELD_DIFF("hour", (my_gps.utc_ms / 3600000 + 9) % 24, legacy_gps.hour);
+        FIELD_DIFF("min", my_gps.utc_ms / 60000 % 60, legacy_gps.minute);
+        FIELD_DIFF("sec", my_gps.utc_ms / 1000 % 60, legacy_gps.second);
+    }
+    FIELD_DIFF("sats", my_gps.sat_count, legacy_gps.sat_count);
+    FIELD_DIFF("quality", my_gps.fix_quality, legacy_gps.fix_quality);
+    // 예전 파서는 SNR 최대를 지우지 않고 계속 키움 (새 파서는 마지막 GSV 묶음 기준)
+    FIELD_DIFF("max_snr", my_gps.max_snr, legacy_gps.max_snr);
+#undef FIELD_DIFF
+    if (n == 0) printf("same fix           : yes\n");
+    else printf("same fix           : NO (new/legacy:%s)\n", diff);
+}
+
+// --- [4) 좌표 변환: 정수 vs double] ---
+// 녹화 파일의 좌표 대신, 소수 4~5자리 "dddmm.mmmmm" 값을 골고루 만들어서 비교
+#define COORD_SAMPLES 200000
+
+static void bench_coord(int repeat) {
+    static char text[COORD_SAMPLES][16];
+    static int len[COORD_SAMPLES];
+    unsigned seed = 12345;
+
+    for (int i = 0; i < COORD_SAMPLES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int deg = (seed >> 8) % 180;
+        seed = seed * 1103515245u + 12345u;
+        int min = (seed >> 8) % 60;
+        seed = seed * 1103515245u + 12345u;
+        if (i % 2) len[i] = snprintf(text[i], sizeof(text[i]), "%d%02d.%04u", deg, min, (seed >> 8) % 10000);
+        else len[i] = snprintf(text[i], sizeof(text[i]), "%d%02d.%05u", deg, min, (seed >> 8) % 100000);
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < COORD_SAMPLES; i++) {
+        int32_t v = 0;
+        nmea_parse_coord(text[i], len[i], &v);
+        if (v != to_e7(legacy_to_decimal(atof(text[i])))) {
+            if (mismatches++ < 5) printf("mismatch    : %s -> %ld\n", text[i], (long)v);
+        }
+    }
+
+    volatile int64_t sink = 0;
+    double t0 = cpu_seconds();
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < COORD_SAMPLES; i++) sink += (int64_t)legacy_to_decimal(atof(text[i]));
+    }
+    double t_double = cpu_seconds() - t0;
+
+    t0 = cpu_seconds();
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < COORD_SAMPLES; i++) {
+            int32_t v;
+            nmea_parse_coord(text[i], len[i], &v);
+            sink += v;
+        }
+    }
+    double t_int = cpu_seconds() - t0;
+
+    double n = (double)COORD_SAMPLES * repeat;
+    printf("[coord]\n");
+    printf("atof+double : %.1f ns/value\n", t_double * 1e9 / n);
+    printf("fixed point : %.1f ns/value (x%.2f)\n", t_int * 1e9 / n, t_double / t_int);
+    printf("bit-exact   : %s (%d/%d mismatches)\n", mismatches ? "NO" : "yes", mismatches, COORD_SAMPLES);
+}
+
+// --- [5) NMEA vs UBX NAV-PVT] ---
+#define MAX_EPOCHS 20000
+
+typedef struct {
+    char nmea[512];         // 이 측위의 RMC + GGA + GSA 원문
+    size_t nmea_len;
+    uint8_t ubx[UBX_NAV_PVT_LEN + 8];
+    size_t ubx_len;
+    GPS_Data expect;        // NMEA 로 파싱한 결과
+} epoch_t;
+
+static void put_u16(uint8_t *p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static void put_u32(uint8_t *p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = v >> (8 * i); }
+
+// GPS_Data -> 같은 내용의 NAV-PVT 프레임
+static size_t build_nav_pvt(const GPS_Data *g, uint8_t *out, size_t size) {
+    uint8_t p[UBX_NAV_PVT_LEN] = {0};
+    uint32_t sec = g->utc_ms / 1000;
+    put_u16(p + 4, g->year);
+    p[6] = g->month;
+    p[7] = g->day;
+    p[8] = sec / 3600;
+    p[9] = sec / 60 % 60;
+    p[10] = sec % 60;
+    p[11] = 0x03;
+    put_u32(p + 16, (g->utc_ms % 1000) * 1000000);
+    p[20] = g->fix_type;
+    p[21] = g->fix_quality > 0 ? 0x01 : 0x00;
+    p[23] = g->sat_count;
+    put_u32(p + 24, g->longitude);
+    put_u32(p + 28, g->latitude);
+    put_u32(p + 36, g->altitude_cm * 10);
+    put_u32(p + 60, g->speed_mmps);
+    put_u32(p + 64, g->course_cdeg * 1000);
+    put_u16(p + 76, g->pdop_x100);
+    return ubx_build(out, size, UBX_CLASS_NAV, UBX_NAV_PVT, p, sizeof(p));
+}
+
+static void bench_ubx(int repeat) {
+    static epoch_t epochs[MAX_EPOCHS];
+    int n = 0;
+
+    // 녹화 파일을 측위 단위로 묶음 (RMC 가 새 측위의 시작)
+    memset(&my_gps, 0, sizeof(my_gps));
+    for (int i = 0; i < num_lines && n < MAX_EPOCHS; i++) {
+        const char *id = lines[i] + 3;
+        bool is_fix = strncmp(id, "RMC", 3) == 0 || strncmp(id, "GGA", 3) == 0 || strncmp(id, "GSA", 3) == 0;
+        if (!is_fix) continue;
+        if (strncmp(id, "RMC", 3) == 0) n++;
+        if (n == 0) continue;
+
+        epoch_t *e = &epochs[n - 1];
+        size_t len = strlen(lines[i]);
+        if (e->nmea_len + len + 2 >= sizeof(e->nmea)) continue;
+        memcpy(e->nmea + e->nmea_len, lines[i], len);
+        memcpy(e->nmea + e->nmea_len + len, "\r\n", 2);
+        e->nmea_len += len + 2;
+        parse_nmea(lines[i]);
+        e->expect = my_gps;
+    }
+    for (int i = 0; i < n; i++) {
+        epochs[i].ubx_len = build_nav_pvt(&epochs[i].expect, epochs[i].ubx, sizeof(epochs[i].ubx));
+    }
+
+    nmea_framer_t framer;
+    nmea_framer_init(&framer, on_line, NULL);
+    double t0 = cpu_seconds();
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < n; i++) nmea_framer_feed(&framer, epochs[i].nmea, epochs[i].nmea_len);
+    }
+    double t_nmea = cpu_seconds() - t0;
+
+    ubx_decoder_t dec;
+    ubx_decoder_init(&dec);
+    t0 = cpu_seconds();
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < n; i++) {
+            for (size_t k = 0; k < epochs[i].ubx_len; k++) {
+                if (ubx_decoder_push(&dec, epochs[i].ubx[k])) ubx_apply_frame(&dec);
+            }
+        }
+    }
+    double t_ubx = cpu_seconds() - t0;
+
+    // 결과 확인: 각 측위를 NAV-PVT 로 넣었을 때 NMEA 결과와 같은지
+    int mismatches = 0;
+    for (int i = 0; i < n; i++) {
+        for (size_t k = 0; k < epochs[i].ubx_len; k++) {
+            if (ubx_decoder_push(&dec, epochs[i].ubx[k])) ubx_apply_frame(&dec);
+        }
+        const GPS_Data *e = &epochs[i].expect;
+        if (my_gps.latitude != e->latitude || my_gps.longitude != e->longitude ||
+            my_gps.utc_ms != e->utc_ms || my_gps.sat_count != e->sat_count ||
+            my_gps.altitude_cm != e->altitude_cm || my_gps.fix_type != e->fix_type) mismatches++;
+    }
+
+    double fixes = (double)n * repeat;
+    printf("[ubx]\n");
+    printf("epochs      : %d (NMEA %.0f bytes/fix, NAV-PVT %d bytes/fix)\n",
+           n, n ? (double)epochs[0].nmea_len : 0.0, UBX_NAV_PVT_LEN + 8);
+    printf("nmea        : %.1f ns/fix\n", t_nmea * 1e9 / fixes);
+    printf("nav-pvt     : %.1f ns/fix (x%.2f)\n", t_ubx * 1e9 / fixes, t_nmea / t_ubx);
+    printf("same fix    : %s (%d/%d mismatches)\n", mismatches ? "NO" : "yes", mismatches, n);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file.nmea> [chunk_bytes] [repeat]\n", argv[0]);
+        return 1;
+    }
+    size_t chunk = argc > 2 ? (size_t)atoi(argv[2]) : 120;
+    int repeat = argc > 3 ? atoi(argv[3]) : 200;
+    if (chunk == 0) chunk = 1;
+
+    size_t size;
+    char *data = load_file(argv[1], &size);
+    if (data == NULL) {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    bench_ingest(argv[1], data, size, chunk, repeat);
+
+    nmea_framer_t framer;
+    nmea_framer_init(&framer, collect_line, NULL);
+    for (size_t off = 0; off < size; off += chunk) {
+        size_t n = size - off < chunk ? size - off : chunk;
+        nmea_framer_feed(&framer, data + off, n);
+    }
+
+    printf("\n[framing]\n");
+    printf("accepted    : %u\n", (unsigned)framer.stats.accepted);
+    printf("rejected    : %u\n", (unsigned)framer.stats.rejected);
+    printf("overflowed  : %u\n\n", (unsigned)framer.stats.overflowed);
+
+    // 필드 나누기: 모든 줄, 모든 필드
+    double split_old_rate = bench_lines(split_old, lines, num_lines, repeat);
+    double split_new_rate = bench_lines(split_new, lines, num_lines, repeat);
+    printf("[split] all fields of every line (%d lines)\n", num_lines);
+    printf("get_token x fields : %.0f sentences/s (rescan + copy per field)\n", split_old_rate);
+    printf("nmea_split_fields  : %.0f sentences/s (x%.2f, one pass, offsets only)\n", split_new_rate,
+           split_new_rate / split_old_rate);
+
+    // 문장 해석: 예전 파서가 처리하는 줄만, 같은 줄로
+    static char *gp_lines[MAX_LINES];
+    int num_gp = 0;
+    bool has_rmc = false;
+    for (int i = 0; i < num_lines; i++) {
+        if (strncmp(lines[i], "$GPRMC", 6) == 0) has_rmc = true;
+        if (strncmp(lines[i], "$GPRMC", 6) == 0 || strncmp(lines[i], "$GPGGA", 6) == 0 ||
+            strncmp(lines[i], "$GPGSV", 6) == 0) {
+            gp_lines[num_gp++] = lines[i];
+        }
+    }
+    printf("\n[parse] $GPRMC/$GPGGA/$GPGSV lines only (%d lines)\n", num_gp);
+    if (num_gp > 0) {
+        memset(&my_gps, 0, sizeof(my_gps));
+        memset(&legacy_gps, 0, sizeof(legacy_gps));
+        double old_rate = bench_lines(parse_nmea_legacy, gp_lines, num_gp, repeat);
+        double new_rate = bench_lines(parse_nmea_new, gp_lines, num_gp, repeat);
+        printf("legacy parse_nmea  : %.0f sentences/s (time, lat/lon, quality, sats, max SNR)\n", old_rate);
+        printf("parse_nmea         : %.0f sentences/s (x%.2f, also speed, course, altitude, satellite table)\n",
+               new_rate, new_rate / old_rate);
+        print_fix_diff(has_rmc);
+    } else {
+        printf("(none: the legacy parser only knows $GP talkers)\n");
+    }
+    printf("parse_nmea, all    : %.0f sentences/s (every line, all talkers; no legacy equivalent)\n",
+           bench_lines(parse_nmea_new, lines, num_lines, repeat));
+
+    printf("\n");
+    bench_coord(repeat / 20 > 0 ? repeat / 20 : 1);
+    printf("\n");
+    bench_ubx(repeat);
+
+    for (int i = 0; i < num_lines; i++) free(lines[i]);
+    free(data);
+    return 0;
+}
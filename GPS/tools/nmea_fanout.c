@@ -0,0 +1,251 @@
+// --- [NMEA TCP 서버 시험 (PC 용)] ---
+// main/nmea_ring.c + main/nmea_server.c 를 PC 에서 그대로 돌려 봅니다.
+//  - 쓰는 스레드: .nmea 파일의 문장을 반복해서 링에 넣음 (UART 수신 태스크 역할). put 한 번에 걸린 시간을 잼
+//  - 서버 스레드: nmea_server_poll() 반복 (ESP32 의 서버 태스크 역할)
+//  - 빠른 클라이언트 3개: 모든 문장을 빠짐없이, 순서대로, 체크섬이 맞게 받는지 확인
+//  - 느린 클라이언트 1개: 수신 버퍼를 작게 잡고 조금씩만 읽음 -> 건너뛰거나 끊겨야 하고,
+//    그동안 쓰는 쪽과 빠른 클라이언트는 전혀 느려지지 않아야 함
+// -s 를 주면 시험 없이 파일을 실제 속도(약 10Hz)로 반복해서 내보내는 서버만 띄움 (nc localhost 10110 로 확인).
+//
+// 빌드 & 실행 (GPS/tools 폴더에서):
+//   gcc -O2 -I../main -o nmea_fanout nmea_fanout.c ../main/nmea_ring.c ../main/nmea_server.c -lpthread
+//   ./nmea_fanout [-p port] [-n repeat] [-r bytes/s] sample_gnss.nmea
+//   ./nmea_fanout -s [-p port] sample_gnss.nmea
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include "nmea_ring.h"
+#include "nmea_server.h"
+
+#define RING_SIZE      16384 // ESP32 와 같은 크기
+#define FAST_CLIENTS   3
+#define SLOW_RCVBUF    2048
+#define SLOW_READ      64    // 느린 클라이언트가 한 번에 읽는 양
+#define SLOW_PERIOD_MS 20
+
+static char **lines;
+static size_t *line_lens;
+static int line_count;
+
+static nmea_ring_t ring;
+static uint8_t ring_buf[RING_SIZE];
+static nmea_server_t server;
+static atomic_int server_stop;
+static uint16_t port = NMEA_SERVER_PORT;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void sleep_ms(int ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static bool load_lines(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return false;
+    char buf[512];
+    int cap = 0;
+    while (fgets(buf, sizeof(buf), f)) {
+        size_t len = strcspn(buf, "\r\n");
+        if (len == 0 || buf[0] != '$') continue;
+        if (line_count == cap) {
+            cap = cap ? cap * 2 : 256;
+            lines = realloc(lines, cap * sizeof(*lines));
+            line_lens = realloc(line_lens, cap * sizeof(*line_lens));
+        }
+        lines[line_count] = strndup(buf, len);
+        line_lens[line_count] = len;
+        line_count++;
+    }
+    fclose(f);
+    return line_count > 0;
+}
+
+static bool checksum_ok(const char *line, size_t len) {
+    if (len < 4 || line[0] != '$' || line[len - 3] != '*') return false;
+    unsigned cs = 0;
+    for (size_t i = 1; i < len - 3; i++) cs ^= (unsigned char)line[i];
+    return strtoul(line + len - 2, NULL, 16) == cs;
+}
+
+static void *server_thread(void *arg) {
+    while (!atomic_load(&server_stop)) nmea_server_poll(&server, 5);
+    return NULL;
+}
+
+static int connect_client(int rcvbuf) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    // 수신 버퍼는 connect 전에 정해야 TCP 윈도에 반영됨
+    if (rcvbuf > 0) setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port) };
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+typedef struct {
+    int fd;
+    int slow;
+    long expected;      // 빠른 클라이언트: 받아야 할 문장 수
+    // 결과
+    long received;      // 받은 줄
+    long bad_checksum;  // 체크섬이 틀린 줄 (건너뛸 때 잘린 줄)
+    long out_of_order;  // 파일 순서와 다른 줄
+    int closed_by_server;
+} client_t;
+
+// 받은 바이트를 줄로 잘라 검사 (빠른 클라이언트는 파일 순서와 정확히 같아야 함)
+static void *client_thread(void *arg) {
+    client_t *c = arg;
+    char buf[4096], line[512];
+    size_t line_len = 0;
+    long next = 0;
+    for (;;) {
+        ssize_t n = recv(c->fd, buf, c->slow ? SLOW_READ : sizeof(buf), 0);
+        if (n <= 0) {
+            c->closed_by_server = 1;
+            break;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            char ch = buf[i];
+            if (ch == '\r') continue;
+            if (ch != '\n') {
+                if (line_len < sizeof(line) - 1) line[line_len++] = ch;
+                continue;
+            }
+            line[line_len] = '\0';
+            c->received++;
+            if (!checksum_ok(line, line_len)) {
+                c->bad_checksum++;
+            } else if (!c->slow) {
+                int idx = next % line_count;
+                if (line_len != line_lens[idx] || memcmp(line, lines[idx], line_len) != 0) c->out_of_order++;
+                next++;
+            }
+            line_len = 0;
+        }
+        if (!c->slow && c->received >= c->expected) break;
+        if (c->slow) sleep_ms(SLOW_PERIOD_MS);
+    }
+    return NULL;
+}
+
+static int run_server_only(void) {
+    printf("port %u 에서 대기 중 (nc localhost %u). 문장 %d개를 10Hz 로 반복\n", port, port, line_count);
+    pthread_t th;
+    pthread_create(&th, NULL, server_thread, NULL);
+    // 파일에 RMC 가 나올 때마다 100 ms 쉬어서 대략 실제 속도로
+    for (int i = 0;; i = (i + 1) % line_count) {
+        nmea_ring_put_line(&ring, lines[i], line_lens[i]);
+        if (strncmp(lines[i] + 3, "RMC", 3) == 0) sleep_ms(100);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int repeat = 50, serve_only = 0;
+    long rate = 200000; // 바이트/초 (115200 baud UART 의 약 17배)
+    int opt;
+    while ((opt = getopt(argc, argv, "p:n:r:s")) != -1) {
+        switch (opt) {
+            case 'p': port = (uint16_t)atoi(optarg); break;
+            case 'n': repeat = atoi(optarg); break;
+            case 'r': rate = atol(optarg); break;
+            case 's': serve_only = 1; break;
+            default: optind = argc + 1; break;
+        }
+    }
+    if (optind != argc - 1 || !load_lines(argv[optind])) {
+        fprintf(stderr, "usage: %s [-s] [-p port] [-n repeat] [-r bytes/s] file.nmea\n", argv[0]);
+        return 2;
+    }
+    nmea_ring_init(&ring, ring_buf, sizeof(ring_buf));
+    if (!nmea_server_open(&server, &ring, port)) {
+        fprintf(stderr, "port %u: %s\n", port, strerror(errno));
+        return 1;
+    }
+    if (serve_only) return run_server_only();
+
+    pthread_t srv;
+    pthread_create(&srv, NULL, server_thread, NULL);
+
+    long total = (long)line_count * repeat;
+    client_t clients[FAST_CLIENTS + 1];
+    pthread_t threads[FAST_CLIENTS + 1];
+    for (int i = 0; i <= FAST_CLIENTS; i++) {
+        client_t *c = &clients[i];
+        memset(c, 0, sizeof(*c));
+        c->slow = i == FAST_CLIENTS;
+        c->expected = total;
+        c->fd = connect_client(c->slow ? SLOW_RCVBUF : 0);
+        if (c->fd < 0) {
+            fprintf(stderr, "connect: %s\n", strerror(errno));
+            return 1;
+        }
+    }
+    // 모두 받아들여진 다음 쓰기 시작 (그래야 모든 클라이언트가 첫 문장부터 받음)
+    while (server.stats.accepted < FAST_CLIENTS + 1) sleep_ms(1);
+    for (int i = 0; i <= FAST_CLIENTS; i++) pthread_create(&threads[i], NULL, client_thread, &clients[i]);
+
+    // 쓰는 쪽: rate 바이트/초 로 맞춰 가며 넣음. put 자체의 시간만 잼
+    double put_total = 0, put_max = 0, start = now_s();
+    long bytes = 0;
+    for (long k = 0; k < total; k++) {
+        int i = k % line_count;
+        double t0 = now_s();
+        nmea_ring_put_line(&ring, lines[i], line_lens[i]);
+        double dt = now_s() - t0;
+        put_total += dt;
+        if (dt > put_max) put_max = dt;
+        bytes += line_lens[i] + 2;
+        double ahead = (double)bytes / rate - (now_s() - start);
+        if (ahead > 0.001) sleep_ms((int)(ahead * 1000));
+    }
+    double write_s = now_s() - start;
+
+    // 빠른 클라이언트가 다 받을 때까지 (최대 5초)
+    for (int i = 0; i < FAST_CLIENTS; i++) {
+        for (int w = 0; w < 500 && clients[i].received < total; w++) sleep_ms(10);
+    }
+    atomic_store(&server_stop, 1);
+    pthread_join(srv, NULL);
+    nmea_server_stats_t st = server.stats;
+    nmea_server_close(&server);
+    for (int i = 0; i <= FAST_CLIENTS; i++) {
+        shutdown(clients[i].fd, SHUT_RDWR); // 아직 읽고 있는 스레드를 깨움
+        pthread_join(threads[i], NULL);
+        close(clients[i].fd);
+    }
+
+    printf("문장 %d개 x %d회 = %ld줄, %ld 바이트를 %.2f 초 동안 (%.0f 바이트/초)\n",
+           line_count, repeat, total, bytes, write_s, bytes / write_s);
+    printf("쓰는 쪽 put: 평균 %.0f ns, 최대 %.1f us (클라이언트 수/속도와 무관해야 함)\n",
+           put_total / total * 1e9, put_max * 1e6);
+    int ok = 1;
+    for (int i = 0; i <= FAST_CLIENTS; i++) {
+        const client_t *c = &clients[i];
+        printf("%s #%d: %ld줄 받음, 체크섬 오류 %ld, 순서 오류 %ld\n",
+               c->slow ? "느림" : "빠름", i, c->received, c->bad_checksum, c->out_of_order);
+        if (!c->slow && (c->received != total || c->bad_checksum || c->out_of_order)) ok = 0;
+    }
+    printf("서버: 접속 %u, 건너뜀 %u, 느려서 끊음 %u, 보낸 바이트 %llu\n",
+           st.accepted, st.skips, st.dropped, (unsigned long long)st.bytes_sent);
+    if (st.skips == 0) printf("(느린 클라이언트가 한 번도 뒤처지지 않음: -r 을 올려 보세요)\n");
+    printf("%s\n", ok ? "빠른 클라이언트 모두 빠짐없이 수신" : "빠른 클라이언트 수신 오류!");
+    return ok ? 0 : 1;
+}
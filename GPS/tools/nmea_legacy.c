@@ -0,0 +1,98 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nmea_legacy.h"
+
+legacy_gps_t legacy_gps;
+
+// --- [도분 -> 도 변환 함수] ---
+static double convert_nmea_to_decimal(double nmea_val) {
+    int degrees = (int)(nmea_val / 100);
+    double minutes = nmea_val - (degrees * 100);
+    return degrees + (minutes / 60.0);
+}
+
+// --- [토큰 추출 함수] ---
+// 콤마(,) 사이의 빈 값(Empty Field)도 정확히 처리하기 위한 함수
+static char* get_token(char *source, int token_index, char *dest, int dest_size) {
+    int comma_count = 0;
+    int i = 0, j = 0;
+    
+    // 해당 인덱스의 콤마 위치 찾기
+    while (comma_count < token_index && source[i] != '\0') {
+        if (source[i] == ',') comma_count++;
+        i++;
+    }
+
+    // 데이터 복사
+    while (source[i] != ',' && source[i] != '*' && source[i] != '\0' && j < dest_size - 1) {
+        dest[j++] = source[i++];
+    }
+    dest[j] = '\0';
+    return dest;
+}
+
+// --- [필드 전부 꺼내기 (나누기 비교용)] ---
+int split_fields_legacy(char *nmea_sentence, char dest[][LEGACY_FIELD_LEN], int max) {
+    int n = 1;
+    for (const char *p = nmea_sentence; *p != '\0' && *p != '*'; p++) {
+        if (*p == ',') n++;
+    }
+    if (n > max) n = max;
+    for (int i = 0; i < n; i++) get_token(nmea_sentence, i, dest[i], LEGACY_FIELD_LEN);
+    return n;
+}
+
+// --- [파싱 함수] ---
+void parse_nmea_legacy(char *nmea_sentence) {
+    char buffer[32]; // 임시 저장 공간
+
+    // 1. $GPRMC: 시간, 위도, 경도
+    if (strstr(nmea_sentence, "$GPRMC")) {
+        // 시간 (Index 1)
+        get_token(nmea_sentence, 1, buffer, sizeof(buffer));
+        if (strlen(buffer) > 0) {
+            float time_raw = atof(buffer);
+            legacy_gps.hour = (int)(time_raw / 10000);
+            legacy_gps.minute = (int)((time_raw - (legacy_gps.hour * 10000)) / 100);
+            legacy_gps.second = (int)(time_raw - (legacy_gps.hour * 10000) - (legacy_gps.minute * 100));
+            legacy_gps.hour = (legacy_gps.hour + 9) % 24; // 한국 시간
+        }
+
+        // 위도 (Index 3)
+        get_token(nmea_sentence, 3, buffer, sizeof(buffer));
+        if (strlen(buffer) > 0) legacy_gps.latitude = convert_nmea_to_decimal(atof(buffer));
+
+        // 경도 (Index 5)
+        get_token(nmea_sentence, 5, buffer, sizeof(buffer));
+        if (strlen(buffer) > 0) legacy_gps.longitude = convert_nmea_to_decimal(atof(buffer));
+    }
+    
+    // 2. $GPGGA: 위성 개수, 고정 품질
+    else if (strstr(nmea_sentence, "$GPGGA")) {
+        // Fix Quality (Index 6): 0=Invalid, 1=GPS fix, 2=DGPS fix
+        get_token(nmea_sentence, 6, buffer, sizeof(buffer));
+        legacy_gps.fix_quality = atoi(buffer);
+
+        // 위성 개수 (Index 7) - 이게 중요!
+        get_token(nmea_sentence, 7, buffer, sizeof(buffer));
+        legacy_gps.sat_count = atoi(buffer);
+    }
+
+    // 3. $GPGSV: 신호 세기 (SNR)
+    else if (strstr(nmea_sentence, "$GPGSV")) {
+        // GSV 문장은 위성 4개씩 정보를 담고 있음.
+        // SNR 위치: 7, 11, 15, 19 번째 인덱스
+        int snr_indices[] = {7, 11, 15, 19};
+        
+        // GSV 메시지가 여러 줄로 오므로, 매번 0으로 초기화하지 않고 최댓값을 갱신함
+        // (단, 1번 메시지가 올 때만 초기화하는 로직을 추가하면 더 정확하지만, 여기선 간단히 유지)
+        
+        for (int k = 0; k < 4; k++) {
+            get_token(nmea_sentence, snr_indices[k], buffer, sizeof(buffer));
+            int snr = atoi(buffer);
+            if (snr > legacy_gps.max_snr) {
+                legacy_gps.max_snr = snr; // 가장 센 신호 기록
+            }
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// --- [예전 파서 (비교 기준용)] ---
+// get_token() 으로 필드마다 문장을 처음부터 다시 훑던 원래 parse_nmea 를 그대로 보관.
+// 벤치마크에서 속도와 결과를 비교할 때만 사용합니다 (필드 나누기만 따로 비교할 수 있게 split_fields_legacy 도).
+typedef struct {
+    double latitude;
+    double longitude;
+    int hour, minute, second;
+    int sat_count;
+    int max_snr;
+    int fix_quality;
+} legacy_gps_t;
+
+extern legacy_gps_t legacy_gps;
+
+void parse_nmea_legacy(char *nmea_sentence);
+
+// 예전 방식으로 필드 전부 꺼내기: 필드마다 get_token (문장을 처음부터 훑고 dest 에 복사). 꺼낸 필드 수
+#define LEGACY_FIELD_LEN 32
+int split_fields_legacy(char *nmea_sentence, char dest[][LEGACY_FIELD_LEN], int max);
@@ -0,0 +1,292 @@
+// --- [NMEA 녹화 파일 재생기 (PC 용)] ---
+// 안테나 없이 녹화해 둔 NMEA 로그를 main.c 와 같은 경로(프레이머 -> parse_nmea -> 스냅샷 발행)로
+// 흘려 보내고 아래 결과를 냅니다.
+//  - 처리 속도: sentences/s, bytes/s
+//  - 한 문장당 parse_nmea 지연 분포 (p50 / p90 / p99 / p99.9 / 최대)
+//  - 측위(fix) 순서: 에포크(UTC 시각)마다 한 줄씩, CSV 로 저장 가능
+//  - 차이 검사: 저장해 둔 fix CSV 와 한 줄씩 비교해서 첫 번째 불일치 위치를 알려줌. 거기서 멈추지 않고
+//    끝까지 재생해서 (처리 속도/지연도 그대로 나옴) 다른 fix 수를 마지막에 출력하고 종료 코드 1
+//    (파서를 고치기 전에 -o 로 기준 파일을 만들고, 고친 뒤 -d 로 비교 -> 결과가 비트 단위로 같은지 확인)
+//
+// 빌드 & 실행 (GPS/tools 폴더에서):
+//   gcc -O2 -I../main -o nmea_replay nmea_replay.c ../main/nmea_framer.c ../main/nmea_parser.c ../main/gps_snapshot.c
+//   ./nmea_replay sample.nmea                       (최대 속도로 재생)
+//   ./nmea_replay -s 10 sample.nmea                 (녹화 시간의 10배 속도로 재생, 1 = 실시간)
+//   ./nmea_replay -o before.csv sample_gnss.nmea    (fix 순서 저장)
+//   ./nmea_replay -d before.csv sample_gnss.nmea    (저장한 결과와 비교, 다르면 종료 코드 1)
+//
+// 옵션:
+//   -s speed   재생 배속 (0 = 기다리지 않음, 기본값)
+//   -c bytes   UART 이벤트 1번에 읽히는 양 흉내 (기본 120)
+//   -n repeat  파일 반복 횟수 (처리 속도를 안정적으로 재고 싶을 때. fix 순서는 첫 번째만 기록)
+//   -o file    fix 순서를 CSV 로 저장
+//   -d file    fix 순서를 CSV 파일과 비교
+//   -v         fix 를 화면에도 출력
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "nmea_framer.h"
+#include "nmea_parser.h"
+#include "gps_snapshot.h"
+
+#define FIX_LINE_MAX 160
+#define MS_PER_DAY   86400000u
+
+static struct {
+    double speed;
+    size_t chunk;
+    int repeat;
+    const char *out_path;
+    const char *diff_path;
+    int verbose;
+} opt = { 0.0, 120, 1, NULL, NULL, 0 };
+
+// 문장별 지연 (ns)
+static uint32_t *lat_ns;
+static size_t lat_count, lat_cap;
+
+// fix 순서 기록/비교
+static FILE *out_file, *diff_file;
+static long fix_count, diff_line, diff_errors;
+static int recording = 1;    // 반복 재생 중 두 번째부터는 fix 를 기록하지 않음
+
+static GPS_Data pending;      // 아직 끝나지 않은 에포크의 마지막 상태
+static int has_pending;
+
+// 재생 속도 조절
+static uint64_t log_elapsed_ms; // 녹화 기준 경과 시간
+static uint32_t last_epoch_ms;
+static int has_epoch;
+static uint64_t wall_start_ns;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static char *load_file(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc(n > 0 ? n : 1);
+    *size = fread(data, 1, n, f);
+    fclose(f);
+    return data;
+}
+
+// --- [fix 한 줄 만들기] ---
+// 좌표/시간이 모두 정수라 printf 결과가 같으면 값도 비트 단위로 같음
+static void format_fix(char *out, size_t size, const GPS_Data *g) {
+    snprintf(out, size, "%lu,%04u-%02u-%02u,%ld,%ld,%ld,%lu,%u,%d,%d,%d,%d,%u,%u,%u,%d",
+             (unsigned long)g->utc_ms, g->year, g->month, g->day,
+             (long)g->latitude, (long)g->longitude, (long)g->altitude_cm,
+             (unsigned long)g->speed_mmps, g->course_cdeg,
+             g->valid, g->fix_quality, g->fix_type, g->sat_count,
+             g->hdop_x100, g->pdop_x100, g->vdop_x100, g->max_snr);
+}
+
+#define FIX_CSV_HEADER "utc_ms,date,lat_e7,lon_e7,alt_cm,speed_mmps,course_cdeg," \
+                       "valid,quality,fix_type,sats,hdop_x100,pdop_x100,vdop_x100,max_snr"
+
+static void emit_fix(const GPS_Data *g) {
+    char line[FIX_LINE_MAX];
+    format_fix(line, sizeof(line), g);
+    fix_count++;
+
+    if (opt.verbose) printf("fix %6ld  %s\n", fix_count, line);
+    if (out_file) fprintf(out_file, "%s\n", line);
+
+    if (diff_file) {
+        char ref[FIX_LINE_MAX];
+        diff_line++;
+        if (fgets(ref, sizeof(ref), diff_file) == NULL) {
+            if (diff_errors++ == 0) printf("diff: fix %ld 이후 기준 파일이 끝남\n", fix_count);
+            return;
+        }
+        ref[strcspn(ref, "\r\n")] = '\0';
+        if (strcmp(ref, line) != 0 && diff_errors++ == 0) {
+            printf("diff: fix %ld 부터 다름 (기준 파일 %ld번째 줄)\n", fix_count, diff_line);
+            printf("  기준: %s\n", ref);
+            printf("  지금: %s\n", line);
+        }
+    }
+}
+
+// --- [재생 속도 맞추기] ---
+// 새 에포크가 시작될 때마다, 녹화 기준 경과 시간 / 배속 만큼 실제 시간이 지날 때까지 잠듦
+static void pace(uint32_t utc_ms) {
+    if (has_epoch) log_elapsed_ms += (utc_ms + MS_PER_DAY - last_epoch_ms) % MS_PER_DAY; // 자정 넘김 처리
+    last_epoch_ms = utc_ms;
+    has_epoch = 1;
+    if (opt.speed <= 0) return;
+
+    uint64_t target_ns = wall_start_ns + (uint64_t)(log_elapsed_ms * 1e6 / opt.speed);
+    uint64_t now = now_ns();
+    if (target_ns > now) usleep((useconds_t)((target_ns - now) / 1000));
+}
+
+// --- [main.c 의 on_gps_update 와 같은 역할] ---
+// 스냅샷으로 발행하고, UTC 시각이 바뀌면 직전 에포크를 fix 한 건으로 확정
+static void on_gps_update(uint32_t updated) {
+    if (updated == 0) return;
+    gps_snapshot_publish(&my_gps);
+    if (updated & GPS_UPDATED_SKY) gps_snapshot_publish_sats(&my_sats);
+    if (!(updated & GPS_UPDATED_FIX)) return;
+
+    GPS_Data g;
+    gps_snapshot_read(&g);
+    if (!has_pending || !has_epoch || g.utc_ms != pending.utc_ms) {
+        if (has_pending && has_epoch && recording) emit_fix(&pending);
+        pace(g.utc_ms);
+    }
+    pending = g;
+    has_pending = 1;
+}
+
+static void on_line(char *line, size_t len, void *ctx) {
+    uint64_t t0 = now_ns();
+    uint32_t updated = parse_nmea(line);
+    uint64_t t1 = now_ns();
+
+    if (lat_count == lat_cap) {
+        lat_cap = lat_cap ? lat_cap * 2 : 4096;
+        lat_ns = realloc(lat_ns, lat_cap * sizeof(lat_ns[0]));
+    }
+    lat_ns[lat_count++] = (uint32_t)(t1 - t0);
+
+    on_gps_update(updated);
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t percentile(double p) {
+    size_t i = (size_t)(p / 100.0 * (lat_count - 1) + 0.5);
+    return lat_ns[i];
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-s speed] [-c chunk] [-n repeat] [-o fixes.csv] [-d ref.csv] [-v] <file.nmea>...\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    int c;
+    while ((c = getopt(argc, argv, "s:c:n:o:d:v")) != -1) {
+        switch (c) {
+            case 's': opt.speed = atof(optarg); break;
+            case 'c': opt.chunk = (size_t)atoi(optarg); break;
+            case 'n': opt.repeat = atoi(optarg); break;
+            case 'o': opt.out_path = optarg; break;
+            case 'd': opt.diff_path = optarg; break;
+            case 'v': opt.verbose = 1; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (opt.chunk == 0) opt.chunk = 1;
+    if (opt.repeat < 1) opt.repeat = 1;
+
+    if (opt.out_path) {
+        out_file = fopen(opt.out_path, "w");
+        if (out_file == NULL) {
+            fprintf(stderr, "cannot create %s\n", opt.out_path);
+            return 1;
+        }
+        fprintf(out_file, FIX_CSV_HEADER "\n");
+    }
+    if (opt.diff_path) {
+        char header[FIX_LINE_MAX];
+        diff_file = fopen(opt.diff_path, "r");
+        if (diff_file == NULL || fgets(header, sizeof(header), diff_file) == NULL) {
+            fprintf(stderr, "cannot read %s\n", opt.diff_path);
+            return 1;
+        }
+    }
+
+    nmea_framer_t framer;
+    nmea_framer_init(&framer, on_line, NULL);
+
+    size_t total_bytes = 0;
+    wall_start_ns = now_ns();
+    uint64_t t0 = wall_start_ns;
+
+    for (int r = 0; r < opt.repeat; r++) {
+        recording = r == 0;
+        for (int i = optind; i < argc; i++) {
+            size_t size;
+            char *data = load_file(argv[i], &size);
+            if (data == NULL) {
+                fprintf(stderr, "cannot open %s\n", argv[i]);
+                return 1;
+            }
+            for (size_t off = 0; off < size; off += opt.chunk) {
+                size_t n = size - off < opt.chunk ? size - off : opt.chunk;
+                nmea_framer_feed(&framer, data + off, n);
+            }
+            total_bytes += size;
+            free(data);
+        }
+        // 마지막 에포크 확정. 다음 반복은 시간이 처음으로 돌아가므로 에포크 기준도 새로 시작
+        if (recording && has_pending) emit_fix(&pending);
+        has_epoch = 0;
+    }
+
+    double elapsed = (now_ns() - t0) / 1e9;
+
+    printf("[replay]\n");
+    printf("files       : %d x %d\n", argc - optind, opt.repeat);
+    printf("speed       : %s\n", opt.speed > 0 ? "paced" : "max");
+    if (opt.speed > 0) printf("log time    : %.1f s (x%.1f)\n", log_elapsed_ms / 1e3, opt.speed);
+    printf("wall time   : %.3f s\n", elapsed);
+    printf("sentences   : %lu (rejected %lu, overflowed %lu)\n", (unsigned long)framer.stats.accepted,
+           (unsigned long)framer.stats.rejected, (unsigned long)framer.stats.overflowed);
+    if (opt.speed <= 0) {
+        printf("throughput  : %.0f sentences/s, %.1f MB/s\n", framer.stats.accepted / elapsed, total_bytes / elapsed / 1e6);
+    }
+
+    if (lat_count > 0) {
+        qsort(lat_ns, lat_count, sizeof(lat_ns[0]), cmp_u32);
+        printf("\n[parse_nmea latency, ns]\n");
+        printf("p50         : %lu\n", (unsigned long)percentile(50));
+        printf("p90         : %lu\n", (unsigned long)percentile(90));
+        printf("p99         : %lu\n", (unsigned long)percentile(99));
+        printf("p99.9       : %lu\n", (unsigned long)percentile(99.9));
+        printf("max         : %lu\n", (unsigned long)lat_ns[lat_count - 1]);
+    }
+
+    printf("\n[fixes]\n");
+    printf("epochs      : %ld\n", fix_count);
+    if (has_pending) {
+        char line[FIX_LINE_MAX];
+        format_fix(line, sizeof(line), &pending);
+        printf("last        : %s\n", line);
+    }
+
+    int status = 0;
+    if (diff_file) {
+        char extra[FIX_LINE_MAX];
+        if (diff_errors == 0 && fgets(extra, sizeof(extra), diff_file) != NULL) {
+            printf("diff: 기준 파일에 fix 가 더 있음 (%ld번째 이후)\n", fix_count);
+            diff_errors++;
+        }
+        if (diff_errors) printf("diff        : DIFFERENT (%ld of %ld fixes)\n", diff_errors, fix_count);
+        else printf("diff        : identical (%ld fixes compared)\n", fix_count);
+        status = diff_errors ? 1 : 0;
+        fclose(diff_file);
+    }
+    if (out_file) fclose(out_file);
+    free(lat_ns);
+    return status;
+}
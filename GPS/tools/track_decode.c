@@ -0,0 +1,217 @@
+// --- [트랙 기록 해독기 (PC 용)] ---
+// "track" 파티션 덤프를 읽어서 fix 를 시간 순서대로 CSV 또는 GPX 로 풉니다.
+// 페이지(4KB)마다 따로 해독하고 페이지 번호(seq) 순으로 정렬하므로 링이 한 바퀴 돌았어도 순서가 맞음.
+//
+// 파티션 덤프 (ESP-IDF 환경에서):
+//   parttool.py read_partition --partition-name track --output track.bin
+//
+// 빌드 & 실행 (GPS/tools 폴더에서):
+//   gcc -O2 -I../main -o track_decode track_decode.c ../main/track_codec.c ../main/nmea_framer.c ../main/nmea_parser.c
+//   ./track_decode track.bin > track.csv
+//   ./track_decode -g track.bin > track.gpx
+//
+// 하드웨어 없이 형식을 확인하려면 NMEA 녹화 파일을 장치와 같은 방식으로 인코딩할 수 있음
+// (fix 당 바이트 수를 출력하고, 다시 해독해서 원래 값과 같은지 확인):
+//   ./track_decode -e sample.nmea track.bin
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nmea_framer.h"
+#include "nmea_parser.h"
+#include "track_codec.h"
+
+#define GPX_SEGMENT_GAP_MS 10000 // 이보다 오래 끊기면 GPX 구간을 나눔
+
+static char *load_file(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc(n > 0 ? n : 1);
+    *size = fread(data, 1, n, f);
+    fclose(f);
+    return data;
+}
+
+static void format_e7(char *out, size_t size, int32_t e7) {
+    uint32_t abs_val = e7 < 0 ? -(uint32_t)e7 : (uint32_t)e7;
+    snprintf(out, size, "%s%lu.%07lu", e7 < 0 ? "-" : "",
+             (unsigned long)(abs_val / GPS_COORD_SCALE), (unsigned long)(abs_val % GPS_COORD_SCALE));
+}
+
+static void format_time(char *out, size_t size, uint64_t time_ms) {
+    uint16_t y;
+    uint8_t mo, d;
+    uint32_t ms;
+    track_time_to_utc(time_ms, &y, &mo, &d, &ms);
+    snprintf(out, size, "%04u-%02u-%02uT%02lu:%02lu:%02lu.%03luZ", y, mo, d,
+             (unsigned long)(ms / 3600000), (unsigned long)(ms / 60000 % 60),
+             (unsigned long)(ms / 1000 % 60), (unsigned long)(ms % 1000));
+}
+
+// --- [해독: 덤프 -> CSV/GPX] ---
+typedef struct {
+    uint32_t seq;
+    size_t offset;
+} page_ref_t;
+
+static int cmp_page(const void *a, const void *b) {
+    uint32_t x = ((const page_ref_t *)a)->seq, y = ((const page_ref_t *)b)->seq;
+    return x < y ? -1 : x > y;
+}
+
+static int decode_dump(const char *path, int gpx) {
+    size_t size;
+    uint8_t *data = (uint8_t *)load_file(path, &size);
+    if (data == NULL) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+
+    size_t max_pages = size / TRACK_PAGE_SIZE;
+    page_ref_t *pages = malloc((max_pages ? max_pages : 1) * sizeof(page_ref_t));
+    size_t num_pages = 0;
+    for (size_t i = 0; i < max_pages; i++) {
+        track_decoder_t dec;
+        uint32_t seq;
+        if (track_decoder_start(&dec, data + i * TRACK_PAGE_SIZE, TRACK_PAGE_SIZE, &seq)) {
+            pages[num_pages++] = (page_ref_t){ seq, i * TRACK_PAGE_SIZE };
+        }
+    }
+    qsort(pages, num_pages, sizeof(page_ref_t), cmp_page);
+
+    if (gpx) {
+        printf("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+        printf("<gpx version=\"1.1\" creator=\"track_decode\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n");
+        printf("<trk><trkseg>\n");
+    } else {
+        printf("time,lat,lon,alt_m,quality,sats,hdop\n");
+    }
+
+    long fixes = 0;
+    uint64_t last_time = 0;
+    for (size_t i = 0; i < num_pages; i++) {
+        track_decoder_t dec;
+        track_point_t pt;
+        track_decoder_start(&dec, data + pages[i].offset, TRACK_PAGE_SIZE, NULL);
+        while (track_decode_next(&dec, &pt)) {
+            char t[32], lat[16], lon[16];
+            format_time(t, sizeof(t), pt.time_ms);
+            format_e7(lat, sizeof(lat), pt.lat);
+            format_e7(lon, sizeof(lon), pt.lon);
+            if (gpx) {
+                if (fixes > 0 && pt.time_ms - last_time >= GPX_SEGMENT_GAP_MS) printf("</trkseg><trkseg>\n");
+                printf("<trkpt lat=\"%s\" lon=\"%s\"><ele>%.2f</ele><time>%s</time><sat>%u</sat><hdop>%.1f</hdop></trkpt>\n",
+                       lat, lon, pt.alt_cm / 100.0, t, pt.sats, pt.hdop_x10 / 10.0);
+            } else {
+                printf("%s,%s,%s,%.2f,%u,%u,%.1f\n", t, lat, lon, pt.alt_cm / 100.0, pt.quality, pt.sats,
+                       pt.hdop_x10 / 10.0);
+            }
+            last_time = pt.time_ms;
+            fixes++;
+        }
+    }
+
+    if (gpx) printf("</trkseg></trk>\n</gpx>\n");
+    fprintf(stderr, "%zu pages, %ld fixes\n", num_pages, fixes);
+    free(pages);
+    free(data);
+    return 0;
+}
+
+// --- [인코딩: NMEA 녹화 파일 -> 덤프 (track_log.c 와 같은 방식)] ---
+static FILE *enc_out;
+static track_encoder_t enc;
+static uint8_t page[TRACK_PAGE_SIZE];
+static uint32_t page_seq = 1;
+static track_point_t *points; // 해독 결과와 비교하려고 원본을 보관
+static size_t num_points, cap_points;
+static size_t record_bytes;
+static track_point_t pending;
+static int has_pending;
+
+static void write_page(void) {
+    fwrite(page, 1, TRACK_PAGE_SIZE, enc_out);
+}
+
+static void encode_point(const track_point_t *pt) {
+    size_t before = enc.len;
+    if (!track_encode(&enc, pt)) {
+        write_page();
+        track_encoder_start(&enc, page, TRACK_PAGE_SIZE, ++page_seq);
+        before = enc.len;
+        track_encode(&enc, pt);
+    }
+    record_bytes += enc.len - before;
+    if (num_points == cap_points) {
+        cap_points = cap_points ? cap_points * 2 : 1024;
+        points = realloc(points, cap_points * sizeof(points[0]));
+    }
+    points[num_points++] = *pt;
+}
+
+static void on_line(char *line, size_t len, void *ctx) {
+    track_point_t pt;
+    if (!(parse_nmea(line) & GPS_UPDATED_FIX) || !track_point_from_gps(&my_gps, &pt)) return;
+
+    if (has_pending && pt.time_ms != pending.time_ms) encode_point(&pending);
+    pending = pt;
+    has_pending = 1;
+}
+
+static int encode_nmea(const char *nmea_path, const char *out_path) {
+    size_t size;
+    char *data = load_file(nmea_path, &size);
+    if (data == NULL) {
+        fprintf(stderr, "cannot open %s\n", nmea_path);
+        return 1;
+    }
+    enc_out = fopen(out_path, "wb");
+    if (enc_out == NULL) {
+        fprintf(stderr, "cannot create %s\n", out_path);
+        return 1;
+    }
+
+    nmea_framer_t framer;
+    nmea_framer_init(&framer, on_line, NULL);
+    track_encoder_start(&enc, page, TRACK_PAGE_SIZE, page_seq);
+    nmea_framer_feed(&framer, data, size);
+    if (has_pending) encode_point(&pending);
+    write_page();
+    fclose(enc_out);
+
+    // 다시 읽어서 원래 값과 비교
+    size_t dump_size;
+    uint8_t *dump = (uint8_t *)load_file(out_path, &dump_size);
+    size_t n = 0, mismatch = 0;
+    for (size_t off = 0; off + TRACK_PAGE_SIZE <= dump_size; off += TRACK_PAGE_SIZE) {
+        track_decoder_t dec;
+        track_point_t pt;
+        if (!track_decoder_start(&dec, dump + off, TRACK_PAGE_SIZE, NULL)) continue;
+        while (track_decode_next(&dec, &pt)) {
+            if (n >= num_points || memcmp(&pt, &points[n], sizeof(pt)) != 0) mismatch++;
+            n++;
+        }
+    }
+
+    printf("fixes       : %zu\n", num_points);
+    printf("pages       : %u (%u bytes)\n", (unsigned)page_seq, (unsigned)(page_seq * TRACK_PAGE_SIZE));
+    printf("bytes/fix   : %.2f (records only)\n", num_points ? (double)record_bytes / num_points : 0.0);
+    printf("roundtrip   : %s\n", n == num_points && mismatch == 0 ? "identical" : "MISMATCH");
+
+    free(dump);
+    free(data);
+    free(points);
+    return n == num_points && mismatch == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 4 && strcmp(argv[1], "-e") == 0) return encode_nmea(argv[2], argv[3]);
+    if (argc == 3 && strcmp(argv[1], "-g") == 0) return decode_dump(argv[2], 1);
+    if (argc == 2) return decode_dump(argv[1], 0);
+
+    fprintf(stderr, "usage: %s [-g] <track.bin>        (CSV, -g = GPX)\n", argv[0]);
+    fprintf(stderr, "       %s -e <file.nmea> <track.bin>\n", argv[0]);
+    return 1;
+}